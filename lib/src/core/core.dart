@@ -1,5 +1,8 @@
 export 'systems/engine.dart';
 export 'systems/physics.dart';
+export 'systems/trace.dart';
+export 'systems/jobs.dart';
+export 'systems/world_group.dart';
 export 'systems/audio.dart';
 export 'systems/input.dart';
 export 'systems/particle.dart';
@@ -1,5 +1,6 @@
 import 'dart:ffi';
 import 'dart:io';
+import 'package:ffi/ffi.dart';
 
 // FFI Struct Bit-mappings
 // (Must match the C++ structs exactly)
@@ -186,6 +187,23 @@ final class NativeBody extends Struct {
   external int islandId;
 }
 
+// SoA particle storage (Must match C++ particles.h)
+final class ParticleStreams extends Struct {
+  external Pointer<Float> x;
+  external Pointer<Float> y;
+  external Pointer<Float> z;
+  external Pointer<Float> vx;
+  external Pointer<Float> vy;
+  external Pointer<Float> vz;
+  external Pointer<Float> life;
+  external Pointer<Float> lifeRate;
+  external Pointer<Float> size;
+  external Pointer<Uint32> color;
+  @Int32()
+  external int capacity;
+  external Pointer<Void> block;
+}
+
 final class ParticleEmitter extends Struct {
   external Pointer<NativeParticle> particles;
 
@@ -203,6 +221,211 @@ final class ParticleEmitter extends Struct {
   external double gravityZ;
   @Int32()
   external int shapeType;
+
+  external Pointer<ParticleStreams> streams;
+
+  // Screen-space cull rect (disabled while viewMaxX <= viewMinX)
+  @Float()
+  external double viewMinX;
+  @Float()
+  external double viewMinY;
+  @Float()
+  external double viewMaxX;
+  @Float()
+  external double viewMaxY;
+  @Float()
+  external double minScreenSize;
+
+  @Int32()
+  external int sortMode; // 0 = storage order, 1 = back to front
+
+  external Pointer<ParticleCurves> curves; // Optional, owned by the caller
+
+  external Pointer<ForceField> forceFields; // Optional, owned by the caller
+  @Int32()
+  external int forceFieldCount;
+
+  external Pointer<ParticleCollision> collision; // Optional, owned by the caller
+
+  external Pointer<ParticleTrails> trails; // Owned by the emitter, see setParticleTrails
+
+  external Pointer<ParticleAtlas> atlas; // Optional, owned by the caller
+}
+
+// Sprite-atlas grid and flipbook of textured particles (Must match C++ particles.h)
+final class ParticleAtlas extends Struct {
+  @Int32()
+  external int columns;
+  @Int32()
+  external int rows;
+  @Int32()
+  external int firstFrame;
+  @Int32()
+  external int frameCount;
+  @Float()
+  external double cycles; // Flipbook plays per lifetime
+  @Float()
+  external double width; // Image size in texture coordinates (pixels for an ImageShader)
+  @Float()
+  external double height;
+}
+
+// Ribbon trail history (Must match C++ particles.h)
+const int particleTrailMaxPoints = 32;
+
+final class ParticleTrails extends Struct {
+  @Int32()
+  external int length;
+  @Float()
+  external double interval; // Seconds between recorded points (0 = every update)
+  @Float()
+  external double tailWidth; // Relative to the particle's projected size
+  @Float()
+  external double tailAlpha; // Relative to the particle's alpha
+
+  external Pointer<Float> points;
+  external Pointer<Uint8> counts;
+  @Int32()
+  external int head;
+  @Float()
+  external double timer;
+}
+
+// Particle collision against a physics world (Must match C++ particles.h)
+final class ParticleCollision extends Struct {
+  external Pointer<PhysicsWorld> world;
+  @Uint32()
+  external int categoryBits;
+  @Uint32()
+  external int maskBits;
+  @Int32()
+  external int response; // 0 = bounce, 1 = stick, 2 = kill
+  @Float()
+  external double bounce;
+  @Float()
+  external double friction;
+  @Float()
+  external double radius;
+}
+
+// Force applied in update_particles (Must match C++ particles.h)
+final class ForceField extends Struct {
+  @Int32()
+  external int type; // 0 = point, 1 = vortex, 2 = turbulence, 3 = drag, 4 = plane
+  @Float()
+  external double x, y, z;
+  @Float()
+  external double axisX, axisY, axisZ;
+  @Float()
+  external double strength;
+  @Float()
+  external double radius;
+  @Float()
+  external double frequency;
+  @Float()
+  external double bounce;
+}
+
+// Over-lifetime lookup tables (Must match C++ particles.h)
+const int particleCurveSamples = 64;
+
+final class ParticleCurves extends Struct {
+  @Int32()
+  external int flags; // 1 = size, 2 = color, 4 = drag
+
+  @Array(particleCurveSamples)
+  external Array<Float> size;
+  @Array(particleCurveSamples)
+  external Array<Uint32> color;
+  @Array(particleCurveSamples)
+  external Array<Float> drag;
+}
+
+// Pipeline frame (Must match C++ particles_async.h)
+final class ParticlePipeline extends Opaque {}
+
+final class ParticleFrame extends Struct {
+  external Pointer<Float> vertices; // x,y pairs per vertex slot (RSTransforms for sprite groups)
+  external Pointer<Uint32> colors; // One per vertex slot
+  external Pointer<Float> uvs; // u,v pairs per vertex slot, null until a textured group is filled
+  external Pointer<Int32> ranges; // {firstVertex, visibleCount} per emitter, relative to its group
+  external Pointer<Int32> groupStarts; // First vertex slot per draw group
+  @Int32()
+  external int groupCount;
+  @Int32()
+  external int emitterCount;
+  @Int32()
+  external int vertexCount;
+  @Array(16)
+  external Array<Float> matrix;
+  @Uint32()
+  external int frameIndex;
+}
+
+// Fill output layouts and sprite size (Must match C++ particles.h)
+const int particleLayoutTriangles = 0;
+const int particleLayoutCorners = 1;
+const int particleLayoutSprites = 2; // One RSTransform + color per particle
+const int particleSpriteSize = 128;
+const int particleLayoutTrails = 3; // Ribbon strip per particle, see particleTrailVertices
+const int particleLayoutTextured = 4; // Quad corners + UVs, see fillTexturedBufferMulti
+
+// Burst spawn distribution (Must match C++ particles.h)
+final class EmitterShapeDef extends Struct {
+  @Int32()
+  external int shape; // 0 = point, 1 = cone, 2 = sphere, 3 = box, 4 = ring
+  @Float()
+  external double x;
+  @Float()
+  external double y;
+  @Float()
+  external double z;
+  @Float()
+  external double radius;
+  @Float()
+  external double halfX;
+  @Float()
+  external double halfY;
+  @Float()
+  external double halfZ;
+  @Float()
+  external double dirX;
+  @Float()
+  external double dirY;
+  @Float()
+  external double dirZ;
+  @Float()
+  external double spreadAngle;
+  @Float()
+  external double speedMin;
+  @Float()
+  external double speedMax;
+  @Float()
+  external double velMinX;
+  @Float()
+  external double velMinY;
+  @Float()
+  external double velMinZ;
+  @Float()
+  external double velMaxX;
+  @Float()
+  external double velMaxY;
+  @Float()
+  external double velMaxZ;
+  @Float()
+  external double lifeMin;
+  @Float()
+  external double lifeMax;
+  @Float()
+  external double sizeMin;
+  @Float()
+  external double sizeMax;
+  @Uint32()
+  external int color;
+  @Uint32()
+  external int seed;
+  @Uint32()
+  external int counter;
 }
 
 // RayCast Struct (Must match C++ physics.h)
@@ -223,6 +446,155 @@ final class RayCastHit extends Struct {
   external int hit;
 }
 
+// Shape Cast Struct (Must match C++ queries.h)
+final class ShapeCastHit extends Struct {
+  @Int32()
+  external int bodyId;
+  @Float()
+  external double x;
+  @Float()
+  external double y;
+  @Float()
+  external double normalX;
+  @Float()
+  external double normalY;
+  @Float()
+  external double fraction;
+  @Int32()
+  external int hit;
+}
+
+// Contact Event Structs (Must match C++ events.h)
+final class ContactEvent extends Struct {
+  @Int32()
+  external int type;
+  @Int32()
+  external int bodyA;
+  @Int32()
+  external int bodyB;
+  @Float()
+  external double pointX;
+  @Float()
+  external double pointY;
+  @Float()
+  external double normalX;
+  @Float()
+  external double normalY;
+  @Float()
+  external double approachSpeed;
+}
+
+final class ContactEventBuffer extends Struct {
+  external Pointer<ContactEvent> events;
+  @Int32()
+  external int capacity;
+  @Uint32()
+  external int writeIndex;
+  @Uint32()
+  external int readIndex;
+  @Uint32()
+  external int droppedCount;
+}
+
+// Async Step Output Structs (Must match C++ physics_async.h)
+final class BodyTransform extends Struct {
+  @Float()
+  external double x;
+  @Float()
+  external double y;
+  @Float()
+  external double rotation;
+  @Int32()
+  external int collisionCount;
+}
+
+final class BodyTransformBuffer extends Struct {
+  external Pointer<BodyTransform> transforms;
+  @Int32()
+  external int count;
+  @Int32()
+  external int capacity;
+  @Uint32()
+  external int batchIndex;
+}
+
+// World Group Struct (Must match C++ world_group.h)
+final class WorldGroup extends Struct {
+  external Pointer<Pointer<PhysicsWorld>> worlds;
+  @Int32()
+  external int count;
+  @Int32()
+  external int capacity;
+}
+
+// Step Profile Struct (Must match C++ physics.h)
+final class PhysicsProfile extends Struct {
+  @Float()
+  external double softBodies;
+  @Float()
+  external double broadphase;
+  @Float()
+  external double pairs;
+  @Float()
+  external double narrowphase;
+  @Float()
+  external double warmStart;
+  @Float()
+  external double velocitySolve;
+  @Float()
+  external double integrate;
+  @Float()
+  external double positionSolve;
+  @Float()
+  external double total;
+  @Int32()
+  external int pairCount;
+  @Int32()
+  external int constraintCount;
+  @Int32()
+  external int awakeBodyCount;
+  @Int32()
+  external int treeHeight;
+}
+
+// Character Controller Struct (Must match C++ character.h)
+final class CharacterController extends Struct {
+  @Int32()
+  external int bodyId;
+  @Int32()
+  external int shapeType;
+  @Float()
+  external double width;
+  @Float()
+  external double height;
+  @Float()
+  external double skinWidth;
+  @Float()
+  external double minGroundNormalY;
+  @Int32()
+  external int maxIterations;
+  @Uint32()
+  external int categoryBits;
+  @Uint32()
+  external int maskBits;
+
+  @Float()
+  external double x;
+  @Float()
+  external double y;
+
+  @Int32()
+  external int onGround;
+  @Float()
+  external double groundNormalX;
+  @Float()
+  external double groundNormalY;
+  @Int32()
+  external int groundBodyId;
+  @Int32()
+  external int hitCount;
+}
+
 // Typedefs for the C functions
 typedef UpdateParticlesC = Void Function(Pointer<ParticleEmitter> emitter, Float dt);
 typedef UpdateParticlesDart = void Function(Pointer<ParticleEmitter> emitter, double dt);
@@ -271,6 +643,77 @@ typedef FillVertexBufferDart =
       int maxRenderCount,
     );
 
+typedef FillVertexBufferMultiC =
+    Int32 Function(
+      Pointer<Pointer<ParticleEmitter>> emitters,
+      Int32 emitterCount,
+      Pointer<Float> matrix,
+      Pointer<Float> vertices,
+      Pointer<Uint32> colors,
+      Int32 maxRenderCount,
+      Int32 layout,
+      Pointer<Int32> ranges,
+    );
+typedef FillVertexBufferMultiDart =
+    int Function(
+      Pointer<Pointer<ParticleEmitter>> emitters,
+      int emitterCount,
+      Pointer<Float> matrix,
+      Pointer<Float> vertices,
+      Pointer<Uint32> colors,
+      int maxRenderCount,
+      int layout,
+      Pointer<Int32> ranges,
+    );
+
+typedef FillTexturedBufferMultiC =
+    Int32 Function(
+      Pointer<Pointer<ParticleEmitter>> emitters,
+      Int32 emitterCount,
+      Pointer<Float> matrix,
+      Pointer<Float> vertices,
+      Pointer<Uint32> colors,
+      Pointer<Float> uvs,
+      Int32 maxRenderCount,
+      Pointer<Int32> ranges,
+    );
+typedef FillTexturedBufferMultiDart =
+    int Function(
+      Pointer<Pointer<ParticleEmitter>> emitters,
+      int emitterCount,
+      Pointer<Float> matrix,
+      Pointer<Float> vertices,
+      Pointer<Uint32> colors,
+      Pointer<Float> uvs,
+      int maxRenderCount,
+      Pointer<Int32> ranges,
+    );
+
+typedef SubmitParticleFrameC =
+    Void Function(
+      Pointer<ParticlePipeline> pipeline,
+      Pointer<Pointer<ParticleEmitter>> updateEmitters,
+      Int32 updateCount,
+      Pointer<Pointer<ParticleEmitter>> drawEmitters,
+      Int32 drawCount,
+      Pointer<Int32> drawGroups,
+      Int32 groupCount,
+      Float dt,
+      Pointer<Float> matrix,
+    );
+typedef SubmitParticleFrameDart =
+    void Function(
+      Pointer<ParticlePipeline> pipeline,
+      Pointer<Pointer<ParticleEmitter>> updateEmitters,
+      int updateCount,
+      Pointer<Pointer<ParticleEmitter>> drawEmitters,
+      int drawCount,
+      Pointer<Int32> drawGroups,
+      int groupCount,
+      double dt,
+      Pointer<Float> matrix,
+    );
+
 class FlashNativeParticles {
   static DynamicLibrary? _lib;
 
@@ -279,6 +722,28 @@ class FlashNativeParticles {
   static void Function(Pointer<ParticleEmitter>, double, double, double, double, double, double, double, double, int)?
   spawnParticle;
   static int Function(Pointer<ParticleEmitter>, Pointer<Float>, Pointer<Float>, Pointer<Uint32>, int)? fillVertexBuffer;
+  static int Function(Pointer<ParticleEmitter>, Pointer<Float>, Pointer<Float>, Pointer<Uint32>, int)?
+  fillVertexBufferIndexed;
+  static FillVertexBufferMultiDart? fillVertexBufferMulti;
+  static FillVertexBufferDart? fillSpriteBuffer;
+  static int Function(Pointer<ParticleEmitter>, int, double)? setParticleTrails;
+  static FillVertexBufferDart? fillTrailBuffer;
+  static int Function(int)? particleTrailVertices;
+  static int Function(int, int, Pointer<Uint16>)? buildTrailIndices;
+  static FillTexturedBufferMultiDart? fillTexturedBufferMulti;
+
+  // Async Particle Pipeline
+  static Pointer<ParticlePipeline> Function(int)? createParticlePipeline;
+  static void Function(Pointer<ParticlePipeline>)? destroyParticlePipeline;
+  static SubmitParticleFrameDart? submitParticleFrame;
+  static void Function(Pointer<ParticlePipeline>)? waitParticlePipeline;
+  static int Function(Pointer<ParticlePipeline>)? isParticlePipelineBusy;
+  static Pointer<ParticleFrame> Function(Pointer<ParticlePipeline>)? getParticleFrame;
+  static int Function(int)? particleShapeSides;
+  static int Function(int, int, Pointer<Uint16>)? buildParticleIndices;
+  static int Function(Pointer<ParticleEmitter>, int, Pointer<EmitterShapeDef>)? spawnBurst;
+  static Pointer<ParticleEmitter> Function(int, int)? createParticleEmitter;
+  static void Function(Pointer<ParticleEmitter>)? destroyParticleEmitter;
 
   // Physics Functions
   static Pointer<PhysicsWorld> Function(int)? createPhysicsWorld;
@@ -305,6 +770,79 @@ class FlashNativeParticles {
   // RayCast
   static RayCastHit Function(Pointer<PhysicsWorld>, double, double, double, double)? rayCast;
 
+  // Spatial Queries (broadphase tree)
+  static int Function(Pointer<PhysicsWorld>, double, double, double, double, int, int, Pointer<Int32>, int)? queryAabb;
+  static int Function(Pointer<PhysicsWorld>, double, double, int, int, Pointer<Int32>, int)? queryPoint;
+  static int Function(Pointer<PhysicsWorld>, int, double, double, double, double, double, int, int, Pointer<Int32>, int)?
+  overlapShape;
+  static int Function(Pointer<PhysicsWorld>, Pointer<Float>, int, int, int, Pointer<Int32>, int, Pointer<Int32>)?
+  queryAabbBatch;
+  static int Function(Pointer<PhysicsWorld>, Pointer<Float>, int, int, int, Pointer<Int32>, int, Pointer<Int32>)?
+  queryPointBatch;
+  static int Function(Pointer<PhysicsWorld>, int, Pointer<Float>, int, int, int, Pointer<Int32>, int, Pointer<Int32>)?
+  overlapShapeBatch;
+
+  // Shape Cast & Character Controller
+  static ShapeCastHit Function(
+    Pointer<PhysicsWorld>,
+    int,
+    double,
+    double,
+    double,
+    double,
+    double,
+    double,
+    double,
+    int,
+    int,
+    int,
+  )?
+  shapeCast;
+  static void Function(Pointer<CharacterController>, int, double, double, double, double)? initCharacterController;
+  static void Function(Pointer<PhysicsWorld>, Pointer<CharacterController>, double, double)? characterMove;
+
+  // Contact Events
+  static Pointer<ContactEventBuffer> Function(Pointer<PhysicsWorld>)? getContactEvents;
+  static void Function(Pointer<PhysicsWorld>, double)? setHitEventThreshold;
+
+  // Tracing
+  static void Function()? traceBegin;
+  static void Function()? traceEnd;
+  static void Function(Pointer<Utf8>)? traceSetThreadName;
+  static int Function(Pointer<Utf8>)? traceDumpJson;
+
+  // Async Stepping
+  static void Function(Pointer<PhysicsWorld>, double, int)? stepPhysicsAsync;
+  static void Function(Pointer<PhysicsWorld>)? waitPhysics;
+  static int Function(Pointer<PhysicsWorld>)? isPhysicsBusy;
+  static Pointer<BodyTransformBuffer> Function(Pointer<PhysicsWorld>)? getBodyTransforms;
+
+  // World Groups
+  static Pointer<WorldGroup> Function(int)? createWorldGroup;
+  static void Function(Pointer<WorldGroup>)? destroyWorldGroup;
+  static int Function(Pointer<WorldGroup>, Pointer<PhysicsWorld>)? worldGroupAdd;
+  static void Function(Pointer<WorldGroup>, Pointer<PhysicsWorld>)? worldGroupRemove;
+  static void Function(Pointer<WorldGroup>, double, int)? stepWorldGroup;
+
+  // Job System
+  static void Function(int)? setJobThreadCount;
+  static int Function()? getJobThreadCount;
+
+  // Profiling
+  static void Function(Pointer<PhysicsWorld>, int)? enablePhysicsProfile;
+  static Pointer<PhysicsProfile> Function(Pointer<PhysicsWorld>)? getPhysicsProfile;
+
+  // Determinism
+  static int Function()? isPhysicsDeterministic;
+  static int Function(Pointer<PhysicsWorld>)? hashWorldState;
+
+  // World Snapshots
+  static int Function(Pointer<PhysicsWorld>)? getSnapshotSize;
+  static int Function(Pointer<PhysicsWorld>, Pointer<Uint8>, int)? snapshotWorld;
+  static int Function(Pointer<PhysicsWorld>, Pointer<Uint8>, int)? restoreWorld;
+  static int Function(Pointer<Uint8>, int, Pointer<Uint8>, int, Pointer<Uint8>, int)? snapshotDelta;
+  static int Function(Pointer<Uint8>, int, Pointer<Uint8>, int, Pointer<Uint8>, int)? applySnapshotDelta;
+
   static const String _libName = 'libflash_core.dylib';
 
   static void init() {
@@ -335,6 +873,111 @@ class FlashNativeParticles {
     spawnParticle = _lib!.lookupFunction<SpawnParticleC, SpawnParticleDart>('spawn_particle');
     fillVertexBuffer = _lib!.lookupFunction<FillVertexBufferC, FillVertexBufferDart>('fill_vertex_buffer');
 
+    try {
+      createParticleEmitter = _lib!
+          .lookupFunction<Pointer<ParticleEmitter> Function(Int32, Int32), Pointer<ParticleEmitter> Function(int, int)>(
+            'create_particle_emitter',
+          );
+      destroyParticleEmitter = _lib!
+          .lookupFunction<Void Function(Pointer<ParticleEmitter>), void Function(Pointer<ParticleEmitter>)>(
+            'destroy_particle_emitter',
+          );
+    } catch (e) {
+      print('WARNING: particle stream symbols not found. FFI Binding failed: $e');
+    }
+
+    try {
+      fillVertexBufferIndexed = _lib!.lookupFunction<FillVertexBufferC, FillVertexBufferDart>(
+        'fill_vertex_buffer_indexed',
+      );
+      particleShapeSides = _lib!.lookupFunction<Int32 Function(Int32), int Function(int)>('particle_shape_sides');
+      buildParticleIndices = _lib!
+          .lookupFunction<Int32 Function(Int32, Int32, Pointer<Uint16>), int Function(int, int, Pointer<Uint16>)>(
+            'build_particle_indices',
+          );
+    } catch (e) {
+      print('WARNING: indexed particle symbols not found. FFI Binding failed: $e');
+    }
+
+    try {
+      fillVertexBufferMulti = _lib!.lookupFunction<FillVertexBufferMultiC, FillVertexBufferMultiDart>(
+        'fill_vertex_buffer_multi',
+      );
+    } catch (e) {
+      print('WARNING: fill_vertex_buffer_multi symbol not found. FFI Binding failed: $e');
+    }
+
+    try {
+      fillSpriteBuffer = _lib!.lookupFunction<FillVertexBufferC, FillVertexBufferDart>('fill_sprite_buffer');
+    } catch (e) {
+      print('WARNING: fill_sprite_buffer symbol not found. FFI Binding failed: $e');
+    }
+
+    try {
+      setParticleTrails = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<ParticleEmitter>, Int32, Float),
+            int Function(Pointer<ParticleEmitter>, int, double)
+          >('set_particle_trails');
+      fillTrailBuffer = _lib!.lookupFunction<FillVertexBufferC, FillVertexBufferDart>('fill_trail_buffer');
+      particleTrailVertices = _lib!.lookupFunction<Int32 Function(Int32), int Function(int)>(
+        'particle_trail_vertices',
+      );
+      buildTrailIndices = _lib!
+          .lookupFunction<Int32 Function(Int32, Int32, Pointer<Uint16>), int Function(int, int, Pointer<Uint16>)>(
+            'build_trail_indices',
+          );
+    } catch (e) {
+      print('WARNING: particle trail symbols not found. FFI Binding failed: $e');
+    }
+
+    try {
+      fillTexturedBufferMulti = _lib!.lookupFunction<FillTexturedBufferMultiC, FillTexturedBufferMultiDart>(
+        'fill_textured_buffer_multi',
+      );
+    } catch (e) {
+      print('WARNING: fill_textured_buffer_multi symbol not found. FFI Binding failed: $e');
+    }
+
+    try {
+      createParticlePipeline = _lib!
+          .lookupFunction<Pointer<ParticlePipeline> Function(Int32), Pointer<ParticlePipeline> Function(int)>(
+            'create_particle_pipeline',
+          );
+      destroyParticlePipeline = _lib!
+          .lookupFunction<Void Function(Pointer<ParticlePipeline>), void Function(Pointer<ParticlePipeline>)>(
+            'destroy_particle_pipeline',
+          );
+      submitParticleFrame = _lib!.lookupFunction<SubmitParticleFrameC, SubmitParticleFrameDart>(
+        'submit_particle_frame',
+      );
+      waitParticlePipeline = _lib!
+          .lookupFunction<Void Function(Pointer<ParticlePipeline>), void Function(Pointer<ParticlePipeline>)>(
+            'wait_particle_pipeline',
+          );
+      isParticlePipelineBusy = _lib!
+          .lookupFunction<Int32 Function(Pointer<ParticlePipeline>), int Function(Pointer<ParticlePipeline>)>(
+            'is_particle_pipeline_busy',
+          );
+      getParticleFrame = _lib!
+          .lookupFunction<
+            Pointer<ParticleFrame> Function(Pointer<ParticlePipeline>),
+            Pointer<ParticleFrame> Function(Pointer<ParticlePipeline>)
+          >('get_particle_frame');
+    } catch (e) {
+      print('WARNING: particle pipeline symbols not found. FFI Binding failed: $e');
+    }
+
+    try {
+      spawnBurst = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<ParticleEmitter>, Int32, Pointer<EmitterShapeDef>),
+            int Function(Pointer<ParticleEmitter>, int, Pointer<EmitterShapeDef>)
+          >('spawn_burst');
+    } catch (e) {
+      print('WARNING: spawn_burst symbol not found. FFI Binding failed: $e');
+    }
+
     // Physics Lookups
     createPhysicsWorld = _lib!
         .lookupFunction<Pointer<PhysicsWorld> Function(Int32), Pointer<PhysicsWorld> Function(int)>(
@@ -409,6 +1052,250 @@ class FlashNativeParticles {
           RayCastHit Function(Pointer<PhysicsWorld>, double, double, double, double)
         >('ray_cast');
 
+    // Spatial Query Bindings
+    try {
+      queryAabb = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<PhysicsWorld>, Float, Float, Float, Float, Uint32, Uint32, Pointer<Int32>, Int32),
+            int Function(Pointer<PhysicsWorld>, double, double, double, double, int, int, Pointer<Int32>, int)
+          >('query_aabb');
+      queryPoint = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<PhysicsWorld>, Float, Float, Uint32, Uint32, Pointer<Int32>, Int32),
+            int Function(Pointer<PhysicsWorld>, double, double, int, int, Pointer<Int32>, int)
+          >('query_point');
+      overlapShape = _lib!
+          .lookupFunction<
+            Int32 Function(
+              Pointer<PhysicsWorld>,
+              Int32,
+              Float,
+              Float,
+              Float,
+              Float,
+              Float,
+              Uint32,
+              Uint32,
+              Pointer<Int32>,
+              Int32,
+            ),
+            int Function(Pointer<PhysicsWorld>, int, double, double, double, double, double, int, int, Pointer<Int32>, int)
+          >('overlap_shape');
+      queryAabbBatch = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<PhysicsWorld>, Pointer<Float>, Int32, Uint32, Uint32, Pointer<Int32>, Int32, Pointer<Int32>),
+            int Function(Pointer<PhysicsWorld>, Pointer<Float>, int, int, int, Pointer<Int32>, int, Pointer<Int32>)
+          >('query_aabb_batch');
+      queryPointBatch = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<PhysicsWorld>, Pointer<Float>, Int32, Uint32, Uint32, Pointer<Int32>, Int32, Pointer<Int32>),
+            int Function(Pointer<PhysicsWorld>, Pointer<Float>, int, int, int, Pointer<Int32>, int, Pointer<Int32>)
+          >('query_point_batch');
+      overlapShapeBatch = _lib!
+          .lookupFunction<
+            Int32 Function(
+              Pointer<PhysicsWorld>,
+              Int32,
+              Pointer<Float>,
+              Int32,
+              Uint32,
+              Uint32,
+              Pointer<Int32>,
+              Int32,
+              Pointer<Int32>,
+            ),
+            int Function(Pointer<PhysicsWorld>, int, Pointer<Float>, int, int, int, Pointer<Int32>, int, Pointer<Int32>)
+          >('overlap_shape_batch');
+    } catch (e) {
+      print('WARNING: spatial query symbols not found. FFI Binding failed: $e');
+    }
+
+    // Shape Cast & Character Controller Bindings
+    try {
+      shapeCast = _lib!
+          .lookupFunction<
+            ShapeCastHit Function(
+              Pointer<PhysicsWorld>,
+              Int32,
+              Float,
+              Float,
+              Float,
+              Float,
+              Float,
+              Float,
+              Float,
+              Uint32,
+              Uint32,
+              Int32,
+            ),
+            ShapeCastHit Function(
+              Pointer<PhysicsWorld>,
+              int,
+              double,
+              double,
+              double,
+              double,
+              double,
+              double,
+              double,
+              int,
+              int,
+              int,
+            )
+          >('shape_cast');
+      initCharacterController = _lib!
+          .lookupFunction<
+            Void Function(Pointer<CharacterController>, Int32, Float, Float, Float, Float),
+            void Function(Pointer<CharacterController>, int, double, double, double, double)
+          >('init_character_controller');
+      characterMove = _lib!
+          .lookupFunction<
+            Void Function(Pointer<PhysicsWorld>, Pointer<CharacterController>, Float, Float),
+            void Function(Pointer<PhysicsWorld>, Pointer<CharacterController>, double, double)
+          >('character_move');
+    } catch (e) {
+      print('WARNING: shape cast symbols not found. FFI Binding failed: $e');
+    }
+
+    // Contact Event Bindings
+    try {
+      getContactEvents = _lib!
+          .lookupFunction<
+            Pointer<ContactEventBuffer> Function(Pointer<PhysicsWorld>),
+            Pointer<ContactEventBuffer> Function(Pointer<PhysicsWorld>)
+          >('get_contact_events');
+      setHitEventThreshold = _lib!
+          .lookupFunction<Void Function(Pointer<PhysicsWorld>, Float), void Function(Pointer<PhysicsWorld>, double)>(
+            'set_hit_event_threshold',
+          );
+    } catch (e) {
+      print('WARNING: contact event symbols not found. FFI Binding failed: $e');
+    }
+
+    // Tracing Bindings
+    try {
+      traceBegin = _lib!.lookupFunction<Void Function(), void Function()>('trace_begin');
+      traceEnd = _lib!.lookupFunction<Void Function(), void Function()>('trace_end');
+      traceSetThreadName = _lib!.lookupFunction<Void Function(Pointer<Utf8>), void Function(Pointer<Utf8>)>(
+        'trace_set_thread_name',
+      );
+      traceDumpJson = _lib!.lookupFunction<Int32 Function(Pointer<Utf8>), int Function(Pointer<Utf8>)>(
+        'trace_dump_json',
+      );
+    } catch (e) {
+      print('WARNING: trace symbols not found. FFI Binding failed: $e');
+    }
+
+    // Async Stepping Bindings
+    try {
+      stepPhysicsAsync = _lib!
+          .lookupFunction<
+            Void Function(Pointer<PhysicsWorld>, Float, Int32),
+            void Function(Pointer<PhysicsWorld>, double, int)
+          >('step_physics_async');
+      waitPhysics = _lib!.lookupFunction<Void Function(Pointer<PhysicsWorld>), void Function(Pointer<PhysicsWorld>)>(
+        'wait_physics',
+      );
+      isPhysicsBusy = _lib!.lookupFunction<Int32 Function(Pointer<PhysicsWorld>), int Function(Pointer<PhysicsWorld>)>(
+        'is_physics_busy',
+      );
+      getBodyTransforms = _lib!
+          .lookupFunction<
+            Pointer<BodyTransformBuffer> Function(Pointer<PhysicsWorld>),
+            Pointer<BodyTransformBuffer> Function(Pointer<PhysicsWorld>)
+          >('get_body_transforms');
+    } catch (e) {
+      print('WARNING: async physics symbols not found. FFI Binding failed: $e');
+    }
+
+    // World Group Bindings
+    try {
+      createWorldGroup = _lib!.lookupFunction<Pointer<WorldGroup> Function(Int32), Pointer<WorldGroup> Function(int)>(
+        'create_world_group',
+      );
+      destroyWorldGroup = _lib!.lookupFunction<Void Function(Pointer<WorldGroup>), void Function(Pointer<WorldGroup>)>(
+        'destroy_world_group',
+      );
+      worldGroupAdd = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<WorldGroup>, Pointer<PhysicsWorld>),
+            int Function(Pointer<WorldGroup>, Pointer<PhysicsWorld>)
+          >('world_group_add');
+      worldGroupRemove = _lib!
+          .lookupFunction<
+            Void Function(Pointer<WorldGroup>, Pointer<PhysicsWorld>),
+            void Function(Pointer<WorldGroup>, Pointer<PhysicsWorld>)
+          >('world_group_remove');
+      stepWorldGroup = _lib!
+          .lookupFunction<Void Function(Pointer<WorldGroup>, Float, Int32), void Function(Pointer<WorldGroup>, double, int)>(
+            'step_world_group',
+          );
+    } catch (e) {
+      print('WARNING: world group symbols not found. FFI Binding failed: $e');
+    }
+
+    // Job System Bindings
+    try {
+      setJobThreadCount = _lib!.lookupFunction<Void Function(Int32), void Function(int)>('set_job_thread_count');
+      getJobThreadCount = _lib!.lookupFunction<Int32 Function(), int Function()>('get_job_thread_count');
+    } catch (e) {
+      print('WARNING: job system symbols not found. FFI Binding failed: $e');
+    }
+
+    // Profiling Bindings
+    try {
+      enablePhysicsProfile = _lib!
+          .lookupFunction<Void Function(Pointer<PhysicsWorld>, Int32), void Function(Pointer<PhysicsWorld>, int)>(
+            'enable_physics_profile',
+          );
+      getPhysicsProfile = _lib!
+          .lookupFunction<
+            Pointer<PhysicsProfile> Function(Pointer<PhysicsWorld>),
+            Pointer<PhysicsProfile> Function(Pointer<PhysicsWorld>)
+          >('get_physics_profile');
+    } catch (e) {
+      print('WARNING: profiling symbols not found. FFI Binding failed: $e');
+    }
+
+    // Determinism Bindings
+    try {
+      isPhysicsDeterministic = _lib!.lookupFunction<Int32 Function(), int Function()>('is_physics_deterministic');
+      hashWorldState = _lib!.lookupFunction<Uint64 Function(Pointer<PhysicsWorld>), int Function(Pointer<PhysicsWorld>)>(
+        'hash_world_state',
+      );
+    } catch (e) {
+      print('WARNING: determinism symbols not found. FFI Binding failed: $e');
+    }
+
+    // World Snapshot Bindings
+    try {
+      getSnapshotSize = _lib!.lookupFunction<Int32 Function(Pointer<PhysicsWorld>), int Function(Pointer<PhysicsWorld>)>(
+        'get_snapshot_size',
+      );
+      snapshotWorld = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<PhysicsWorld>, Pointer<Uint8>, Int32),
+            int Function(Pointer<PhysicsWorld>, Pointer<Uint8>, int)
+          >('snapshot_world');
+      restoreWorld = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<PhysicsWorld>, Pointer<Uint8>, Int32),
+            int Function(Pointer<PhysicsWorld>, Pointer<Uint8>, int)
+          >('restore_world');
+      snapshotDelta = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<Uint8>, Int32, Pointer<Uint8>, Int32, Pointer<Uint8>, Int32),
+            int Function(Pointer<Uint8>, int, Pointer<Uint8>, int, Pointer<Uint8>, int)
+          >('snapshot_delta');
+      applySnapshotDelta = _lib!
+          .lookupFunction<
+            Int32 Function(Pointer<Uint8>, Int32, Pointer<Uint8>, Int32, Pointer<Uint8>, Int32),
+            int Function(Pointer<Uint8>, int, Pointer<Uint8>, int, Pointer<Uint8>, int)
+          >('apply_snapshot_delta');
+    } catch (e) {
+      print('WARNING: snapshot symbols not found. FFI Binding failed: $e');
+    }
+
     // Scene & Node Lookups
     createNativeScene = _lib!.lookupFunction<Pointer<NativeScene> Function(Int32), Pointer<NativeScene> Function(int)>(
       'create_native_scene',
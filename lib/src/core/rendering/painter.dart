@@ -1,4 +1,6 @@
 import 'dart:ffi' hide Size;
+import 'dart:math' as math;
+import 'dart:typed_data';
 import 'dart:ui' as ui hide Size;
 import 'package:ffi/ffi.dart';
 import 'package:flutter/widgets.dart';
@@ -55,21 +57,62 @@ class FPainter extends CustomPainter {
     }
 
     // Render particles (after regular nodes for proper layering)
-    for (final emitter in emitters) {
-      _renderParticles(canvas, cameraMatrix, emitter);
+    final pipeline = engine.particlePipeline;
+    if (pipeline != null) {
+      _renderParticleFrame(canvas, cameraMatrix, pipeline);
+    } else {
+      _renderParticles(canvas, cameraMatrix, size, emitters);
     }
   }
 
-  // Native buffers for particles. Max supported count is 1 million.
-  // Max vertices per particle is 30 (for 12-sided "round" shape).
-  static final Pointer<Float> _verticesPtr = calloc<Float>(1000000 * 30 * 2);
-  static final Pointer<Uint32> _colorsPtr = calloc<Uint32>(1000000 * 30);
+  static const int _maxRenderParticles = 1000000;
+
+  // Indexed particle buffers: corners only, at most 12 per particle (round shape).
+  static final Pointer<Float> _cornersPtr = calloc<Float>(_maxRenderParticles * 12 * 2);
+  static final Pointer<Uint32> _cornerColorsPtr = calloc<Uint32>(_maxRenderParticles * 12);
   static final Pointer<Float> _matrixPtr = calloc<Float>(16);
 
-  void _renderParticles(Canvas canvas, Matrix4 cameraMatrix, FParticleEmitter emitter) {
-    if (emitter.isDisposed) return;
-    final count = emitter.activeCount;
-    if (count == 0) return;
+  // Triangle-fan index pattern per shape type, sized for one full 16-bit batch.
+  // Every batch starts at vertex 0 of its own slice, so one pattern serves all.
+  static final Map<int, Uint16List> _indexPatterns = {};
+
+  // Ribbon index pattern per trail length, same batching as the shapes
+  static final Map<int, Uint16List> _trailIndexPatterns = {};
+
+  // Expanded-fan buffers (30 vertices per particle), only allocated when the
+  // native library has no indexed fill
+  static Pointer<Float>? _fanVerticesPtr;
+  static Pointer<Uint32>? _fanColorsPtr;
+
+  // White sprite per shape for sprite emitters, tinted by the particle colors
+  static final Map<int, ui.Image> _spriteImages = {};
+
+  // The same source rect for every sprite, grown on demand
+  static Float32List _spriteRects = Float32List(0);
+
+  // UV stream of textured particles (same capacity as the corner buffers) and
+  // one ImageShader per atlas image, only allocated once a textured emitter draws
+  static Pointer<Float>? _uvsPtr;
+  static final Expando<ui.ImageShader> _atlasShaders = Expando();
+
+  // Emitter list for fill_vertex_buffer_multi, grown on demand
+  static Pointer<Pointer<ParticleEmitter>> _emitterListPtr = nullptr;
+  static int _emitterListCapacity = 0;
+
+  void _renderParticles(Canvas canvas, Matrix4 cameraMatrix, Size size, List<FParticleEmitter> emitters) {
+    final live = <FParticleEmitter>[];
+    for (final emitter in emitters) {
+      if (emitter.isDisposed || emitter.activeCount == 0) continue;
+
+      // Cull against the screen (cameraMatrix maps to pixels)
+      final native = emitter.nativeEmitterPointer.ref;
+      native.viewMinX = 0;
+      native.viewMinY = 0;
+      native.viewMaxX = size.width;
+      native.viewMaxY = size.height;
+      live.add(emitter);
+    }
+    if (live.isEmpty) return;
 
     // Copy matrix to native memory
     final matrixData = cameraMatrix.storage;
@@ -77,11 +120,325 @@ class FPainter extends CustomPainter {
       _matrixPtr[i] = matrixData[i];
     }
 
+    final spritesSupported = FlashNativeParticles.fillSpriteBuffer != null;
+    if (FlashNativeParticles.fillVertexBufferMulti == null || FlashNativeParticles.fillVertexBufferIndexed == null) {
+      for (final emitter in live) {
+        if (FlashNativeParticles.fillVertexBufferIndexed != null) {
+          _renderParticlesIndexed(canvas, emitter);
+        } else {
+          _renderParticleFans(canvas, emitter);
+        }
+      }
+      return;
+    }
+
+    // One merged fill and draw per (blend mode, layout, shape, trail length or
+    // atlas image); the index pattern, sprite or texture depend on the last two.
+    // Groups draw in order of their first emitter.
+    final texturedSupported = FlashNativeParticles.fillTexturedBufferMulti != null;
+    final groups = <(BlendMode, int, Object), List<FParticleEmitter>>{};
+    for (final emitter in live) {
+      final trailLength = emitter.trailLength;
+      final atlasImage = emitter.atlasImage;
+      final (BlendMode, int, Object) key;
+      if (trailLength > 0) {
+        key = (emitter.blendMode, particleLayoutTrails, trailLength);
+      } else if (atlasImage != null && texturedSupported) {
+        key = (emitter.blendMode, particleLayoutTextured, atlasImage);
+      } else if (emitter.drawAsSprites && spritesSupported) {
+        key = (emitter.blendMode, particleLayoutSprites, emitter.shapeType);
+      } else {
+        key = (emitter.blendMode, particleLayoutCorners, emitter.shapeType);
+      }
+      groups.putIfAbsent(key, () => []).add(emitter);
+    }
+    groups.forEach((key, group) {
+      final (blendMode, layout, shapeOrImage) = key;
+      if (shapeOrImage is ui.Image) {
+        _renderTexturedGroup(canvas, blendMode, shapeOrImage, group);
+      } else {
+        _renderParticleGroup(canvas, blendMode, layout, shapeOrImage as int, group);
+      }
+    });
+  }
+
+  void _setEmitterList(List<FParticleEmitter> group) {
+    if (group.length > _emitterListCapacity) {
+      if (_emitterListPtr != nullptr) calloc.free(_emitterListPtr);
+      _emitterListCapacity = math.max(group.length, _emitterListCapacity * 2);
+      _emitterListPtr = calloc<Pointer<ParticleEmitter>>(_emitterListCapacity);
+    }
+    for (int i = 0; i < group.length; i++) {
+      _emitterListPtr[i] = group[i].nativeEmitterPointer;
+    }
+  }
+
+  // Textured quads of emitters sharing one atlas image: one fill with UVs and
+  // one drawVertices (per 65536 corners) through an ImageShader
+  void _renderTexturedGroup(Canvas canvas, BlendMode blendMode, ui.Image image, List<FParticleEmitter> group) {
+    _setEmitterList(group);
+    final uvs = _uvsPtr ??= calloc<Float>(_maxRenderParticles * 12 * 2);
+    final vertexCount = FlashNativeParticles.fillTexturedBufferMulti!(
+      _emitterListPtr,
+      group.length,
+      _matrixPtr,
+      _cornersPtr,
+      _cornerColorsPtr,
+      uvs,
+      _maxRenderParticles * 3,
+      nullptr,
+    );
+    if (vertexCount == 0) return;
+    _drawTextured(canvas, _cornersPtr, _cornerColorsPtr, uvs, image, vertexCount ~/ 4, blendMode);
+  }
+
+  // Draws quadCount textured quads (fill_textured_buffer layout) from the
+  // start of the given buffers through the atlas image's shader
+  void _drawTextured(
+    Canvas canvas,
+    Pointer<Float> vertices,
+    Pointer<Uint32> colors,
+    Pointer<Float> uvs,
+    ui.Image image,
+    int quadCount,
+    BlendMode blendMode,
+  ) {
+    final pattern = _indexPatterns.putIfAbsent(0, () => _buildIndexPattern(0, 65536 ~/ 4, 4));
+    final shader = _atlasShaders[image] ??= ui.ImageShader(
+      image,
+      ui.TileMode.clamp,
+      ui.TileMode.clamp,
+      Matrix4.identity().storage,
+      filterQuality: FilterQuality.low,
+    );
+    final paint = Paint()
+      ..shader = shader
+      ..blendMode = blendMode;
+    _drawBatches(canvas, vertices, colors, 4, 6, pattern, quadCount, BlendMode.modulate, uvs: uvs, paint: paint);
+  }
+
+  void _renderParticleGroup(Canvas canvas, BlendMode blendMode, int layout, int shape, List<FParticleEmitter> group) {
+    _setEmitterList(group);
+
+    // Trails: `shape` is the trail length; ribbons share the corner buffers
+    final trailVertices = layout == particleLayoutTrails ? FlashNativeParticles.particleTrailVertices!(shape) : 0;
+    final vertexCount = FlashNativeParticles.fillVertexBufferMulti!(
+      _emitterListPtr,
+      group.length,
+      _matrixPtr,
+      _cornersPtr,
+      _cornerColorsPtr,
+      layout == particleLayoutTrails ? _maxRenderParticles * 12 ~/ trailVertices : _maxRenderParticles,
+      layout,
+      nullptr,
+    );
+    if (vertexCount == 0) return;
+    if (layout == particleLayoutSprites) {
+      _drawSprites(canvas, _cornersPtr, _cornerColorsPtr, shape, vertexCount, blendMode);
+      return;
+    }
+    if (layout == particleLayoutTrails) {
+      _drawTrails(canvas, _cornersPtr, _cornerColorsPtr, shape, vertexCount ~/ trailVertices, blendMode);
+      return;
+    }
+    final particleCount = vertexCount ~/ FlashNativeParticles.particleShapeSides!(shape);
+    _drawIndexed(canvas, _cornersPtr, _cornerColorsPtr, shape, particleCount, blendMode);
+  }
+
+  // Draws the geometry the particle thread built last frame; no emitter is read
+  void _renderParticleFrame(Canvas canvas, Matrix4 cameraMatrix, FParticlePipeline pipeline) {
+    if (pipeline.frame == nullptr || pipeline.frame.ref.vertexCount == 0) return;
+    final frame = pipeline.frame.ref;
+
+    canvas.save();
+    if (engine.reprojectParticles) {
+      // Map the screen space of the camera the frame was built with to this one's
+      final builtMatrix = Matrix4.zero();
+      for (int i = 0; i < 16; i++) {
+        builtMatrix.storage[i] = frame.matrix[i];
+      }
+      if (builtMatrix.invert() != 0) {
+        canvas.transform((cameraMatrix * builtMatrix).storage);
+      }
+    }
+
+    // Each group was filled in its layout from its own start slot; emitters
+    // with nothing visible have no vertices
+    for (int g = 0; g < pipeline.groups.length && g < frame.groupCount; g++) {
+      final group = pipeline.groups[g];
+      int particleCount = 0;
+      for (int e = group.firstEmitter; e < group.firstEmitter + group.emitterCount; e++) {
+        particleCount += frame.ranges[e * 2 + 1];
+      }
+      if (particleCount == 0) continue;
+      final start = frame.groupStarts[g];
+      final vertices = frame.vertices + start * 2;
+      final colors = frame.colors + start;
+      final atlas = group.atlas;
+      if (group.layout == particleLayoutTextured && atlas != null) {
+        _drawTextured(canvas, vertices, colors, frame.uvs + start * 2, atlas, particleCount, group.blendMode);
+      } else if (group.layout == particleLayoutSprites) {
+        _drawSprites(canvas, vertices, colors, group.shape, particleCount, group.blendMode);
+      } else if (group.layout == particleLayoutTrails) {
+        _drawTrails(canvas, vertices, colors, group.shape, particleCount, group.blendMode);
+      } else {
+        _drawIndexed(canvas, vertices, colors, group.shape, particleCount, group.blendMode);
+      }
+    }
+    canvas.restore();
+  }
+
+  // Draws spriteCount sprites from the start of the given buffers, which hold
+  // one RSTransform and color per particle (fill_sprite_buffer layout)
+  void _drawSprites(
+    Canvas canvas,
+    Pointer<Float> transforms,
+    Pointer<Uint32> colors,
+    int shape,
+    int spriteCount,
+    BlendMode blendMode,
+  ) {
+    final image = _spriteImages.putIfAbsent(shape, () => _buildSprite(shape));
+    if (_spriteRects.length < spriteCount * 4) {
+      _spriteRects = Float32List(math.max(spriteCount, _spriteRects.length ~/ 2) * 4);
+      for (int i = 0; i < _spriteRects.length; i += 4) {
+        _spriteRects[i + 2] = particleSpriteSize.toDouble();
+        _spriteRects[i + 3] = particleSpriteSize.toDouble();
+      }
+    }
+    canvas.drawRawAtlas(
+      image,
+      transforms.asTypedList(spriteCount * 4),
+      Float32List.sublistView(_spriteRects, 0, spriteCount * 4),
+      colors.cast<Int32>().asTypedList(spriteCount),
+      BlendMode.modulate,
+      null,
+      Paint()
+        ..blendMode = blendMode
+        ..filterQuality = FilterQuality.low,
+    );
+  }
+
+  // White polygon of the shape, with the corner order of the polygon fill
+  static ui.Image _buildSprite(int shape) {
+    final sides = FlashNativeParticles.particleShapeSides!(shape);
+    const half = particleSpriteSize / 2;
+    final path = Path();
+    for (int i = 0; i < sides; i++) {
+      final angle = i * 2 * math.pi / sides;
+      final x = half + math.cos(angle) * half;
+      final y = half + math.sin(angle) * half;
+      if (i == 0) {
+        path.moveTo(x, y);
+      } else {
+        path.lineTo(x, y);
+      }
+    }
+    path.close();
+
+    final recorder = ui.PictureRecorder();
+    Canvas(recorder).drawPath(path, Paint()..color = const Color(0xFFFFFFFF));
+    final picture = recorder.endRecording();
+    final image = picture.toImageSync(particleSpriteSize, particleSpriteSize);
+    picture.dispose();
+    return image;
+  }
+
+  void _renderParticlesIndexed(Canvas canvas, FParticleEmitter emitter) {
+    final renderedCount = FlashNativeParticles.fillVertexBufferIndexed!(
+      emitter.nativeEmitterPointer,
+      _matrixPtr,
+      _cornersPtr,
+      _cornerColorsPtr,
+      _maxRenderParticles,
+    );
+    if (renderedCount == 0) return;
+    _drawIndexed(canvas, _cornersPtr, _cornerColorsPtr, emitter.shapeType, renderedCount, emitter.blendMode);
+  }
+
+  // Draws particleCount particles of one shape from the start of the given corner buffers
+  void _drawIndexed(
+    Canvas canvas,
+    Pointer<Float> corners,
+    Pointer<Uint32> cornerColors,
+    int shape,
+    int particleCount,
+    BlendMode blendMode,
+  ) {
+    final sides = FlashNativeParticles.particleShapeSides!(shape);
+    final batchSize = 65536 ~/ sides;
+    final pattern = _indexPatterns.putIfAbsent(shape, () => _buildIndexPattern(shape, batchSize, sides));
+    _drawBatches(canvas, corners, cornerColors, sides, (sides - 2) * 3, pattern, particleCount, blendMode);
+  }
+
+  // Draws ribbonCount trail ribbons of the given length from the start of the given buffers
+  void _drawTrails(
+    Canvas canvas,
+    Pointer<Float> vertices,
+    Pointer<Uint32> colors,
+    int length,
+    int ribbonCount,
+    BlendMode blendMode,
+  ) {
+    final verticesPerRibbon = FlashNativeParticles.particleTrailVertices!(length);
+    final pattern = _trailIndexPatterns.putIfAbsent(length, () {
+      final batchSize = 65536 ~/ verticesPerRibbon;
+      final ptr = calloc<Uint16>(batchSize * length * 6);
+      final indexCount = FlashNativeParticles.buildTrailIndices!(length, batchSize, ptr);
+      final pattern = Uint16List.fromList(ptr.asTypedList(indexCount));
+      calloc.free(ptr);
+      return pattern;
+    });
+    _drawBatches(canvas, vertices, colors, verticesPerRibbon, length * 6, pattern, ribbonCount, blendMode);
+  }
+
+  // 16-bit indices: one draw per 65536 vertices, every batch indexed from its own first vertex.
+  // blendMode combines the vertex colors with paint's shader (textured particles).
+  void _drawBatches(
+    Canvas canvas,
+    Pointer<Float> vertices,
+    Pointer<Uint32> colors,
+    int verticesPerItem,
+    int indicesPerItem,
+    Uint16List pattern,
+    int itemCount,
+    BlendMode blendMode, {
+    Pointer<Float>? uvs,
+    Paint? paint,
+  }) {
+    final batchSize = 65536 ~/ verticesPerItem;
+    for (int first = 0; first < itemCount; first += batchSize) {
+      final n = math.min(batchSize, itemCount - first);
+      final batch = ui.Vertices.raw(
+        ui.VertexMode.triangles,
+        (vertices + first * verticesPerItem * 2).asTypedList(n * verticesPerItem * 2),
+        textureCoordinates: uvs == null
+            ? null
+            : (uvs + first * verticesPerItem * 2).asTypedList(n * verticesPerItem * 2),
+        colors: (colors + first * verticesPerItem).cast<Int32>().asTypedList(n * verticesPerItem),
+        indices: Uint16List.sublistView(pattern, 0, n * indicesPerItem),
+      );
+      canvas.drawVertices(batch, blendMode, paint ?? Paint());
+    }
+  }
+
+  static Uint16List _buildIndexPattern(int shape, int batchSize, int sides) {
+    final indexCount = batchSize * (sides - 2) * 3;
+    final ptr = calloc<Uint16>(indexCount);
+    FlashNativeParticles.buildParticleIndices!(shape, batchSize, ptr);
+    final pattern = Uint16List.fromList(ptr.asTypedList(indexCount));
+    calloc.free(ptr);
+    return pattern;
+  }
+
+  void _renderParticleFans(Canvas canvas, FParticleEmitter emitter) {
     // Fill native buffers in C++
     final fillFunc = FlashNativeParticles.fillVertexBuffer;
     if (fillFunc == null) return;
 
-    final renderedCount = fillFunc(emitter.nativeEmitterPointer, _matrixPtr, _verticesPtr, _colorsPtr, 1000000);
+    final verticesPtr = _fanVerticesPtr ??= calloc<Float>(_maxRenderParticles * 30 * 2);
+    final colorsPtr = _fanColorsPtr ??= calloc<Uint32>(_maxRenderParticles * 30);
+    final renderedCount = fillFunc(emitter.nativeEmitterPointer, _matrixPtr, verticesPtr, colorsPtr, _maxRenderParticles);
 
     if (renderedCount > 0) {
       // Get vertex multiplier based on shape
@@ -100,11 +457,11 @@ class FPainter extends CustomPainter {
 
       final vertices = ui.Vertices.raw(
         ui.VertexMode.triangles,
-        _verticesPtr.asTypedList(totalVertices * 2),
-        colors: _colorsPtr.cast<Int32>().asTypedList(totalVertices),
+        verticesPtr.asTypedList(totalVertices * 2),
+        colors: colorsPtr.cast<Int32>().asTypedList(totalVertices),
       );
 
-      canvas.drawVertices(vertices, BlendMode.srcOver, Paint());
+      canvas.drawVertices(vertices, emitter.blendMode, Paint());
     }
   }
 
@@ -40,6 +40,22 @@ class FEngine extends ChangeNotifier {
   final List<FLightNode> lights = [];
   final List<FParticleEmitter> emitters = [];
 
+  /// Simulate particles and build their geometry on a native thread, one
+  /// frame ahead of the painter (see [FParticlePipeline]). Emitters only emit
+  /// during node updates; the thread updates and fills them while this frame
+  /// paints last frame's geometry. Particles show one frame later than in
+  /// synchronous mode. Ignored on native libraries without the pipeline.
+  bool asyncParticles = false;
+
+  /// Redraw pipeline frames with the camera movement since they were built.
+  /// Exact for orthographic cameras that stay parallel to the XY plane.
+  bool reprojectParticles = true;
+
+  FParticlePipeline? _particlePipeline;
+
+  /// The running particle pipeline while [asyncParticles] is on
+  FParticlePipeline? get particlePipeline => _particlePipeline;
+
   late final Ticker _ticker;
 
   VoidCallback? onUpdate;
@@ -104,6 +120,8 @@ class FEngine extends ChangeNotifier {
   @override
   void dispose() {
     _ticker.dispose();
+    _particlePipeline?.dispose();
+    _particlePipeline = null;
     audio.dispose();
     FlashNativeParticles.destroyNativeScene!(nativeScene);
     super.dispose();
@@ -127,6 +145,14 @@ class FEngine extends ChangeNotifier {
       _fpsLastMeasureTime = currentTime;
     }
 
+    // Finish last frame's particle work first: its geometry is what this frame
+    // paints, and colliding emitters read the world the event callbacks below
+    // may write to
+    _beginParticleFrame();
+
+    // Same for last frame's async physics batch before nodes read or write bodies
+    physicsWorld?.waitForStep();
+
     // Process the SceneTree (lifecycle updates)
     tree.process(dt);
 
@@ -150,6 +176,7 @@ class FEngine extends ChangeNotifier {
     audio.updateListener(activeCamera!);
 
     _prepareRender();
+    _submitParticles(dt);
 
     notifyListeners();
 
@@ -158,6 +185,34 @@ class FEngine extends ChangeNotifier {
     }
   }
 
+  void _beginParticleFrame() {
+    if (asyncParticles && _particlePipeline == null && FParticlePipeline.isSupported) {
+      _particlePipeline = FParticlePipeline();
+    } else if (!asyncParticles && _particlePipeline != null) {
+      _particlePipeline!.dispose();
+      _particlePipeline = null;
+    }
+    _particlePipeline?.beginFrame();
+  }
+
+  void _submitParticles(double dt) {
+    final pipeline = _particlePipeline;
+    if (pipeline == null) return;
+
+    // Same world-to-pixels matrix as the painter
+    final width = viewportSize.x;
+    final height = viewportSize.y;
+    final viewportMatrix = v.Matrix4.identity()
+      ..setTranslationRaw(width / 2, height / 2, 0.0)
+      ..scaleByVector3(v.Vector3(width / 2, -height / 2, 1.0));
+    final screenMatrix =
+        viewportMatrix * activeCamera!.getProjectionMatrix(width, height) * activeCamera!.getViewMatrix();
+
+    // Nothing to draw before the first layout, but queued emitters still update
+    final visible = width > 0 && height > 0 ? emitters : const <FParticleEmitter>[];
+    pipeline.submit(visible, dt, screenMatrix, width, height);
+  }
+
   void _prepareRender() {
     renderNodes.clear();
     lights.clear();
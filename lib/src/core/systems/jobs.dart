@@ -0,0 +1,32 @@
+import '../native/particles_ffi.dart';
+
+/// Native job system shared by physics, particles and scene transforms.
+///
+/// The native core keeps one pool of worker threads alive for the whole app
+/// and splits its hot loops (narrowphase, body integration, particle update
+/// and fill, local transforms) across it. By default it uses every core, up
+/// to 8.
+///
+/// Example:
+/// ```dart
+/// // Leave a core for the raster thread on low-end devices
+/// FNativeJobs.threadCount = 2;
+/// ```
+class FNativeJobs {
+  FNativeJobs._();
+
+  /// Threads working on native loops, including the calling thread.
+  static int get threadCount {
+    FlashNativeParticles.init();
+    return FlashNativeParticles.getJobThreadCount?.call() ?? 1;
+  }
+
+  /// Set the thread count (0 = default, 1 = single-threaded). Rebuilds the
+  /// pool once running native loops (including the async physics and particle
+  /// threads) have finished, so call it rarely, e.g. at startup or on a
+  /// settings change.
+  static set threadCount(int count) {
+    FlashNativeParticles.init();
+    FlashNativeParticles.setJobThreadCount?.call(count < 0 ? 0 : count);
+  }
+}
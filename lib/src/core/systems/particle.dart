@@ -5,6 +5,7 @@ import 'package:ffi/ffi.dart';
 import 'package:vector_math/vector_math_64.dart';
 import '../graph/node.dart';
 import '../native/particles_ffi.dart';
+import '../native/physics_ids.dart';
 
 /// Individual particle data
 class FParticle {
@@ -401,13 +402,113 @@ class ParticleEmitterConfig {
   );
 }
 
+/// Spawn distribution for [FParticleEmitter.burst]
+///
+/// Point and box shapes take their velocities from the emitter config
+/// (velocity range + spread); cone, sphere and ring shapes emit at a speed
+/// range along the shape's own directions.
+class FEmitterShape {
+  final int type; // Matches EmitterShape in particles.h
+  final double radius;
+  final Vector3? halfExtents;
+  final Vector3? direction;
+  final double? spreadAngle;
+  final double speedMin;
+  final double speedMax;
+
+  const FEmitterShape._(
+    this.type, {
+    this.radius = 0,
+    this.halfExtents,
+    this.direction,
+    this.spreadAngle,
+    this.speedMin = 0,
+    this.speedMax = 0,
+  });
+
+  /// At the emitter position, like continuous emission
+  static const point = FEmitterShape._(0);
+
+  /// Within [spreadAngle] radians of [direction] (default up)
+  FEmitterShape.cone({Vector3? direction, double spreadAngle = 0.5, double speedMin = 100, double speedMax = 200})
+    : this._(1, direction: direction, spreadAngle: spreadAngle, speedMin: speedMin, speedMax: speedMax);
+
+  /// Uniform in a ball, moving outward
+  const FEmitterShape.sphere({double radius = 0, double speedMin = 100, double speedMax = 200})
+    : this._(2, radius: radius, speedMin: speedMin, speedMax: speedMax);
+
+  /// Uniform in a box around the emitter
+  const FEmitterShape.box(Vector3 halfExtents) : this._(3, halfExtents: halfExtents);
+
+  /// On a circle in the XY plane, moving outward
+  const FEmitterShape.ring({required double radius, double speedMin = 100, double speedMax = 200})
+    : this._(4, radius: radius, speedMin: speedMin, speedMax: speedMax);
+}
+
+/// What a particle does when it hits a body (see [FParticleEmitter.collideWith])
+enum FParticleCollisionResponse { bounce, stick, kill }
+
+/// Force applied natively to every particle of an emitter, in world space
+/// (see [FParticleEmitter.forceFields])
+class FForceField {
+  final int type; // Matches ForceFieldType in particles.h
+  final Vector3 position;
+  final Vector3? axis;
+  final double strength;
+  final double radius;
+  final double frequency;
+  final double bounce;
+
+  const FForceField._(
+    this.type,
+    this.position, {
+    this.axis,
+    this.strength = 0,
+    this.radius = 0,
+    this.frequency = 0,
+    this.bounce = 0,
+  });
+
+  /// Pulls particles toward [position]; negative [strength] repels.
+  /// Fades out linearly at [radius] (0 = unlimited).
+  const FForceField.attractor(Vector3 position, {double strength = 200, double radius = 0})
+    : this._(0, position, strength: strength, radius: radius);
+
+  /// Swirls particles around [axis] (default Z, the screen plane) through [position]
+  const FForceField.vortex(Vector3 position, {Vector3? axis, double strength = 200, double radius = 0})
+    : this._(1, position, axis: axis, strength: strength, radius: radius);
+
+  /// Curl noise; [frequency] is noise cells per unit. Move [position] over
+  /// time to animate the pattern.
+  const FForceField.turbulence(Vector3 position, {double strength = 100, double frequency = 0.01})
+    : this._(2, position, strength: strength, frequency: frequency);
+
+  /// Velocity damping per second
+  FForceField.drag(double strength) : this._(3, Vector3.zero(), strength: strength);
+
+  /// Keeps particles on the [normal] side of the plane through [position],
+  /// bouncing them off with [bounce] restitution
+  const FForceField.plane(Vector3 position, Vector3 normal, {double bounce = 0.5})
+    : this._(4, position, axis: normal, bounce: bounce);
+}
+
 // ... (FlashParticle class can remain if used for high-level callbacks, but we'll focus on the emitter)
 
 /// Particle emitter node (High Performance Native Version)
 class FParticleEmitter extends FNode {
   late final Pointer<ParticleEmitter> _nativeEmitter;
+  late final bool _ownsNativeEmitter; // Allocated by create_particle_emitter
   final int maxParticles;
   final Random _random = Random();
+  Pointer<EmitterShapeDef> _shapeDef = nullptr; // Allocated by the first native burst
+  Pointer<ParticleCurves> _curves = nullptr;
+  Pointer<ForceField> _forceFields = nullptr;
+  int _forceFieldCapacity = 0;
+  List<FForceField> _forceFieldList = const [];
+  Pointer<ParticleCollision> _collision = nullptr;
+  Pointer<ParticleAtlas> _atlas = nullptr;
+  Image? _atlasImage;
+  FParticlePipeline? _pipeline; // Last pipeline this emitter was handed to
 
   ParticleEmitterConfig config;
   bool emitting;
@@ -418,28 +519,267 @@ class FParticleEmitter extends FNode {
       maxParticles = config?.maxParticles ?? 1000 {
     // Ensure native core is initialized
     FlashNativeParticles.init();
-    _nativeEmitter = calloc<ParticleEmitter>();
 
-    // Allocate shared memory for particles
-    _nativeEmitter.ref.particles = calloc<NativeParticle>(maxParticles);
-    _nativeEmitter.ref.maxParticles = maxParticles;
-    _nativeEmitter.ref.activeCount = 0;
-    _nativeEmitter.ref.shapeType = this.config.shapeType;
+    // Prefer native SoA storage (SIMD update); older libraries get the calloc'd AoS layout
+    final create = FlashNativeParticles.createParticleEmitter;
+    final native = create != null ? create(maxParticles, this.config.shapeType) : nullptr;
+    _ownsNativeEmitter = native != nullptr;
+    if (_ownsNativeEmitter) {
+      _nativeEmitter = native;
+    } else {
+      _nativeEmitter = calloc<ParticleEmitter>();
+
+      // Allocate shared memory for particles
+      _nativeEmitter.ref.particles = calloc<NativeParticle>(maxParticles);
+      _nativeEmitter.ref.maxParticles = maxParticles;
+      _nativeEmitter.ref.activeCount = 0;
+      _nativeEmitter.ref.shapeType = this.config.shapeType;
+    }
 
     _updateNativeGravity();
   }
 
   int get shapeType => _nativeEmitter.ref.shapeType;
-  set shapeType(int value) => _nativeEmitter.ref.shapeType = value;
+  set shapeType(int value) {
+    _pipeline?.wait();
+    _nativeEmitter.ref.shapeType = value;
+  }
+
+  /// Particles whose projected half size is below this many pixels are not drawn (0 = draw all)
+  double get minScreenSize => _nativeEmitter.ref.minScreenSize;
+  set minScreenSize(double value) {
+    _pipeline?.wait();
+    _nativeEmitter.ref.minScreenSize = value;
+  }
+
+  /// Blend mode of the particle draw. Emitters with the same blend mode and
+  /// shape are filled into one buffer and drawn with one call.
+  BlendMode blendMode = BlendMode.srcOver;
+
+  /// Draw each particle as one atlas sprite of its shape (Canvas.drawRawAtlas):
+  /// 20 bytes per particle reach Skia/Impeller instead of 12 per polygon
+  /// corner, and edges are antialiased. Worth it for large counts, especially
+  /// of round particles.
+  bool drawAsSprites = false;
+
+  /// Draw particles back to front by projected depth (native radix sort) so
+  /// alpha blending stays stable as particles die and are recycled
+  bool get sortByDepth => _nativeEmitter.ref.sortMode == 1;
+  set sortByDepth(bool value) {
+    _pipeline?.wait();
+    _nativeEmitter.ref.sortMode = value ? 1 : 0;
+  }
+
+  /// Size multiplier over the particle's lifetime (replaces the linear
+  /// shrink). [keys] are evenly spaced from spawn to death; an empty list
+  /// clears the curve.
+  void setSizeCurve(List<double> keys) {
+    if (keys.isEmpty) return _clearCurve(1);
+    final curves = _ensureCurves();
+    for (int i = 0; i < particleCurveSamples; i++) {
+      curves.ref.size[i] = _sampleKeys(keys, i, _lerpKeys);
+    }
+    curves.ref.flags |= 1;
+  }
+
+  /// Color over lifetime: RGB tints the particle color, alpha replaces the
+  /// linear fade. [keys] are evenly spaced from spawn to death; an empty list
+  /// clears the gradient.
+  void setColorGradient(List<Color> keys) {
+    if (keys.isEmpty) return _clearCurve(2);
+    final curves = _ensureCurves();
+    for (int i = 0; i < particleCurveSamples; i++) {
+      curves.ref.color[i] = _sampleKeys(keys, i, (a, b, t) => Color.lerp(a, b, t)!).value;
+    }
+    curves.ref.flags |= 2;
+  }
+
+  /// Velocity damping per second over the particle's lifetime.
+  /// [keys] are evenly spaced from spawn to death; an empty list clears the curve.
+  void setDrag(List<double> keys) {
+    if (keys.isEmpty) return _clearCurve(4);
+    final curves = _ensureCurves();
+    for (int i = 0; i < particleCurveSamples; i++) {
+      curves.ref.drag[i] = _sampleKeys(keys, i, _lerpKeys);
+    }
+    curves.ref.flags |= 4;
+  }
+
+  // Turns one curve (ParticleCurves.flags bit) off, keeping the others
+  void _clearCurve(int flag) {
+    _pipeline?.wait();
+    if (_curves != nullptr) _curves.ref.flags &= ~flag;
+  }
+
+  /// Back to linear size and alpha fades with no drag
+  void clearCurves() {
+    _pipeline?.wait();
+    if (_curves != nullptr) _curves.ref.flags = 0;
+  }
+
+  /// Forces evaluated in the native update (SoA emitters). Reassign after
+  /// changing a field, e.g. to move an attractor every frame.
+  List<FForceField> get forceFields => _forceFieldList;
+  set forceFields(List<FForceField> fields) {
+    _pipeline?.wait();
+    _forceFieldList = fields;
+    if (fields.length > _forceFieldCapacity) {
+      if (_forceFields != nullptr) calloc.free(_forceFields);
+      _forceFieldCapacity = fields.length;
+      _forceFields = calloc<ForceField>(_forceFieldCapacity);
+    }
+    for (int i = 0; i < fields.length; i++) {
+      final field = fields[i];
+      final native = _forceFields[i];
+      native.type = field.type;
+      native.x = field.position.x;
+      native.y = field.position.y;
+      native.z = field.position.z;
+      native.axisX = field.axis?.x ?? 0;
+      native.axisY = field.axis?.y ?? 0;
+      native.axisZ = field.axis?.z ?? 0;
+      native.strength = field.strength;
+      native.radius = field.radius;
+      native.frequency = field.frequency;
+      native.bounce = field.bounce;
+    }
+    _nativeEmitter.ref.forceFields = _forceFields;
+    _nativeEmitter.ref.forceFieldCount = fields.length;
+  }
+
+  /// Collides particles (x/y) with the static and kinematic bodies of [world]
+  /// in the native update. [radius] is the particle's collision radius in
+  /// world units. Don't update the emitter while the world steps asynchronously.
+  void collideWith(
+    WorldId world, {
+    FParticleCollisionResponse response = FParticleCollisionResponse.bounce,
+    double bounce = 0.3,
+    double friction = 0.1,
+    double radius = 0,
+    int categoryBits = 0xFFFF,
+    int maskBits = 0xFFFF,
+  }) {
+    _pipeline?.wait();
+    if (_collision == nullptr) _collision = calloc<ParticleCollision>();
+    final c = _collision.ref;
+    c.world = world;
+    c.response = response.index;
+    c.bounce = bounce;
+    c.friction = friction;
+    c.radius = radius;
+    c.categoryBits = categoryBits;
+    c.maskBits = maskBits;
+    _nativeEmitter.ref.collision = _collision;
+    _colliding.add(this);
+  }
+
+  /// Particles pass through bodies again
+  void stopColliding() {
+    _pipeline?.wait();
+    _nativeEmitter.ref.collision = nullptr;
+    _colliding.remove(this);
+  }
+
+  // Emitters with a collision world, so a world can detach them before it is freed
+  static final Set<FParticleEmitter> _colliding = {};
+
+  /// Waits for the particle thread of every emitter colliding with [world]
+  /// and makes them stop colliding. FPhysicsSystem.dispose calls it before
+  /// the world is destroyed.
+  static void releaseCollisionWorld(WorldId world) {
+    for (final emitter in _colliding.toList()) {
+      if (emitter._collision.ref.world == world) emitter.stopColliding();
+    }
+  }
+
+  /// Draws each particle as a ribbon through its last [length] positions
+  /// (2 to [particleTrailMaxPoints]), recorded natively every [interval]
+  /// seconds. Width and alpha taper from the particle's to [tailWidth] and
+  /// [tailAlpha] times theirs at the oldest point. Replaces the particle's
+  /// shape; SoA emitters only. Returns false if the trail was not applied.
+  bool setTrail(int length, {double interval = 0, double tailWidth = 0, double tailAlpha = 0}) {
+    final setTrails = FlashNativeParticles.setParticleTrails;
+    if (setTrails == null || FlashNativeParticles.fillTrailBuffer == null) return false;
+    _pipeline?.wait();
+    if (setTrails(_nativeEmitter, length, interval) == 0) return false;
+    final trails = _nativeEmitter.ref.trails;
+    trails.ref.tailWidth = tailWidth;
+    trails.ref.tailAlpha = tailAlpha;
+    return true;
+  }
+
+  /// Back to drawing the particle shape
+  void clearTrail() {
+    if (_nativeEmitter.ref.trails == nullptr) return;
+    _pipeline?.wait();
+    FlashNativeParticles.setParticleTrails!(_nativeEmitter, 0, 0);
+  }
+
+  /// Recorded points per particle (0 without a trail)
+  int get trailLength => _nativeEmitter.ref.trails == nullptr ? 0 : _nativeEmitter.ref.trails.ref.length;
+
+  /// Draws each particle as a square cell of [image], a [columns] x [rows]
+  /// grid, tinted by the particle color. The cell plays a flipbook of
+  /// [frameCount] cells (default: the whole grid) from [firstFrame], [cycles]
+  /// times over the particle's life. Emitters sharing an image are filled
+  /// natively into one buffer with UVs and drawn with one ImageShader draw.
+  /// The image stays owned by the caller. Trails take precedence.
+  void setAtlas(Image image, {int columns = 1, int rows = 1, int firstFrame = 0, int? frameCount, double cycles = 1}) {
+    _pipeline?.wait();
+    if (_atlas == nullptr) _atlas = calloc<ParticleAtlas>();
+    final a = _atlas.ref;
+    a.columns = columns;
+    a.rows = rows;
+    a.firstFrame = firstFrame;
+    a.frameCount = frameCount ?? columns * rows;
+    a.cycles = cycles;
+    a.width = image.width.toDouble();
+    a.height = image.height.toDouble();
+    _atlasImage = image;
+    _nativeEmitter.ref.atlas = _atlas;
+  }
+
+  /// Back to untextured particles
+  void clearAtlas() {
+    _pipeline?.wait();
+    _nativeEmitter.ref.atlas = nullptr;
+    _atlasImage = null;
+  }
+
+  /// Image of [setAtlas] (null for untextured particles)
+  Image? get atlasImage => _atlasImage;
+
+  // Every curve setter writes the tables through this, so it also waits for the particle thread
+  Pointer<ParticleCurves> _ensureCurves() {
+    _pipeline?.wait();
+    if (_curves == nullptr) {
+      _curves = calloc<ParticleCurves>();
+      _nativeEmitter.ref.curves = _curves;
+    }
+    return _curves;
+  }
+
+  // Piecewise-linear value of evenly spaced (non-empty) keys at table sample i
+  static T _sampleKeys<T>(List<T> keys, int i, T Function(T a, T b, double t) lerp) {
+    if (keys.length == 1) return keys[0];
+    final t = i / (particleCurveSamples - 1) * (keys.length - 1);
+    final k = min(t.floor(), keys.length - 2);
+    return lerp(keys[k], keys[k + 1], t - k);
+  }
+
+  static double _lerpKeys(double a, double b, double t) => a + (b - a) * t;
 
   void _updateNativeGravity() {
+    _pipeline?.wait();
     _nativeEmitter.ref.gravityX = config.gravity.x;
     _nativeEmitter.ref.gravityY = config.gravity.y;
     _nativeEmitter.ref.gravityZ = config.gravity.z;
   }
 
   /// Direct access to native particles for the renderer
+  /// (nullptr when the emitter uses SoA streams, see [nativeStreams])
   Pointer<NativeParticle> get nativeParticles => _nativeEmitter.ref.particles;
+  Pointer<ParticleStreams> get nativeStreams => _nativeEmitter.ref.streams;
   Pointer<ParticleEmitter> get nativeEmitterPointer => _nativeEmitter;
   int get activeCount => _nativeEmitter.ref.activeCount;
 
@@ -453,16 +793,67 @@ class FParticleEmitter extends FNode {
     // 1. Emit new particles
     if (emitting && (config.loop || activeCount == 0)) {
       _emissionAccumulator += dt * config.emissionRate;
-      while (_emissionAccumulator >= 1 && activeCount < maxParticles) {
-        _spawnParticle();
-        _emissionAccumulator -= 1;
+      final count = min(_emissionAccumulator.floor(), maxParticles - activeCount);
+      if (count > 0) {
+        burst(count);
+        _emissionAccumulator -= count;
       }
     }
 
-    // 2. Call Native C++ update logic
+    // 2. Call Native C++ update logic, or leave it to the particle thread
+    final pipeline = tree?.engine.particlePipeline;
+    if (pipeline != null) {
+      pipeline._queue(this);
+      return;
+    }
     FlashNativeParticles.updateParticles!(_nativeEmitter, dt);
   }
 
+  /// Spawns up to [count] particles at once. Positions and velocities are
+  /// generated natively in one FFI call (falls back to one call per particle
+  /// on libraries without spawn_burst). Returns the number spawned.
+  int burst(int count, [FEmitterShape shape = FEmitterShape.point]) {
+    _pipeline?.wait();
+    final spawnBurst = FlashNativeParticles.spawnBurst;
+    if (spawnBurst == null) {
+      final before = activeCount;
+      for (int i = 0; i < count && activeCount < maxParticles; i++) {
+        _spawnParticle();
+      }
+      return activeCount - before;
+    }
+
+    if (_shapeDef == nullptr) _shapeDef = calloc<EmitterShapeDef>()..ref.seed = _random.nextInt(1 << 32);
+    final def = _shapeDef.ref;
+    final position = worldPosition;
+    def.shape = shape.type;
+    def.x = position.x;
+    def.y = position.y;
+    def.z = position.z;
+    def.radius = shape.radius;
+    def.halfX = shape.halfExtents?.x ?? 0;
+    def.halfY = shape.halfExtents?.y ?? 0;
+    def.halfZ = shape.halfExtents?.z ?? 0;
+    def.dirX = shape.direction?.x ?? 0;
+    def.dirY = shape.direction?.y ?? 1;
+    def.dirZ = shape.direction?.z ?? 0;
+    def.spreadAngle = shape.spreadAngle ?? config.spreadAngle;
+    def.speedMin = shape.speedMin;
+    def.speedMax = shape.speedMax;
+    def.velMinX = config.velocityMin.x;
+    def.velMinY = config.velocityMin.y;
+    def.velMinZ = config.velocityMin.z;
+    def.velMaxX = config.velocityMax.x;
+    def.velMaxY = config.velocityMax.y;
+    def.velMaxZ = config.velocityMax.z;
+    def.lifeMin = config.lifetimeMin;
+    def.lifeMax = config.lifetimeMax;
+    def.sizeMin = config.sizeMin;
+    def.sizeMax = config.sizeMax;
+    def.color = config.startColor.value;
+    return spawnBurst(_nativeEmitter, count, _shapeDef);
+  }
+
   void _spawnParticle() {
     final lifetime = _randomRange(config.lifetimeMin, config.lifetimeMax);
     final size = _randomRange(config.sizeMin, config.sizeMax);
@@ -509,9 +900,194 @@ class FParticleEmitter extends FNode {
     if (_disposed) return;
     _disposed = true;
 
+    // The particle thread may still be updating or filling this emitter
+    _pipeline?.wait();
+
     // IMPORTANT: Free native memory!
-    calloc.free(_nativeEmitter.ref.particles);
-    calloc.free(_nativeEmitter);
+    if (_shapeDef != nullptr) calloc.free(_shapeDef);
+    _nativeEmitter.ref.curves = nullptr;
+    if (_curves != nullptr) calloc.free(_curves);
+    _nativeEmitter.ref.forceFields = nullptr;
+    _nativeEmitter.ref.forceFieldCount = 0;
+    if (_forceFields != nullptr) calloc.free(_forceFields);
+    _nativeEmitter.ref.collision = nullptr;
+    _colliding.remove(this);
+    if (_collision != nullptr) calloc.free(_collision);
+    _nativeEmitter.ref.atlas = nullptr;
+    if (_atlas != nullptr) calloc.free(_atlas);
+    if (_ownsNativeEmitter) {
+      FlashNativeParticles.destroyParticleEmitter!(_nativeEmitter);
+    } else {
+      calloc.free(_nativeEmitter.ref.particles);
+      calloc.free(_nativeEmitter);
+    }
     super.dispose();
   }
 }
+
+/// Emitters [firstEmitter] to [firstEmitter] + [emitterCount] - 1 of a
+/// pipeline frame, filled in one layout (particleLayoutCorners, Sprites,
+/// Trails or Textured) and drawn with one blend mode and shape (trail length
+/// for trails) or [atlas] image (textured)
+typedef FParticleDrawGroup = ({
+  BlendMode blendMode,
+  int layout,
+  int shape,
+  Image? atlas,
+  int firstEmitter,
+  int emitterCount,
+});
+
+/// Simulates particles and builds their geometry on a native thread, one
+/// frame ahead of the painter (see particles_async.h).
+///
+/// Emitters only emit in [FParticleEmitter.update] and queue themselves;
+/// [submit] hands the frame's updates and fill to the thread and returns.
+/// The next frame's [beginFrame] waits for it and keeps the finished geometry
+/// in [frame], which the painter draws without touching any emitter.
+///
+/// While a frame is in flight the emitters belong to the thread. The engine
+/// waits before nodes update, and the [FParticleEmitter] setters and
+/// [FParticleEmitter.burst] wait themselves; call [wait] before writing to
+/// the native emitter directly.
+class FParticlePipeline {
+  final int maxRenderCount;
+  final Pointer<ParticlePipeline> _native;
+  final Pointer<Float> _matrix = calloc<Float>(16);
+  Pointer<Pointer<ParticleEmitter>> _emitterList = nullptr;
+  int _emitterListCapacity = 0;
+  Pointer<Int32> _groupList = nullptr; // {layout, emitterCount} per group
+  int _groupListCapacity = 0;
+  final List<FParticleEmitter> _queued = [];
+  List<FParticleDrawGroup> _submittedGroups = const [];
+  bool _inFlight = false;
+
+  /// Geometry finished for this frame (empty before the first one)
+  Pointer<ParticleFrame> frame = nullptr;
+
+  /// Draw groups of [frame], in draw order
+  List<FParticleDrawGroup> groups = const [];
+
+  FParticlePipeline({this.maxRenderCount = 1000000})
+    : _native = FlashNativeParticles.createParticlePipeline!(maxRenderCount);
+
+  /// False on native libraries built without particles_async.cpp
+  static bool get isSupported => FlashNativeParticles.createParticlePipeline != null;
+
+  void _queue(FParticleEmitter emitter) => _queued.add(emitter);
+
+  /// Blocks until the submitted frame (if any) is finished
+  void wait() {
+    if (!_inFlight) return;
+    FlashNativeParticles.waitParticlePipeline!(_native);
+    _inFlight = false;
+  }
+
+  /// Waits for last frame's work and makes its geometry the one to draw
+  void beginFrame() {
+    wait();
+    frame = FlashNativeParticles.getParticleFrame!(_native);
+    groups = _submittedGroups;
+  }
+
+  /// Updates the queued emitters by [dt] and fills [visible] with [matrix]
+  /// (world to screen pixels, culled to [width] x [height]) on the thread
+  void submit(List<FParticleEmitter> visible, double dt, Matrix4 matrix, double width, double height) {
+    wait();
+
+    // One contiguous run per (blend mode, layout, shape, trail length or atlas
+    // image), in order of the first emitter; the same grouping as the
+    // synchronous painter
+    final spritesSupported = FlashNativeParticles.fillSpriteBuffer != null;
+    final texturedSupported = FlashNativeParticles.fillTexturedBufferMulti != null;
+    final runs = <(BlendMode, int, Object), List<FParticleEmitter>>{};
+    for (final emitter in visible) {
+      if (emitter.isDisposed) continue;
+      final trailLength = emitter.trailLength;
+      final atlasImage = emitter.atlasImage;
+      final (BlendMode, int, Object) key;
+      if (trailLength > 0) {
+        key = (emitter.blendMode, particleLayoutTrails, trailLength);
+      } else if (atlasImage != null && texturedSupported) {
+        key = (emitter.blendMode, particleLayoutTextured, atlasImage);
+      } else if (emitter.drawAsSprites && spritesSupported) {
+        key = (emitter.blendMode, particleLayoutSprites, emitter.shapeType);
+      } else {
+        key = (emitter.blendMode, particleLayoutCorners, emitter.shapeType);
+      }
+      runs.putIfAbsent(key, () => []).add(emitter);
+    }
+    final draws = <FParticleEmitter>[];
+    final submittedGroups = <FParticleDrawGroup>[];
+    runs.forEach((key, run) {
+      final (blendMode, layout, shapeOrImage) = key;
+      submittedGroups.add((
+        blendMode: blendMode,
+        layout: layout,
+        shape: shapeOrImage is int ? shapeOrImage : 0,
+        atlas: shapeOrImage is Image ? shapeOrImage : null,
+        firstEmitter: draws.length,
+        emitterCount: run.length,
+      ));
+      draws.addAll(run);
+    });
+    if (submittedGroups.length > _groupListCapacity) {
+      if (_groupList != nullptr) calloc.free(_groupList);
+      _groupListCapacity = max(submittedGroups.length, _groupListCapacity * 2);
+      _groupList = calloc<Int32>(_groupListCapacity * 2);
+    }
+    for (int g = 0; g < submittedGroups.length; g++) {
+      _groupList[g * 2] = submittedGroups[g].layout;
+      _groupList[g * 2 + 1] = submittedGroups[g].emitterCount;
+    }
+    _queued.removeWhere((emitter) => emitter.isDisposed);
+
+    final count = _queued.length + draws.length;
+    if (count > _emitterListCapacity) {
+      if (_emitterList != nullptr) calloc.free(_emitterList);
+      _emitterListCapacity = max(count, _emitterListCapacity * 2);
+      _emitterList = calloc<Pointer<ParticleEmitter>>(_emitterListCapacity);
+    }
+    for (int i = 0; i < _queued.length; i++) {
+      _queued[i]._pipeline = this;
+      _emitterList[i] = _queued[i]._nativeEmitter;
+    }
+    for (int i = 0; i < draws.length; i++) {
+      final emitter = draws[i];
+      emitter._pipeline = this;
+      final native = emitter._nativeEmitter.ref;
+      native.viewMinX = 0;
+      native.viewMinY = 0;
+      native.viewMaxX = width;
+      native.viewMaxY = height;
+      _emitterList[_queued.length + i] = emitter._nativeEmitter;
+    }
+    for (int i = 0; i < 16; i++) {
+      _matrix[i] = matrix.storage[i];
+    }
+
+    FlashNativeParticles.submitParticleFrame!(
+      _native,
+      _emitterList,
+      _queued.length,
+      _emitterList + _queued.length,
+      draws.length,
+      _groupList,
+      submittedGroups.length,
+      dt,
+      _matrix,
+    );
+    _inFlight = true;
+    _submittedGroups = submittedGroups;
+    _queued.clear();
+  }
+
+  void dispose() {
+    wait();
+    FlashNativeParticles.destroyParticlePipeline!(_native);
+    frame = nullptr;
+    calloc.free(_matrix);
+    if (_emitterList != nullptr) calloc.free(_emitterList);
+    if (_groupList != nullptr) calloc.free(_groupList);
+  }
+}
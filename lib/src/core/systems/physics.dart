@@ -1,5 +1,7 @@
 import 'dart:ffi';
+import 'dart:math' show cos;
 import 'dart:io';
+import 'dart:typed_data';
 import 'package:ffi/ffi.dart';
 import 'package:flutter/material.dart';
 import 'package:vector_math/vector_math_64.dart' as v;
@@ -8,6 +10,7 @@ import '../graph/signal.dart';
 import '../native/particles_ffi.dart';
 import '../native/physics_joints_ffi.dart';
 import '../native/physics_ids.dart';
+import 'particle.dart' show FParticleEmitter;
 
 export '../native/physics_ids.dart'; // Export ID types (WorldId, BodyId)
 
@@ -65,9 +68,103 @@ class FPhysicsSystem {
     return FlashNativeParticles.createPhysicsWorld!(capacity);
   }
 
+  // -- Contact Event Signals (emitted once per frame after stepping) --
+
+  /// Two solid bodies started touching
+  final FSignal<FContactEvent> contactBegin = FSignal();
+
+  /// Two solid bodies stopped touching
+  final FSignal<FContactEvent> contactEnd = FSignal();
+
+  /// Two solid bodies started touching faster than [hitEventThreshold]
+  final FSignal<FContactEvent> contactHit = FSignal();
+
+  /// A body entered a sensor ([FContactEvent.bodyA] is the sensor)
+  final FSignal<FContactEvent> sensorBegin = FSignal();
+
+  /// A body left a sensor ([FContactEvent.bodyA] is the sensor)
+  final FSignal<FContactEvent> sensorEnd = FSignal();
+
+  /// Minimum approach speed (pixels/s) for [contactHit]
+  set hitEventThreshold(double value) => FlashNativeParticles.setHitEventThreshold?.call(world, value);
+
+  /// Total events lost because the native ring buffer was full when they were
+  /// produced (new events are dropped, unread ones are kept).
+  int get droppedContactEvents {
+    final buffer = FlashNativeParticles.getContactEvents?.call(world);
+    if (buffer == null || buffer == nullptr) return 0;
+    return buffer.ref.droppedCount;
+  }
+
+  // Body nodes by (world address, body id), used to resolve event body IDs
+  static final Map<(int, BodyId), FPhysicsBody> _bodyNodes = {};
+
+  static void _registerBody(FPhysicsBody body) => _bodyNodes[(body.world.address, body.bodyId)] = body;
+  static void _unregisterBody(FPhysicsBody body) {
+    final key = (body.world.address, body.bodyId);
+    if (identical(_bodyNodes[key], body)) _bodyNodes.remove(key);
+  }
+
+  /// The [FPhysicsBody] node owning [bodyId], if the body was created through one.
+  static FPhysicsBody? bodyNode(WorldId world, BodyId bodyId) => _bodyNodes[(world.address, bodyId)];
+
   double _accumulator = 0.0;
   static const double _fixedDt = 1.0 / 120.0; // Run physics at 120Hz fixed
 
+  /// Number of fixed steps run by the last [update] call.
+  int stepsLastUpdate = 0;
+
+  // -- Profiling --
+
+  bool _profilingEnabled = false;
+  bool get profilingEnabled => _profilingEnabled;
+
+  /// Make every step record per-phase timings (small overhead, off by default).
+  /// Waits natively for a running asynchronous batch, which writes the profile.
+  set profilingEnabled(bool enable) {
+    final toggle = FlashNativeParticles.enablePhysicsProfile;
+    if (toggle == null) return;
+    toggle(world, enable ? 1 : 0);
+    _profilingEnabled = enable;
+  }
+
+  /// Profile of the most recent step, or null while profiling is disabled.
+  /// Waits natively for a running asynchronous batch first.
+  FPhysicsProfile? get profile {
+    if (!_profilingEnabled) return null;
+    final ptr = FlashNativeParticles.getPhysicsProfile?.call(world);
+    if (ptr == null || ptr == nullptr) return null;
+    return FPhysicsProfile._fromNative(ptr.ref);
+  }
+
+  // -- Asynchronous Stepping --
+
+  /// Run the fixed steps on a native physics thread instead of the UI isolate.
+  ///
+  /// [update] only hands the steps to the thread and returns; the simulation
+  /// then overlaps with tweens, widget builds and rendering. The engine calls
+  /// [waitForStep] at the start of the next frame, before nodes run, so game
+  /// code always sees a finished step. Contact events arrive one frame later
+  /// than in synchronous mode.
+  bool asyncStepping = false;
+
+  // Addresses of worlds with a batch handed to the physics thread and not yet
+  // waited for, so per-body reads need no native call
+  static final Set<int> _steppingWorlds = {};
+
+  bool get _stepInFlight => _steppingWorlds.contains(world.address);
+  set _stepInFlight(bool value) {
+    if (value) {
+      _steppingWorlds.add(world.address);
+    } else {
+      _steppingWorlds.remove(world.address);
+    }
+  }
+
+  /// Whether a batch started by [update] may still be running on [world]
+  /// (until [waitForStep]). The world must not be read directly meanwhile.
+  static bool isStepping(WorldId world) => _steppingWorlds.contains(world.address);
+
   void update(double dt) {
     // Fixed Time Step Loop
     // Accumulate time and step physics in fixed chunks.
@@ -78,13 +175,96 @@ class FPhysicsSystem {
 
     _accumulator += dt;
 
+    int steps = 0;
     while (_accumulator >= _fixedDt) {
-      FlashNativeParticles.stepPhysics!(world, _fixedDt);
       _accumulator -= _fixedDt;
+      steps++;
     }
+    stepsLastUpdate = steps;
+
+    // Never overlap two batches, or a batch with synchronous steps
+    waitForStep();
+
+    final stepAsync = FlashNativeParticles.stepPhysicsAsync;
+    if (asyncStepping && stepAsync != null) {
+      if (steps > 0) {
+        stepAsync(world, _fixedDt, steps);
+        _stepInFlight = true;
+      }
+      return;
+    }
+
+    for (int i = 0; i < steps; i++) {
+      FlashNativeParticles.stepPhysics!(world, _fixedDt);
+    }
+    _dispatchContactEvents();
+  }
+
+  /// Finish the asynchronous step started by the last [update] and emit its
+  /// contact events. No-op when nothing is running.
+  ///
+  /// Call it before touching the world outside the node update phase
+  /// (snapshots, raw `world.ref` access, creating bodies from a callback).
+  void waitForStep() {
+    if (!_stepInFlight) return;
+    FlashNativeParticles.waitPhysics?.call(world);
+    _stepInFlight = false;
+    _dispatchContactEvents();
+  }
+
+  /// Drain the native event ring buffer (zero-copy) and emit signals.
+  void _dispatchContactEvents() {
+    final buffer = FlashNativeParticles.getContactEvents?.call(world);
+    if (buffer == null || buffer == nullptr) return;
+
+    final ring = buffer.ref;
+    final writeIndex = ring.writeIndex;
+    int readIndex = ring.readIndex;
+    while (readIndex != writeIndex) {
+      final e = (ring.events + (readIndex % ring.capacity)).ref;
+      readIndex = (readIndex + 1) & 0xFFFFFFFF;
+
+      final event = FContactEvent(
+        type: e.type,
+        bodyA: e.bodyA,
+        bodyB: e.bodyB,
+        point: Offset(e.pointX, e.pointY),
+        normal: Offset(e.normalX, e.normalY),
+        approachSpeed: e.approachSpeed,
+      );
+      final nodeA = bodyNode(world, e.bodyA);
+      final nodeB = bodyNode(world, e.bodyB);
+
+      switch (e.type) {
+        case FContactEvent.begin:
+          contactBegin.emit(event);
+          if (nodeA != null && nodeB != null) {
+            nodeA.contactBegin.emit(nodeB);
+            nodeB.contactBegin.emit(nodeA);
+          }
+        case FContactEvent.end:
+          contactEnd.emit(event);
+          if (nodeA != null && nodeB != null) {
+            nodeA.contactEnd.emit(nodeB);
+            nodeB.contactEnd.emit(nodeA);
+          }
+        case FContactEvent.hit:
+          contactHit.emit(event);
+        case FContactEvent.sensorBegin:
+          sensorBegin.emit(event);
+          if (nodeA != null && nodeB != null) nodeA.bodyEntered.emit(nodeB);
+        case FContactEvent.sensorEnd:
+          sensorEnd.emit(event);
+          if (nodeA != null && nodeB != null) nodeA.bodyExited.emit(nodeB);
+      }
+    }
+    ring.readIndex = writeIndex;
   }
 
   void dispose() {
+    _stepInFlight = false; // destroy_physics_world joins the physics thread
+    FParticleEmitter.releaseCollisionWorld(world); // Particle threads may still read the world
+    _bodyNodes.removeWhere((key, _) => key.$1 == world.address);
     FlashNativeParticles.destroyPhysicsWorld!(world);
   }
 
@@ -136,6 +316,16 @@ class FPhysicsSystem {
     FlashNativeParticles.getBodyPosition!(world, bodyId, posX, posY);
   }
 
+  /// Pose of [bodyId] from the last completed asynchronous batch, for reads
+  /// while [isStepping]. Null when no batch is in flight (read the world, which
+  /// is then at least as current) or the body is newer than the batch.
+  static BodyTransform? bodyTransform(WorldId world, BodyId bodyId) {
+    if (!isStepping(world)) return null;
+    final buffer = FlashNativeParticles.getBodyTransforms?.call(world);
+    if (buffer == null || buffer == nullptr || bodyId >= buffer.ref.count) return null;
+    return (buffer.ref.transforms + bodyId).ref;
+  }
+
   // Helper to access body struct safely via ID
   static Pointer<NativeBody> _getBodyPtr(WorldId world, BodyId bodyId) {
     return world.ref.bodies + bodyId;
@@ -165,6 +355,14 @@ class FPhysicsSystem {
     return _getBodyPtr(world, bodyId).ref.rotation;
   }
 
+  static void setSensor(WorldId world, BodyId bodyId, bool isSensor) {
+    _getBodyPtr(world, bodyId).ref.isSensor = isSensor ? 1 : 0;
+  }
+
+  static bool isSensor(WorldId world, BodyId bodyId) {
+    return _getBodyPtr(world, bodyId).ref.isSensor != 0;
+  }
+
   static int getCollisionCount(WorldId world, BodyId bodyId) {
     return _getBodyPtr(world, bodyId).ref.collisionCount;
   }
@@ -193,6 +391,239 @@ class FPhysicsSystem {
     return null;
   }
 
+  // --- Spatial Queries (native broadphase tree) ---
+
+  /// Maximum number of body IDs a single (non-batched) query call can return.
+  static const int maxQueryResults = 1024;
+
+  // Reused native buffers (allocated once, never freed)
+  static final Pointer<Int32> _queryResults = calloc<Int32>(maxQueryResults);
+  static Pointer<Int32> _batchResults = nullptr;
+  static int _batchResultCapacity = 0;
+  static Pointer<Int32> _batchCounts = nullptr;
+  static int _batchCountCapacity = 0;
+  static Pointer<Float> _queryInput = nullptr;
+  static int _queryInputCapacity = 0;
+
+  static Pointer<Float> _ensureQueryInput(int floatCount) {
+    if (floatCount > _queryInputCapacity) {
+      if (_queryInput != nullptr) calloc.free(_queryInput);
+      _queryInputCapacity = floatCount;
+      _queryInput = calloc<Float>(floatCount);
+    }
+    return _queryInput;
+  }
+
+  static List<BodyId> _readQueryResults(int count) {
+    return List<BodyId>.generate(count, (i) => _queryResults[i]);
+  }
+
+  // Runs a native batch query into the batch buffers. A batch that fills the
+  // results buffer may have cut later queries short (the native side can't
+  // tell), so the buffer is doubled and the batch run again until it fits.
+  static List<List<BodyId>> _runBatch(
+    int queryCount,
+    int Function(Pointer<Int32> results, int maxResults, Pointer<Int32> counts) query,
+  ) {
+    if (queryCount > _batchCountCapacity) {
+      if (_batchCounts != nullptr) calloc.free(_batchCounts);
+      _batchCountCapacity = queryCount;
+      _batchCounts = calloc<Int32>(queryCount);
+    }
+    if (_batchResults == nullptr) {
+      _batchResultCapacity = maxQueryResults;
+      _batchResults = calloc<Int32>(_batchResultCapacity);
+    }
+    while (query(_batchResults, _batchResultCapacity, _batchCounts) >= _batchResultCapacity) {
+      calloc.free(_batchResults);
+      _batchResultCapacity *= 2;
+      _batchResults = calloc<Int32>(_batchResultCapacity);
+    }
+
+    final results = <List<BodyId>>[];
+    int offset = 0;
+    for (int i = 0; i < queryCount; i++) {
+      final count = _batchCounts[i];
+      results.add(List<BodyId>.generate(count, (j) => _batchResults[offset + j]));
+      offset += count;
+    }
+    return results;
+  }
+
+  /// Bodies overlapping an axis-aligned rectangle (world coordinates, Y-Up).
+  static List<BodyId> queryAabb(
+    WorldId world,
+    double minX,
+    double minY,
+    double maxX,
+    double maxY, {
+    int categoryBits = FCollisionLayer.all,
+    int maskBits = FCollisionLayer.all,
+  }) {
+    final query = FlashNativeParticles.queryAabb;
+    if (query == null) return const [];
+    final count = query(world, minX, minY, maxX, maxY, categoryBits, maskBits, _queryResults, maxQueryResults);
+    return _readQueryResults(count);
+  }
+
+  /// Bodies containing a point (e.g. mouse/touch picking).
+  static List<BodyId> queryPoint(
+    WorldId world,
+    double x,
+    double y, {
+    int categoryBits = FCollisionLayer.all,
+    int maskBits = FCollisionLayer.all,
+  }) {
+    final query = FlashNativeParticles.queryPoint;
+    if (query == null) return const [];
+    final count = query(world, x, y, categoryBits, maskBits, _queryResults, maxQueryResults);
+    return _readQueryResults(count);
+  }
+
+  /// Bodies overlapping a circle (e.g. explosion radius).
+  static List<BodyId> overlapCircle(
+    WorldId world,
+    double x,
+    double y,
+    double radius, {
+    int categoryBits = FCollisionLayer.all,
+    int maskBits = FCollisionLayer.all,
+  }) {
+    final query = FlashNativeParticles.overlapShape;
+    if (query == null) return const [];
+    final d = radius * 2;
+    final count = query(world, FPhysics.circle, x, y, d, d, 0, categoryBits, maskBits, _queryResults, maxQueryResults);
+    return _readQueryResults(count);
+  }
+
+  /// Bodies overlapping an oriented box (e.g. trigger zones).
+  static List<BodyId> overlapBox(
+    WorldId world,
+    double x,
+    double y,
+    double width,
+    double height, {
+    double rotation = 0,
+    int categoryBits = FCollisionLayer.all,
+    int maskBits = FCollisionLayer.all,
+  }) {
+    final query = FlashNativeParticles.overlapShape;
+    if (query == null) return const [];
+    final count = query(
+      world,
+      FPhysics.box,
+      x,
+      y,
+      width,
+      height,
+      rotation,
+      categoryBits,
+      maskBits,
+      _queryResults,
+      maxQueryResults,
+    );
+    return _readQueryResults(count);
+  }
+
+  /// Batched [queryAabb]: one FFI call for many rectangles (more if the
+  /// results outgrow the buffer, which then grows; nothing is cut off).
+  /// Each Rect is read as (left = minX, top = minY, right = maxX, bottom = maxY).
+  static List<List<BodyId>> queryAabbBatch(
+    WorldId world,
+    List<Rect> boxes, {
+    int categoryBits = FCollisionLayer.all,
+    int maskBits = FCollisionLayer.all,
+  }) {
+    final query = FlashNativeParticles.queryAabbBatch;
+    if (query == null || boxes.isEmpty) return const [];
+    final queryCount = boxes.length;
+    final input = _ensureQueryInput(queryCount * 4);
+    for (int i = 0; i < queryCount; i++) {
+      final r = boxes[i];
+      input[i * 4] = r.left;
+      input[i * 4 + 1] = r.top;
+      input[i * 4 + 2] = r.right;
+      input[i * 4 + 3] = r.bottom;
+    }
+    return _runBatch(
+      queryCount,
+      (results, maxResults, counts) =>
+          query(world, input, queryCount, categoryBits, maskBits, results, maxResults, counts),
+    );
+  }
+
+  /// Batched [queryPoint]: one FFI call for many points (see [queryAabbBatch]).
+  static List<List<BodyId>> queryPointBatch(
+    WorldId world,
+    List<Offset> points, {
+    int categoryBits = FCollisionLayer.all,
+    int maskBits = FCollisionLayer.all,
+  }) {
+    final query = FlashNativeParticles.queryPointBatch;
+    if (query == null || points.isEmpty) return const [];
+    final queryCount = points.length;
+    final input = _ensureQueryInput(queryCount * 2);
+    for (int i = 0; i < queryCount; i++) {
+      input[i * 2] = points[i].dx;
+      input[i * 2 + 1] = points[i].dy;
+    }
+    return _runBatch(
+      queryCount,
+      (results, maxResults, counts) =>
+          query(world, input, queryCount, categoryBits, maskBits, results, maxResults, counts),
+    );
+  }
+
+  /// Batched [overlapCircle]: one FFI call for many circles of the same radius
+  /// (see [queryAabbBatch]).
+  static List<List<BodyId>> overlapCircleBatch(
+    WorldId world,
+    List<Offset> centers,
+    double radius, {
+    int categoryBits = FCollisionLayer.all,
+    int maskBits = FCollisionLayer.all,
+  }) {
+    final query = FlashNativeParticles.overlapShapeBatch;
+    if (query == null || centers.isEmpty) return const [];
+    final queryCount = centers.length;
+    final input = _ensureQueryInput(queryCount * 5);
+    for (int i = 0; i < queryCount; i++) {
+      input[i * 5] = centers[i].dx;
+      input[i * 5 + 1] = centers[i].dy;
+      input[i * 5 + 2] = radius * 2;
+      input[i * 5 + 3] = radius * 2;
+      input[i * 5 + 4] = 0;
+    }
+    return _runBatch(
+      queryCount,
+      (results, maxResults, counts) =>
+          query(world, FPhysics.circle, input, queryCount, categoryBits, maskBits, results, maxResults, counts),
+    );
+  }
+
+  /// Sweep a circle or box along ([dx], [dy]) and return the first body it touches.
+  /// Circles use `min(width, height) / 2` as radius, like [createBody].
+  static ShapeCastHit? shapeCast(
+    WorldId world,
+    int shapeType,
+    double width,
+    double height,
+    double x,
+    double y,
+    double dx,
+    double dy, {
+    double rotation = 0,
+    int categoryBits = FCollisionLayer.all,
+    int maskBits = FCollisionLayer.all,
+    BodyId ignoreBodyId = -1,
+  }) {
+    final cast = FlashNativeParticles.shapeCast;
+    if (cast == null) return null;
+    final result = cast(world, shapeType, width, height, rotation, x, y, dx, dy, categoryBits, maskBits, ignoreBodyId);
+    if (result.hit != 0) return result;
+    return null;
+  }
+
   // --- Soft Body API ---
 
   static int createSoftBody(
@@ -234,6 +665,98 @@ class FPhysicsSystem {
   static void setSoftBodyParams(WorldId world, int sbId, double pressure, double stiffness) {
     FlashNativeParticles.setSoftBodyParams!(world, sbId, pressure, stiffness);
   }
+
+  // --- Determinism (lockstep netcode) ---
+
+  /// Whether the native core was built with FLASH_DETERMINISTIC (bit-identical on all platforms).
+  static bool get isDeterministic => (FlashNativeParticles.isPhysicsDeterministic?.call() ?? 0) != 0;
+
+  /// Hash of the simulated state. Exchange between peers after each step to detect desyncs.
+  static int hashState(WorldId world) => FlashNativeParticles.hashWorldState?.call(world) ?? 0;
+
+  // --- World Snapshots (rollback netcode) ---
+
+  // Reusable native scratch buffers (grown on demand)
+  static Pointer<Uint8> _snapshotA = nullptr;
+  static Pointer<Uint8> _snapshotB = nullptr;
+  static Pointer<Uint8> _snapshotOut = nullptr;
+  static int _snapshotACapacity = 0, _snapshotBCapacity = 0, _snapshotOutCapacity = 0;
+
+  static Pointer<Uint8> _copyToA(Uint8List data) {
+    if (data.length > _snapshotACapacity) {
+      if (_snapshotA != nullptr) calloc.free(_snapshotA);
+      _snapshotACapacity = data.length;
+      _snapshotA = calloc<Uint8>(data.length);
+    }
+    _snapshotA.asTypedList(data.length).setAll(0, data);
+    return _snapshotA;
+  }
+
+  static Pointer<Uint8> _copyToB(Uint8List data) {
+    if (data.length > _snapshotBCapacity) {
+      if (_snapshotB != nullptr) calloc.free(_snapshotB);
+      _snapshotBCapacity = data.length;
+      _snapshotB = calloc<Uint8>(data.length);
+    }
+    _snapshotB.asTypedList(data.length).setAll(0, data);
+    return _snapshotB;
+  }
+
+  static Pointer<Uint8> _ensureSnapshotOut(int size) {
+    if (size > _snapshotOutCapacity) {
+      if (_snapshotOut != nullptr) calloc.free(_snapshotOut);
+      _snapshotOutCapacity = size;
+      _snapshotOut = calloc<Uint8>(size);
+    }
+    return _snapshotOut;
+  }
+
+  /// Capture the complete simulation state. The bytes are self-contained and can be
+  /// kept in a rollback ring or sent over the network.
+  static Uint8List? saveSnapshot(WorldId world) {
+    final getSize = FlashNativeParticles.getSnapshotSize;
+    final snapshot = FlashNativeParticles.snapshotWorld;
+    if (getSize == null || snapshot == null) return null;
+
+    final size = getSize(world);
+    final buffer = _ensureSnapshotOut(size);
+    final written = snapshot(world, buffer, size);
+    if (written == 0) return null;
+    return Uint8List.fromList(buffer.asTypedList(written));
+  }
+
+  /// Restore a state captured by [saveSnapshot] on the same world.
+  static bool restoreSnapshot(WorldId world, Uint8List snapshot) {
+    final restore = FlashNativeParticles.restoreWorld;
+    if (restore == null) return false;
+    return restore(world, _copyToA(snapshot), snapshot.length) != 0;
+  }
+
+  /// Encode [current] as a delta against [base] (only changed words are stored).
+  static Uint8List? snapshotDelta(Uint8List base, Uint8List current) {
+    final encode = FlashNativeParticles.snapshotDelta;
+    if (encode == null) return null;
+
+    // Worst case: every other word changed
+    final capacity = current.length * 2 + 64;
+    final out = _ensureSnapshotOut(capacity);
+    final size = encode(_copyToA(base), base.length, _copyToB(current), current.length, out, capacity);
+    if (size == 0) return null;
+    return Uint8List.fromList(out.asTypedList(size));
+  }
+
+  /// Rebuild a full snapshot from [base] and a delta made by [snapshotDelta].
+  static Uint8List? applySnapshotDelta(Uint8List base, Uint8List delta) {
+    final decode = FlashNativeParticles.applySnapshotDelta;
+    if (decode == null || delta.length < 8) return null;
+
+    // Delta header: magic, snapshot size
+    final snapshotSize = ByteData.sublistView(delta).getUint32(4, Endian.host);
+    final out = _ensureSnapshotOut(snapshotSize);
+    final size = decode(_copyToA(base), base.length, _copyToB(delta), delta.length, out, snapshotSize);
+    if (size == 0) return null;
+    return Uint8List.fromList(out.asTypedList(size));
+  }
 }
 
 class FPhysics {
@@ -254,6 +777,83 @@ class FPhysics {
   static const int box = 1;
 }
 
+/// Timings (milliseconds) and counters of one physics step.
+class FPhysicsProfile {
+  final double softBodies;
+  final double broadphase;
+  final double pairs;
+  final double narrowphase;
+  final double warmStart;
+  final double velocitySolve;
+  final double integrate;
+  final double positionSolve;
+  final double total;
+
+  final int pairCount;
+  final int constraintCount;
+  final int awakeBodyCount;
+  final int treeHeight;
+
+  FPhysicsProfile._fromNative(PhysicsProfile p)
+    : softBodies = p.softBodies,
+      broadphase = p.broadphase,
+      pairs = p.pairs,
+      narrowphase = p.narrowphase,
+      warmStart = p.warmStart,
+      velocitySolve = p.velocitySolve,
+      integrate = p.integrate,
+      positionSolve = p.positionSolve,
+      total = p.total,
+      pairCount = p.pairCount,
+      constraintCount = p.constraintCount,
+      awakeBodyCount = p.awakeBodyCount,
+      treeHeight = p.treeHeight;
+
+  /// Phase timings in solver order, for display.
+  Map<String, double> get phases => {
+    'Soft bodies': softBodies,
+    'Broadphase': broadphase,
+    'Pairs': pairs,
+    'Narrowphase': narrowphase,
+    'Warm start': warmStart,
+    'Velocity': velocitySolve,
+    'Integrate': integrate,
+    'Position': positionSolve,
+  };
+}
+
+/// A contact or sensor event reported by the native solver.
+class FContactEvent {
+  // Event types (Must match C++ ContactEventType)
+  static const int begin = 0;
+  static const int end = 1;
+  static const int hit = 2;
+  static const int sensorBegin = 3;
+  static const int sensorEnd = 4;
+
+  final int type;
+
+  /// For sensor events this is the sensor body.
+  final BodyId bodyA;
+  final BodyId bodyB;
+
+  /// Contact point and normal (A to B). Zero for end events.
+  final Offset point;
+  final Offset normal;
+
+  /// Relative normal speed when the bodies started touching.
+  final double approachSpeed;
+
+  const FContactEvent({
+    required this.type,
+    required this.bodyA,
+    required this.bodyB,
+    required this.point,
+    required this.normal,
+    required this.approachSpeed,
+  });
+}
+
 class FPhysicsBody extends FNode {
   final double width;
   final double height;
@@ -273,6 +873,18 @@ class FPhysicsBody extends FNode {
   /// Emitted on every physics update
   final FSignal<FPhysicsBody> physicsProcess = FSignal();
 
+  /// Emitted when this body starts touching another body (payload: the other body)
+  final FSignal<FPhysicsBody> contactBegin = FSignal();
+
+  /// Emitted when this body stops touching another body
+  final FSignal<FPhysicsBody> contactEnd = FSignal();
+
+  /// Sensor only: emitted when a body enters this sensor
+  final FSignal<FPhysicsBody> bodyEntered = FSignal();
+
+  /// Sensor only: emitted when a body leaves this sensor
+  final FSignal<FPhysicsBody> bodyExited = FSignal();
+
   // Temporary buffers to avoid allocation in sync
   static final Pointer<Float> _posX = calloc<Float>();
   static final Pointer<Float> _posY = calloc<Float>();
@@ -311,9 +923,14 @@ class FPhysicsBody extends FNode {
        ) {
     this.restitution = restitution;
     this.friction = friction;
+    FPhysicsSystem._registerBody(this);
     _syncFromPhysics();
   }
 
+  /// Sensors report overlaps through [bodyEntered]/[bodyExited] but never collide.
+  bool get isSensor => FPhysicsSystem.isSensor(_world, bodyId);
+  set isSensor(bool value) => FPhysicsSystem.setSensor(_world, bodyId, value);
+
   /// Get/Set Collision Category Bits
   int get categoryBits => FPhysicsSystem.getCategoryBits(_world, bodyId);
   set categoryBits(int value) => FPhysicsSystem.setCategoryBits(_world, bodyId, value);
@@ -372,22 +989,44 @@ class FPhysicsBody extends FNode {
   }
 
   void _syncFromPhysics() {
-    FPhysicsSystem.getBodyPosition(_world, bodyId, _posX, _posY);
-    final rot = FPhysicsSystem.getRotation(_world, bodyId);
+    double x, y, rot;
+    int collisionCount;
+    if (FPhysicsSystem.isStepping(_world)) {
+      // The physics thread owns the world: use the published pose, or keep
+      // the last one for bodies newer than the batch
+      final published = FPhysicsSystem.bodyTransform(_world, bodyId);
+      if (published == null) return;
+      x = published.x;
+      y = published.y;
+      rot = published.rotation;
+      collisionCount = published.collisionCount;
+    } else {
+      FPhysicsSystem.getBodyPosition(_world, bodyId, _posX, _posY);
+      x = _posX.value;
+      y = _posY.value;
+      rot = FPhysicsSystem.getRotation(_world, bodyId);
+      collisionCount = FPhysicsSystem.getCollisionCount(_world, bodyId);
+    }
 
-    if (_posX.value.isNaN || _posY.value.isNaN || rot.isNaN) {
+    if (x.isNaN || y.isNaN || rot.isNaN) {
       return;
     }
 
-    transform.position = v.Vector3(_posX.value, _posY.value, 0);
+    transform.position = v.Vector3(x, y, 0);
     transform.rotation = v.Vector3(0, 0, rot);
 
     // Check for collisions (feedback from native core)
-    if (FPhysicsSystem.getCollisionCount(_world, bodyId) > 0) {
+    if (collisionCount > 0) {
       collision.emit(this);
     }
   }
 
+  @override
+  void dispose() {
+    FPhysicsSystem._unregisterBody(this);
+    super.dispose();
+  }
+
   @override
   Rect? get bounds {
     // If shape is circle, we still return a square bounding box for culling.
@@ -469,6 +1108,65 @@ class FSoftBody extends FNode {
   }
 }
 
+/// Kinematic character controller (native collide-and-slide).
+///
+/// Moves a circle or box through the world and slides along walls and slopes
+/// instead of stopping at them. If [body] is given, the body is teleported along.
+class FCharacterController {
+  final WorldId world;
+  final Pointer<CharacterController> _native;
+
+  FCharacterController({
+    required this.world,
+    int shapeType = FPhysics.box,
+    double width = 40,
+    double height = 60,
+    double x = 0,
+    double y = 0,
+    BodyId body = -1,
+    double skinWidth = 0.5,
+    double maxSlopeRadians = 0.8,
+    int maxIterations = 4,
+    int categoryBits = 0x0001,
+    int maskBits = 0xFFFF,
+  }) : _native = calloc<CharacterController>() {
+    FlashNativeParticles.initCharacterController?.call(_native, shapeType, width, height, x, y);
+    final c = _native.ref;
+    c.bodyId = body;
+    c.skinWidth = skinWidth;
+    c.minGroundNormalY = cos(maxSlopeRadians);
+    c.maxIterations = maxIterations;
+    c.categoryBits = categoryBits;
+    c.maskBits = maskBits;
+  }
+
+  double get x => _native.ref.x;
+  double get y => _native.ref.y;
+
+  /// Teleport without collision checks.
+  void setPosition(double x, double y) {
+    _native.ref.x = x;
+    _native.ref.y = y;
+  }
+
+  /// Whether the last [move] ended standing on a walkable surface.
+  bool get isOnGround => _native.ref.onGround != 0;
+  Offset get groundNormal => Offset(_native.ref.groundNormalX, _native.ref.groundNormalY);
+  BodyId get groundBody => _native.ref.groundBodyId;
+
+  /// Number of surfaces touched during the last [move].
+  int get hitCount => _native.ref.hitCount;
+
+  /// Move by ([dx], [dy]) in world units (Y-Up), sliding along obstacles.
+  void move(double dx, double dy) {
+    FlashNativeParticles.characterMove?.call(world, _native, dx, dy);
+  }
+
+  void dispose() {
+    calloc.free(_native);
+  }
+}
+
 /// Helper class for defining collision layers (Legacy/UI compatibility)
 class FCollisionLayer {
   static const int none = 0x0000;
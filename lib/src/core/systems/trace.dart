@@ -0,0 +1,51 @@
+import 'package:ffi/ffi.dart';
+import '../native/particles_ffi.dart';
+
+/// Timeline tracing of the native core (physics, particles, scene transforms).
+///
+/// Requires a native library built with `FLASH_ENABLE_TRACE=1`; otherwise every
+/// call is a no-op and [dump] returns -1. The output is Chrome trace JSON that
+/// opens in Perfetto (ui.perfetto.dev) or chrome://tracing, next to a Flutter
+/// timeline exported from DevTools.
+///
+/// Example:
+/// ```dart
+/// FNativeTrace.begin();
+/// await Future.delayed(const Duration(seconds: 2));
+/// FNativeTrace.end();
+/// FNativeTrace.dump('${dir.path}/flash_trace.json');
+/// ```
+class FNativeTrace {
+  FNativeTrace._();
+
+  /// Start recording (previous events are discarded). Also names the calling
+  /// thread, which is the thread the engine steps physics on.
+  static void begin({String threadName = 'ui'}) {
+    FlashNativeParticles.init();
+    FlashNativeParticles.traceBegin?.call();
+    final setName = FlashNativeParticles.traceSetThreadName;
+    if (setName == null) return;
+    final name = threadName.toNativeUtf8();
+    try {
+      setName(name);
+    } finally {
+      malloc.free(name);
+    }
+  }
+
+  /// Stop recording.
+  static void end() => FlashNativeParticles.traceEnd?.call();
+
+  /// Write the recorded events as Chrome trace JSON. Returns the number of
+  /// events written, or -1 if tracing is compiled out or the file failed.
+  static int dump(String path) {
+    final dumpJson = FlashNativeParticles.traceDumpJson;
+    if (dumpJson == null) return -1;
+    final nativePath = path.toNativeUtf8();
+    try {
+      return dumpJson(nativePath);
+    } finally {
+      malloc.free(nativePath);
+    }
+  }
+}
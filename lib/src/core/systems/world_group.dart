@@ -0,0 +1,52 @@
+import 'dart:ffi';
+
+import '../native/particles_ffi.dart';
+import 'physics.dart';
+
+/// Steps many independent physics worlds in one native call.
+///
+/// Meant for headless use such as server-side match validation: the worlds
+/// are spread across the native job pool (see [FNativeJobs]), so one process
+/// uses every core. Each world keeps its own scratch memory, and the result
+/// is identical to stepping each world on its own.
+///
+/// The group does not own its worlds; dispose them separately.
+///
+/// Example:
+/// ```dart
+/// final group = FPhysicsWorldGroup(capacity: 256);
+/// for (final match in matches) {
+///   group.add(match.world);
+/// }
+/// group.step(1 / 120, steps: 120); // One second of every match
+/// ```
+class FPhysicsWorldGroup {
+  final Pointer<WorldGroup> _native;
+
+  FPhysicsWorldGroup({int capacity = 64}) : _native = _create(capacity);
+
+  static Pointer<WorldGroup> _create(int capacity) {
+    FlashNativeParticles.init();
+    final create = FlashNativeParticles.createWorldGroup;
+    if (create == null) {
+      throw UnsupportedError('Native world group functions not initialized.');
+    }
+    return create(capacity);
+  }
+
+  /// Number of worlds in the group
+  int get length => _native.ref.count;
+
+  /// Add a world. Returns false if the group is full.
+  bool add(WorldId world) => FlashNativeParticles.worldGroupAdd!(_native, world) >= 0;
+
+  /// Add the world of a physics system. Returns false if the group is full.
+  bool addSystem(FPhysicsSystem system) => add(system.world);
+
+  void remove(WorldId world) => FlashNativeParticles.worldGroupRemove!(_native, world);
+
+  /// Run [steps] fixed steps of [dt] on every world; returns when all are done.
+  void step(double dt, {int steps = 1}) => FlashNativeParticles.stepWorldGroup!(_native, dt, steps);
+
+  void dispose() => FlashNativeParticles.destroyWorldGroup!(_native);
+}
@@ -2,8 +2,8 @@ import 'package:flutter/material.dart';
 import '../../core/systems/physics.dart';
 import '../framework.dart';
 
-/// An area that detects collisions with other bodies.
-/// Currently simplified to circular areas in the native core.
+/// An area that detects bodies entering and leaving it.
+/// Backed by a native sensor body: overlaps are reported but never collide.
 class FArea extends FNodeWidget {
   final int shapeType;
   final double width;
@@ -57,7 +57,12 @@ class _FAreaState extends FNodeWidgetState<FArea, FPhysicsBody> {
       name: widget.name ?? 'Area',
     );
 
-    // TODO: Implement native collision callbacks for sensors
+    node.isSensor = true;
+    node.bodyEntered.connect(_onBodyEntered);
+    node.bodyExited.connect(_onBodyExited);
     return node;
   }
+
+  void _onBodyEntered(FPhysicsBody body) => widget.onCollisionStart?.call(body);
+  void _onBodyExited(FPhysicsBody body) => widget.onCollisionEnd?.call(body);
 }
@@ -0,0 +1,147 @@
+import 'dart:async';
+
+import 'package:flutter/material.dart';
+import '../../core/systems/physics.dart';
+import '../framework.dart';
+
+/// Debug overlay showing where the native physics step spends its time.
+///
+/// Enables step profiling while mounted and draws smoothed per-phase timings
+/// plus solver counters. Use it to tune `velocityIterations` and `contactHertz`
+/// per device tier.
+///
+/// Example:
+/// ```dart
+/// Positioned(
+///   top: 8,
+///   left: 8,
+///   child: FPhysicsProfileOverlay(physics: engine.physicsWorld),
+/// )
+/// ```
+class FPhysicsProfileOverlay extends StatefulWidget {
+  /// Physics system to profile. Defaults to the physics world of the enclosing engine.
+  final FPhysicsSystem? physics;
+
+  /// How often the overlay refreshes
+  final Duration refreshInterval;
+
+  /// Step time (ms) that fills a bar completely
+  final double budgetMs;
+
+  /// Background color
+  final Color backgroundColor;
+
+  const FPhysicsProfileOverlay({
+    super.key,
+    this.physics,
+    this.refreshInterval = const Duration(milliseconds: 250),
+    this.budgetMs = 2.0,
+    this.backgroundColor = Colors.black54,
+  });
+
+  @override
+  State<FPhysicsProfileOverlay> createState() => _FPhysicsProfileOverlayState();
+}
+
+class _FPhysicsProfileOverlayState extends State<FPhysicsProfileOverlay> {
+  Timer? _timer;
+  FPhysicsSystem? _physics;
+  FPhysicsProfile? _profile;
+  final Map<String, double> _smoothed = {};
+  double _smoothedTotal = 0;
+
+  @override
+  void initState() {
+    super.initState();
+    _timer = Timer.periodic(widget.refreshInterval, (_) => _sample());
+  }
+
+  FPhysicsSystem? get _target {
+    if (widget.physics != null) return widget.physics;
+    final element = context.getElementForInheritedWidgetOfExactType<InheritedFNode>();
+    return (element?.widget as InheritedFNode?)?.engine.physicsWorld;
+  }
+
+  void _sample() {
+    final physics = _target;
+    if (physics != _physics) {
+      _physics?.profilingEnabled = false;
+      physics?.profilingEnabled = true;
+      _physics = physics;
+    }
+
+    final profile = physics?.profile;
+    if (profile == null) return;
+
+    // Exponential smoothing keeps the numbers readable
+    const k = 0.3;
+    profile.phases.forEach((name, ms) {
+      _smoothed[name] = (_smoothed[name] ?? ms) * (1 - k) + ms * k;
+    });
+    _smoothedTotal = _smoothedTotal * (1 - k) + profile.total * k;
+    setState(() => _profile = profile);
+  }
+
+  @override
+  void dispose() {
+    _timer?.cancel();
+    _physics?.profilingEnabled = false;
+    super.dispose();
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final profile = _profile;
+    const labelStyle = TextStyle(color: Colors.white70, fontSize: 10);
+
+    return Container(
+      width: 220,
+      padding: const EdgeInsets.all(8),
+      decoration: BoxDecoration(color: widget.backgroundColor, borderRadius: BorderRadius.circular(8)),
+      child: profile == null
+          ? const Text('Physics profile: waiting…', style: labelStyle)
+          : Column(
+              crossAxisAlignment: CrossAxisAlignment.start,
+              mainAxisSize: MainAxisSize.min,
+              children: [
+                Text(
+                  'Step ${_smoothedTotal.toStringAsFixed(3)} ms × ${_physics?.stepsLastUpdate ?? 0}',
+                  style: const TextStyle(color: Colors.white, fontSize: 12, fontWeight: FontWeight.bold),
+                ),
+                const SizedBox(height: 4),
+                for (final entry in _smoothed.entries) _buildBar(entry.key, entry.value, labelStyle),
+                const SizedBox(height: 4),
+                Text(
+                  'pairs ${profile.pairCount}  contacts ${profile.constraintCount}  '
+                  'awake ${profile.awakeBodyCount}  tree ${profile.treeHeight}',
+                  style: labelStyle,
+                ),
+              ],
+            ),
+    );
+  }
+
+  Widget _buildBar(String name, double ms, TextStyle style) {
+    final fraction = (ms / widget.budgetMs).clamp(0.0, 1.0);
+    return Padding(
+      padding: const EdgeInsets.symmetric(vertical: 1),
+      child: Row(
+        children: [
+          SizedBox(width: 70, child: Text(name, style: style)),
+          Expanded(
+            child: LinearProgressIndicator(
+              value: fraction,
+              minHeight: 6,
+              backgroundColor: Colors.white10,
+              color: Color.lerp(Colors.greenAccent, Colors.redAccent, fraction),
+            ),
+          ),
+          SizedBox(
+            width: 48,
+            child: Text(ms.toStringAsFixed(3), textAlign: TextAlign.right, style: style),
+          ),
+        ],
+      ),
+    );
+  }
+}
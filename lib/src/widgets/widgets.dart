@@ -18,6 +18,7 @@ export 'ui/combo_display.dart';
 export 'ui/hud.dart';
 export 'ui/game_overlays.dart';
 export 'ui/grid_items.dart';
+export 'ui/physics_profile_overlay.dart';
 export 'rendering/line_renderer.dart';
 export 'rendering/trail_renderer.dart';
 
@@ -0,0 +1,54 @@
+#!/bin/bash
+
+# Builds and runs the headless native benchmark (Linux / macOS host).
+#
+#   ./scripts/build_benchmark.sh                      # build + run all scenes
+#   ./scripts/build_benchmark.sh --json results.json  # arguments go to flash_benchmark
+#   FLASH_DETERMINISTIC=1 ./scripts/build_benchmark.sh
+#
+# Uses the same optimization flags as build_native.sh so numbers match the shipped library.
+
+SOURCE_DIR="src/native"
+OUTPUT_DIR="build"
+BIN="$OUTPUT_DIR/flash_benchmark"
+CPP_FLAGS="-O3 -ffast-math -flto -std=c++11"
+CXX="${CXX:-c++}"
+
+if [ "$FLASH_DETERMINISTIC" = "1" ]; then
+    CPP_FLAGS="-O3 -fno-fast-math -ffp-contract=off -flto -std=c++11 -DFLASH_DETERMINISTIC"
+    echo "Deterministic physics build enabled"
+fi
+
+if [ "$FLASH_ENABLE_TRACE" = "1" ]; then
+    CPP_FLAGS="$CPP_FLAGS -DFLASH_ENABLE_TRACE"
+    echo "Native tracing enabled"
+fi
+
+mkdir -p "$OUTPUT_DIR"
+
+echo "Compiling native benchmark..."
+$CXX $CPP_FLAGS -pthread \
+    "$SOURCE_DIR/benchmark.cpp" \
+    "$SOURCE_DIR/particles.cpp" \
+    "$SOURCE_DIR/particles_async.cpp" \
+    "$SOURCE_DIR/physics.cpp" \
+    "$SOURCE_DIR/broadphase.cpp" \
+    "$SOURCE_DIR/joints.cpp" \
+    "$SOURCE_DIR/nodes.cpp" \
+    "$SOURCE_DIR/queries.cpp" \
+    "$SOURCE_DIR/character.cpp" \
+    "$SOURCE_DIR/events.cpp" \
+    "$SOURCE_DIR/snapshot.cpp" \
+    "$SOURCE_DIR/trace.cpp" \
+    "$SOURCE_DIR/jobs.cpp" \
+    "$SOURCE_DIR/physics_async.cpp" \
+    "$SOURCE_DIR/world_group.cpp" \
+    -o "$BIN"
+
+if [ $? -ne 0 ]; then
+    echo "Compilation failed!"
+    exit 1
+fi
+
+# Creation logs go to stderr; keep the report readable
+"$BIN" "$@" 2> >(grep -v '^DEBUG' >&2)
@@ -6,6 +6,21 @@ OUTPUT_DIR="lib/src/core/native/bin"
 LIB_NAME="libflash_core.dylib"
 CPP_FLAGS="-O3 -ffast-math -flto -std=c++11"
 
+# Lockstep builds: FLASH_DETERMINISTIC=1 ./scripts/build_native.sh
+# Strict IEEE float math (no fast-math, no FMA contraction) and portable trig,
+# so arm64 and x86_64 builds simulate bit-identically.
+if [ "$FLASH_DETERMINISTIC" = "1" ]; then
+    CPP_FLAGS="-O3 -fno-fast-math -ffp-contract=off -flto -std=c++11 -DFLASH_DETERMINISTIC"
+    echo "Deterministic physics build enabled"
+fi
+
+# Timeline tracing: FLASH_ENABLE_TRACE=1 ./scripts/build_native.sh
+# Compiles in FLASH_TRACE_ZONE instrumentation (see src/native/trace.h).
+if [ "$FLASH_ENABLE_TRACE" = "1" ]; then
+    CPP_FLAGS="$CPP_FLAGS -DFLASH_ENABLE_TRACE"
+    echo "Native tracing enabled"
+fi
+
 # Clean output directory
 rm -rf "$OUTPUT_DIR"
 mkdir -p "$OUTPUT_DIR"
@@ -21,10 +36,19 @@ clang++ -shared -fPIC \
     -target arm64-apple-ios14.0-simulator \
     -isysroot "$SDK_PATH" \
     "$SOURCE_DIR/particles.cpp" \
+    "$SOURCE_DIR/particles_async.cpp" \
     "$SOURCE_DIR/physics.cpp" \
     "$SOURCE_DIR/broadphase.cpp" \
     "$SOURCE_DIR/joints.cpp" \
     "$SOURCE_DIR/nodes.cpp" \
+    "$SOURCE_DIR/queries.cpp" \
+    "$SOURCE_DIR/character.cpp" \
+    "$SOURCE_DIR/events.cpp" \
+    "$SOURCE_DIR/snapshot.cpp" \
+    "$SOURCE_DIR/trace.cpp" \
+    "$SOURCE_DIR/jobs.cpp" \
+    "$SOURCE_DIR/physics_async.cpp" \
+    "$SOURCE_DIR/world_group.cpp" \
     -o "$OUTPUT_DIR/libflash_core_sim.dylib"
 
 echo "Compiling native core library (Particles + Physics) for macOS Host..."
@@ -33,10 +57,19 @@ clang++ -shared -fPIC \
     $CPP_FLAGS \
     -std=c++11 \
     "$SOURCE_DIR/particles.cpp" \
+    "$SOURCE_DIR/particles_async.cpp" \
     "$SOURCE_DIR/physics.cpp" \
     "$SOURCE_DIR/broadphase.cpp" \
     "$SOURCE_DIR/joints.cpp" \
     "$SOURCE_DIR/nodes.cpp" \
+    "$SOURCE_DIR/queries.cpp" \
+    "$SOURCE_DIR/character.cpp" \
+    "$SOURCE_DIR/events.cpp" \
+    "$SOURCE_DIR/snapshot.cpp" \
+    "$SOURCE_DIR/trace.cpp" \
+    "$SOURCE_DIR/jobs.cpp" \
+    "$SOURCE_DIR/physics_async.cpp" \
+    "$SOURCE_DIR/world_group.cpp" \
     -o "$OUTPUT_DIR/libflash_core.dylib"
 
 if [ $? -eq 0 ]; then
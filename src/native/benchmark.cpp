@@ -0,0 +1,655 @@
+// Headless benchmark suite for the native core.
+//
+// Runs a fixed set of standard scenes and reports ms/step percentiles and heap
+// allocations per step. Build and run with scripts/build_benchmark.sh:
+//
+//   ./scripts/build_benchmark.sh                       # all scenes, table output
+//   ./build/flash_benchmark --json results.json        # machine-readable output
+//   ./build/flash_benchmark --scene pyramid --steps 2000
+//
+// Compare the JSON of two builds to show that an optimization helps (or to
+// catch a regression). Allocation counts are only available on glibc, where
+// malloc/calloc/realloc are interposed below; elsewhere they report -1.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include "physics.h"
+#include "joints.h"
+#include "particles.h"
+#include "nodes.h"
+#include "world_group.h"
+
+// --- Allocation counting ---
+
+namespace {
+    std::atomic<uint64_t> g_allocCount(0);
+    std::atomic<uint64_t> g_allocBytes(0);
+}
+
+#if defined(__GLIBC__)
+#define FLASH_BENCH_COUNTS_ALLOCS 1
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+// operator new and std::vector go through malloc, so these see every heap allocation
+void* malloc(size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(count * size, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+
+}
+
+#else
+#define FLASH_BENCH_COUNTS_ALLOCS 0
+#endif
+
+// --- Scenes ---
+
+namespace {
+    const float kTimeStep = 1.0f / 120.0f; // Matches FPhysicsSystem's fixed step
+
+    struct BenchContext {
+        PhysicsWorld* world;
+        ParticleEmitter* emitter;
+        float* vertices;
+        uint32_t* colors;
+        EmitterShapeDef burstShape;
+        ForceField forceFields[4];
+        ParticleCollision particleCollision;
+        ParticleAtlas atlas;
+        float* uvs;
+        std::vector<ParticleEmitter*> emitters;
+        NativeScene* scene;
+        std::vector<int32_t> movers;
+        WorldGroup* group;
+        std::vector<PhysicsWorld*> groupWorlds;
+        int frame;
+    };
+
+    struct BenchScene {
+        const char* name;
+        const char* description;
+        void (*setup)(BenchContext& ctx);
+        void (*step)(BenchContext& ctx);
+    };
+
+    // Small deterministic LCG so every run builds identical scenes
+    uint32_t g_seed = 12345;
+    float random01() {
+        g_seed = g_seed * 1664525u + 1013904223u;
+        return (g_seed >> 8) * (1.0f / 16777216.0f);
+    }
+
+    void add_static_box(PhysicsWorld* world, float x, float y, float w, float h) {
+        create_body(world, STATIC, SHAPE_BOX, x, y, w, h, 0, 0x0001, 0xFFFF);
+    }
+
+    void step_world(BenchContext& ctx) {
+        step_physics(ctx.world, kTimeStep);
+    }
+
+    // 20-row box pyramid (210 boxes) on a static ground
+    void setup_pyramid(BenchContext& ctx) {
+        const int rows = 20;
+        const float size = 20.0f;
+        ctx.world = create_physics_world(256);
+        add_static_box(ctx.world, 0, -10, 2000, 20);
+        for (int row = 0; row < rows; ++row) {
+            int count = rows - row;
+            float startX = -(count - 1) * size * 0.5f;
+            for (int i = 0; i < count; ++i) {
+                create_body(ctx.world, DYNAMIC, SHAPE_BOX, startX + i * size, size * 0.5f + row * size,
+                            size, size, 0, 0x0001, 0xFFFF);
+            }
+        }
+    }
+
+    // 3000 circles dropped into a walled bin
+    void setup_circle_rain(BenchContext& ctx) {
+        const int count = 3000;
+        ctx.world = create_physics_world(count + 8);
+        add_static_box(ctx.world, 0, -10, 1000, 20);
+        add_static_box(ctx.world, -510, 500, 20, 1000);
+        add_static_box(ctx.world, 510, 500, 20, 1000);
+        for (int i = 0; i < count; ++i) {
+            float x = -480.0f + (i % 100) * 9.6f + random01() * 2.0f;
+            float y = 100.0f + (i / 100) * 12.0f;
+            create_body(ctx.world, DYNAMIC, SHAPE_CIRCLE, x, y, 8, 8, 0, 0x0001, 0xFFFF);
+        }
+    }
+
+    // 160x48 tile level (borders + platforms) with 300 bodies driven like characters
+    void setup_tilemap(BenchContext& ctx) {
+        const int cols = 160, rows = 48, moverCount = 300;
+        const float tile = 32.0f;
+        ctx.world = create_physics_world(cols * rows + moverCount);
+
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                bool border = r == 0 || c == 0 || c == cols - 1;
+                bool platform = r % 6 == 0 && (c + r * 3) % 20 < 12;
+                if (border || platform) {
+                    add_static_box(ctx.world, c * tile, r * tile, tile, tile);
+                }
+            }
+        }
+
+        for (int i = 0; i < moverCount; ++i) {
+            float x = tile * 2 + random01() * tile * (cols - 4);
+            float y = tile * (1 + (i % (rows / 6)) * 6) + tile * 2;
+            int shape = (i & 1) ? SHAPE_BOX : SHAPE_CIRCLE;
+            ctx.movers.push_back(create_body(ctx.world, DYNAMIC, shape, x, y, 20, 28, 0, 0x0002, 0xFFFF));
+        }
+    }
+
+    void step_tilemap(BenchContext& ctx) {
+        // Patrol left/right like platformer enemies, keep vertical velocity from gravity
+        for (size_t i = 0; i < ctx.movers.size(); ++i) {
+            NativeBody& body = ctx.world->bodies[ctx.movers[i]];
+            float dir = ((ctx.frame / 240 + (int)i) & 1) ? 1.0f : -1.0f;
+            set_body_velocity(ctx.world, ctx.movers[i], dir * 150.0f, body.vy);
+        }
+        step_world(ctx);
+    }
+
+    // 100 links connected by revolute joints, pinned to a static anchor and swinging
+    void setup_chain(BenchContext& ctx) {
+        const int links = 100;
+        const float linkLength = 10.0f;
+        ctx.world = create_physics_world(links + 1);
+        int32_t anchor = create_body(ctx.world, STATIC, SHAPE_BOX, 0, 1000, 10, 10, 0, 0x0001, 0x0000);
+
+        int32_t prev = anchor;
+        for (int i = 0; i < links; ++i) {
+            float x = (i + 0.5f) * linkLength;
+            // Links don't collide with each other (mask 0)
+            int32_t link = create_body(ctx.world, DYNAMIC, SHAPE_BOX, x, 1000, linkLength, 3, 0, 0x0002, 0x0000);
+
+            JointDef def;
+            memset(&def, 0, sizeof(def));
+            def.type = REVOLUTE_JOINT;
+            def.bodyA = prev;
+            def.bodyB = link;
+            def.anchorAx = prev == anchor ? 0.0f : linkLength * 0.5f;
+            def.anchorBx = -linkLength * 0.5f;
+            create_joint(ctx.world, &def);
+            prev = link;
+        }
+    }
+
+    // 48 pressure soft bodies (16 points each) piled into a bin of static boxes
+    void setup_soft_bodies(BenchContext& ctx) {
+        const int bodies = 48, points = 16;
+        const float radius = 20.0f;
+        ctx.world = create_physics_world(16);
+        add_static_box(ctx.world, 0, -10, 600, 20);
+        add_static_box(ctx.world, -310, 400, 20, 800);
+        add_static_box(ctx.world, 310, 400, 20, 800);
+
+        float xs[points], ys[points];
+        for (int b = 0; b < bodies; ++b) {
+            float cx = -200.0f + (b % 6) * 80.0f;
+            float cy = 60.0f + (b / 6) * 60.0f;
+            for (int i = 0; i < points; ++i) {
+                float angle = i * (2.0f * 3.14159265f / points);
+                xs[i] = cx + cosf(angle) * radius;
+                ys[i] = cy + sinf(angle) * radius;
+            }
+            create_soft_body(ctx.world, points, xs, ys, 1.0f, 0.8f);
+        }
+    }
+
+    // 1M particles through fill_vertex_buffer (identity camera, all visible)
+    void setup_particles(BenchContext& ctx) {
+        const int count = 1000000;
+        ctx.emitter = create_particle_emitter(count, 0);
+        for (int i = 0; i < count; ++i) {
+            spawn_particle(ctx.emitter, random01() * 1000.0f, random01() * 1000.0f, 0,
+                           random01() * 10.0f - 5.0f, random01() * 10.0f, 0,
+                           1000.0f, 0.002f, 0xFFFF8800u);
+        }
+        // Quads: 2 triangles, 6 vertices per particle
+        ctx.vertices = (float*)calloc((size_t)count * 12, sizeof(float));
+        ctx.colors = (uint32_t*)calloc((size_t)count * 6, sizeof(uint32_t));
+    }
+
+    // The 1M field with a screen covering a quarter of it (world-space weather)
+    void setup_culled_particles(BenchContext& ctx) {
+        setup_particles(ctx);
+        ctx.emitter->viewMaxX = 500.0f;
+        ctx.emitter->viewMaxY = 500.0f;
+    }
+
+    // 500k quads at random depths, drawn back to front
+    void setup_sorted_particles(BenchContext& ctx) {
+        const int count = 500000;
+        ctx.emitter = create_particle_emitter(count, 0);
+        ctx.emitter->sortMode = 1;
+        for (int i = 0; i < count; ++i) {
+            spawn_particle(ctx.emitter, random01() * 1000.0f, random01() * 1000.0f, random01() - 0.5f,
+                           0, 0, 0, 1000.0f, 0.002f, 0xFFFF8800u);
+        }
+        ctx.vertices = (float*)calloc((size_t)count * 12, sizeof(float));
+        ctx.colors = (uint32_t*)calloc((size_t)count * 6, sizeof(uint32_t));
+    }
+
+    // 500k 12-sided particles: 30 vertices each
+    void setup_round_particles(BenchContext& ctx) {
+        const int count = 500000;
+        ctx.emitter = create_particle_emitter(count, 3);
+        for (int i = 0; i < count; ++i) {
+            spawn_particle(ctx.emitter, random01() * 1000.0f, random01() * 1000.0f, 0,
+                           0, 0, 0, 1000.0f, 0.002f, 0xFFFF8800u);
+        }
+        ctx.vertices = (float*)calloc((size_t)count * 60, sizeof(float));
+        ctx.colors = (uint32_t*)calloc((size_t)count * 30, sizeof(uint32_t));
+    }
+
+    void step_particles(BenchContext& ctx) {
+        float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+        fill_vertex_buffer(ctx.emitter, identity, ctx.vertices, ctx.colors, ctx.emitter->maxParticles);
+    }
+
+    void spawn_fountain_particle(ParticleEmitter* emitter) {
+        spawn_particle(emitter, random01() * 1000.0f, 0, 0,
+                       random01() * 200.0f - 100.0f, random01() * 600.0f, 0,
+                       0.5f + random01() * 2.0f, 4.0f, 0xFF66CCFFu);
+    }
+
+    // 200k fountain particles with 0.5-2.5 s lifetimes; expired ones are respawned every frame
+    void setup_particle_update(BenchContext& ctx) {
+        const int count = 200000;
+        ctx.emitter = create_particle_emitter(count, 0);
+        ctx.emitter->gravityY = -981.0f;
+        for (int i = 0; i < count; ++i) spawn_fountain_particle(ctx.emitter);
+    }
+
+    void step_particle_update(BenchContext& ctx) {
+        update_particles(ctx.emitter, kTimeStep);
+        while (ctx.emitter->activeCount < ctx.emitter->maxParticles) spawn_fountain_particle(ctx.emitter);
+    }
+
+    // The update scene plus an attractor, a vortex, turbulence and a ground plane
+    void setup_particle_forces(BenchContext& ctx) {
+        setup_particle_update(ctx);
+        memset(ctx.forceFields, 0, sizeof(ctx.forceFields));
+        ctx.forceFields[0].type = FORCE_POINT;
+        ctx.forceFields[0].y = 300.0f;
+        ctx.forceFields[0].strength = 500.0f;
+        ctx.forceFields[1].type = FORCE_VORTEX;
+        ctx.forceFields[1].strength = 300.0f;
+        ctx.forceFields[1].radius = 400.0f;
+        ctx.forceFields[2].type = FORCE_TURBULENCE;
+        ctx.forceFields[2].strength = 200.0f;
+        ctx.forceFields[2].frequency = 0.01f;
+        ctx.forceFields[3].type = FORCE_PLANE;
+        ctx.forceFields[3].axisY = 1.0f;
+        ctx.forceFields[3].bounce = 0.3f;
+        ctx.emitter->forceFields = ctx.forceFields;
+        ctx.emitter->forceFieldCount = 4;
+    }
+
+    // The update scene raining onto a floor and 64 static platforms (bounce)
+    void setup_particle_collide(BenchContext& ctx) {
+        setup_particle_update(ctx);
+        ctx.world = create_physics_world(128);
+        add_static_box(ctx.world, 500.0f, -10.0f, 1200.0f, 20.0f);
+        for (int i = 0; i < 64; ++i) add_static_box(ctx.world, (i % 8) * 125.0f + 60.0f, (i / 8) * 40.0f + 20.0f, 50.0f, 8.0f);
+        memset(&ctx.particleCollision, 0, sizeof(ctx.particleCollision));
+        ctx.particleCollision.world = ctx.world;
+        ctx.particleCollision.categoryBits = 0xFFFF;
+        ctx.particleCollision.maskBits = 0xFFFF;
+        ctx.particleCollision.response = COLLIDE_BOUNCE;
+        ctx.particleCollision.bounce = 0.4f;
+        ctx.particleCollision.friction = 0.1f;
+        ctx.particleCollision.radius = 2.0f;
+        ctx.emitter->collision = &ctx.particleCollision;
+    }
+
+    // The update scene with 8-point trails, recorded every update and filled as ribbons
+    void setup_particle_trails(BenchContext& ctx) {
+        setup_particle_update(ctx);
+        set_particle_trails(ctx.emitter, 8, 0);
+        const int vertices = ctx.emitter->maxParticles * particle_trail_vertices(8);
+        ctx.vertices = (float*)calloc(vertices * 2, sizeof(float));
+        ctx.colors = (uint32_t*)calloc(vertices, sizeof(uint32_t));
+    }
+
+    void step_particle_trails(BenchContext& ctx) {
+        float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+        step_particle_update(ctx);
+        fill_trail_buffer(ctx.emitter, identity, ctx.vertices, ctx.colors, ctx.emitter->maxParticles);
+    }
+
+    // 40 small emitters (1000 indexed quads each), like a scene of torches and sparks
+    void setup_many_emitters(BenchContext& ctx) {
+        for (int e = 0; e < 40; ++e) {
+            ParticleEmitter* emitter = create_particle_emitter(1000, 0);
+            float cx = random01() * 1000.0f, cy = random01() * 1000.0f;
+            for (int i = 0; i < 1000; ++i) {
+                spawn_particle(emitter, cx + random01() * 50.0f, cy + random01() * 50.0f, 0, 0, 0, 0, 1000.0f, 0.004f, 0xFFFF8800u);
+            }
+            ctx.emitters.push_back(emitter);
+        }
+        ctx.vertices = (float*)calloc(40000 * 8, sizeof(float));
+        ctx.colors = (uint32_t*)calloc(40000 * 4, sizeof(uint32_t));
+    }
+
+    // One fill per emitter, each from the start of the buffers (the old painter loop)
+    void step_emitters_each(BenchContext& ctx) {
+        float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+        for (size_t e = 0; e < ctx.emitters.size(); ++e) {
+            fill_vertex_buffer_indexed(ctx.emitters[e], identity, ctx.vertices, ctx.colors, 40000);
+        }
+    }
+
+    void step_emitters_merged(BenchContext& ctx) {
+        float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+        fill_vertex_buffer_multi(ctx.emitters.data(), (int)ctx.emitters.size(), identity, ctx.vertices, ctx.colors, 40000, 1, NULL);
+    }
+
+    void step_particles_indexed(BenchContext& ctx) {
+        float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+        fill_vertex_buffer_indexed(ctx.emitter, identity, ctx.vertices, ctx.colors, ctx.emitter->maxParticles);
+    }
+
+    void step_particles_sprites(BenchContext& ctx) {
+        float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+        fill_sprite_buffer(ctx.emitter, identity, ctx.vertices, ctx.colors, ctx.emitter->maxParticles);
+    }
+
+    // The 500k round particles as textured quads of an 8 x 8 flipbook
+    void setup_textured_particles(BenchContext& ctx) {
+        setup_round_particles(ctx);
+        ParticleAtlas atlas = {8, 8, 0, 64, 1.0f, 1024.0f, 1024.0f};
+        ctx.atlas = atlas;
+        ctx.emitter->atlas = &ctx.atlas;
+        ctx.uvs = (float*)calloc((size_t)ctx.emitter->maxParticles * 8, sizeof(float));
+    }
+
+    void step_particles_textured(BenchContext& ctx) {
+        float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+        fill_textured_buffer(ctx.emitter, identity, ctx.vertices, ctx.colors, ctx.uvs, ctx.emitter->maxParticles);
+    }
+
+    // 200k-particle sphere explosion generated natively every frame
+    void setup_burst(BenchContext& ctx) {
+        ctx.emitter = create_particle_emitter(200000, 0);
+        memset(&ctx.burstShape, 0, sizeof(ctx.burstShape));
+        ctx.burstShape.shape = EMIT_SPHERE;
+        ctx.burstShape.radius = 20.0f;
+        ctx.burstShape.speedMin = 100.0f;
+        ctx.burstShape.speedMax = 400.0f;
+        ctx.burstShape.lifeMin = 0.3f;
+        ctx.burstShape.lifeMax = 1.0f;
+        ctx.burstShape.sizeMin = 2.0f;
+        ctx.burstShape.sizeMax = 6.0f;
+        ctx.burstShape.color = 0xFFFFAA00u;
+        ctx.burstShape.seed = 7;
+    }
+
+    void step_burst(BenchContext& ctx) {
+        ctx.emitter->activeCount = 0;
+        spawn_burst(ctx.emitter, ctx.emitter->maxParticles, &ctx.burstShape);
+    }
+
+    // 10k nodes, 8 children per node; the root moves every frame so every world matrix is rebuilt
+    void setup_nodes(BenchContext& ctx) {
+        const int count = 10000;
+        ctx.scene = create_native_scene(count);
+        create_native_node(ctx.scene, -1);
+        for (int i = 1; i < count; ++i) {
+            int32_t id = create_native_node(ctx.scene, (i - 1) / 8);
+            NativeNode& node = ctx.scene->nodes[id];
+            node.posX = (i % 8) * 4.0f;
+            node.rotZ = (i % 8) * 0.1f;
+        }
+        update_scene_transforms(ctx.scene);
+    }
+
+    void step_nodes(BenchContext& ctx) {
+        NativeNode& root = ctx.scene->nodes[0];
+        root.rotZ = ctx.frame * 0.01f;
+        root.dirty = 1;
+        update_scene_transforms(ctx.scene);
+    }
+
+    // 256 independent 16-body worlds stepped together (server-side match validation)
+    void setup_world_group(BenchContext& ctx) {
+        const int worlds = 256;
+        ctx.group = create_world_group(worlds);
+        for (int w = 0; w < worlds; ++w) {
+            PhysicsWorld* world = create_physics_world(17);
+            add_static_box(world, 0, -10, 400, 20);
+            for (int i = 0; i < 16; ++i) {
+                create_body(world, DYNAMIC, (i & 1) ? SHAPE_BOX : SHAPE_CIRCLE,
+                            (i % 4) * 24.0f - 36.0f + random01(), 20.0f + (i / 4) * 24.0f, 20, 20, 0, 0x0001, 0xFFFF);
+            }
+            world_group_add(ctx.group, world);
+            ctx.groupWorlds.push_back(world);
+        }
+    }
+
+    void step_world_group_scene(BenchContext& ctx) {
+        step_world_group(ctx.group, kTimeStep, 1);
+    }
+
+    void teardown(BenchContext& ctx) {
+        for (size_t i = 0; i < ctx.groupWorlds.size(); ++i) destroy_physics_world(ctx.groupWorlds[i]);
+        if (ctx.group) destroy_world_group(ctx.group);
+        if (ctx.world) destroy_physics_world(ctx.world);
+        if (ctx.emitter) destroy_particle_emitter(ctx.emitter);
+        for (size_t i = 0; i < ctx.emitters.size(); ++i) destroy_particle_emitter(ctx.emitters[i]);
+        free(ctx.vertices);
+        free(ctx.colors);
+        free(ctx.uvs);
+        if (ctx.scene) destroy_native_scene(ctx.scene);
+    }
+
+    const BenchScene kScenes[] = {
+        {"pyramid", "20-row box pyramid (210 boxes)", setup_pyramid, step_world},
+        {"circle_rain", "3000 circles into a bin", setup_circle_rain, step_world},
+        {"tilemap", "7.7k static tiles + 300 movers", setup_tilemap, step_tilemap},
+        {"chain", "100-link revolute chain", setup_chain, step_world},
+        {"soft_bodies", "48 soft bodies x 16 points", setup_soft_bodies, step_world},
+        {"particles_fill", "1M particles fill_vertex_buffer", setup_particles, step_particles},
+        {"particles_culled", "1M particles, 25% on screen", setup_culled_particles, step_particles},
+        {"particles_sorted", "500k particles, back-to-front sort", setup_sorted_particles, step_particles},
+        {"particles_round", "500k 12-gon particles fill_vertex_buffer", setup_round_particles, step_particles},
+        {"particles_indexed", "500k 12-gon particles, indexed corners", setup_round_particles, step_particles_indexed},
+        {"particles_sprites", "500k 12-gon particles, one atlas sprite each", setup_round_particles, step_particles_sprites},
+        {"particles_textured", "500k particles, textured quads + flipbook UVs", setup_textured_particles, step_particles_textured},
+        {"particles_burst", "200k-particle sphere burst", setup_burst, step_burst},
+        {"particles_update", "200k particles update + respawn", setup_particle_update, step_particle_update},
+        {"particles_forces", "particles_update + 4 force fields", setup_particle_forces, step_particle_update},
+        {"emitters_each", "40 x 1k-particle emitters, fill per emitter", setup_many_emitters, step_emitters_each},
+        {"emitters_merged", "40 x 1k-particle emitters, one merged fill", setup_many_emitters, step_emitters_merged},
+        {"particles_collide", "particles_update + 65 static boxes", setup_particle_collide, step_particle_update},
+        {"particles_trails", "particles_update + 8-point ribbon fill", setup_particle_trails, step_particle_trails},
+        {"node_hierarchy", "10k-node transform hierarchy", setup_nodes, step_nodes},
+        {"world_group", "256 worlds x 16 bodies, one call", setup_world_group, step_world_group_scene},
+    };
+    const int kSceneCount = sizeof(kScenes) / sizeof(kScenes[0]);
+
+    struct BenchResult {
+        const char* name;
+        const char* description;
+        int steps;
+        double meanMs, p50Ms, p90Ms, p99Ms, maxMs;
+        double allocsPerStep, bytesPerStep;
+        int64_t setupAllocs;
+    };
+
+    // Nearest-rank percentile of sorted samples
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0;
+        size_t rank = (size_t)std::ceil(p / 100.0 * sorted.size());
+        if (rank < 1) rank = 1;
+        return sorted[std::min(rank, sorted.size()) - 1];
+    }
+
+    BenchResult run_scene(const BenchScene& scene, int warmup, int steps) {
+        BenchContext ctx;
+        ctx.world = NULL;
+        ctx.emitter = NULL;
+        ctx.vertices = NULL;
+        ctx.colors = NULL;
+        ctx.uvs = NULL;
+        ctx.scene = NULL;
+        ctx.group = NULL;
+        ctx.frame = 0;
+        g_seed = 12345;
+
+        uint64_t setupStart = g_allocCount.load();
+        scene.setup(ctx);
+        uint64_t setupAllocs = g_allocCount.load() - setupStart;
+
+        for (int i = 0; i < warmup; ++i, ++ctx.frame) scene.step(ctx);
+
+        std::vector<double> times;
+        times.reserve(steps);
+        uint64_t allocStart = g_allocCount.load();
+        uint64_t bytesStart = g_allocBytes.load();
+
+        for (int i = 0; i < steps; ++i, ++ctx.frame) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            scene.step(ctx);
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        // Excludes the times vector, reserved before the loop
+        uint64_t allocs = g_allocCount.load() - allocStart;
+        uint64_t bytes = g_allocBytes.load() - bytesStart;
+        teardown(ctx);
+
+        BenchResult result;
+        result.name = scene.name;
+        result.description = scene.description;
+        result.steps = steps;
+        double sum = 0;
+        for (size_t i = 0; i < times.size(); ++i) sum += times[i];
+        std::sort(times.begin(), times.end());
+        result.meanMs = steps > 0 ? sum / steps : 0;
+        result.p50Ms = percentile(times, 50);
+        result.p90Ms = percentile(times, 90);
+        result.p99Ms = percentile(times, 99);
+        result.maxMs = times.empty() ? 0 : times.back();
+        if (FLASH_BENCH_COUNTS_ALLOCS && steps > 0) {
+            result.allocsPerStep = (double)allocs / steps;
+            result.bytesPerStep = (double)bytes / steps;
+            result.setupAllocs = (int64_t)setupAllocs;
+        } else {
+            result.allocsPerStep = -1;
+            result.bytesPerStep = -1;
+            result.setupAllocs = -1;
+        }
+        return result;
+    }
+
+    void write_json(FILE* f, const std::vector<BenchResult>& results, int warmup) {
+        fprintf(f, "{\n  \"benchmark\": \"flash_core\",\n");
+        fprintf(f, "  \"timeStep\": %.6f,\n  \"warmupSteps\": %d,\n", kTimeStep, warmup);
+        fprintf(f, "  \"allocationsCounted\": %s,\n", FLASH_BENCH_COUNTS_ALLOCS ? "true" : "false");
+        fprintf(f, "  \"scenes\": [\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            fprintf(f, "    {\"name\": \"%s\", \"description\": \"%s\", \"steps\": %d, "
+                       "\"meanMs\": %.4f, \"p50Ms\": %.4f, \"p90Ms\": %.4f, \"p99Ms\": %.4f, \"maxMs\": %.4f, "
+                       "\"allocsPerStep\": %.2f, \"allocBytesPerStep\": %.1f, \"setupAllocs\": %lld}%s\n",
+                    r.name, r.description, r.steps,
+                    r.meanMs, r.p50Ms, r.p90Ms, r.p99Ms, r.maxMs,
+                    r.allocsPerStep, r.bytesPerStep, (long long)r.setupAllocs,
+                    i + 1 < results.size() ? "," : "");
+        }
+        fprintf(f, "  ]\n}\n");
+    }
+
+    void print_usage() {
+        printf("Usage: flash_benchmark [--scene NAME] [--steps N] [--warmup N] [--json PATH|-] [--list]\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    int steps = 600;
+    int warmup = 60;
+    const char* sceneFilter = NULL;
+    const char* jsonPath = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--steps") == 0 && hasValue) steps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && hasValue) warmup = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scene") == 0 && hasValue) sceneFilter = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && hasValue) jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--list") == 0) {
+            for (int s = 0; s < kSceneCount; ++s) printf("%-16s %s\n", kScenes[s].name, kScenes[s].description);
+            return 0;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (steps < 1) steps = 1;
+    if (warmup < 0) warmup = 0;
+
+    // JSON on stdout: keep the table off it
+    bool quiet = jsonPath && strcmp(jsonPath, "-") == 0;
+    FILE* table = quiet ? stderr : stdout;
+
+    std::vector<BenchResult> results;
+    fprintf(table, "%-16s %7s %9s %9s %9s %9s %9s %10s %12s\n",
+            "scene", "steps", "mean ms", "p50 ms", "p90 ms", "p99 ms", "max ms", "allocs/st", "bytes/st");
+    for (int s = 0; s < kSceneCount; ++s) {
+        if (sceneFilter && strcmp(sceneFilter, kScenes[s].name) != 0) continue;
+        BenchResult r = run_scene(kScenes[s], warmup, steps);
+        results.push_back(r);
+        fprintf(table, "%-16s %7d %9.4f %9.4f %9.4f %9.4f %9.4f %10.2f %12.1f\n",
+                r.name, r.steps, r.meanMs, r.p50Ms, r.p90Ms, r.p99Ms, r.maxMs, r.allocsPerStep, r.bytesPerStep);
+    }
+
+    if (results.empty()) {
+        fprintf(stderr, "No scene named '%s' (use --list)\n", sceneFilter ? sceneFilter : "");
+        return 1;
+    }
+
+    if (jsonPath) {
+        FILE* f = quiet ? stdout : fopen(jsonPath, "w");
+        if (!f) {
+            fprintf(stderr, "Can't write %s\n", jsonPath);
+            return 1;
+        }
+        write_json(f, results, warmup);
+        if (!quiet) fclose(f);
+    }
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include "broadphase.h"
 #include "physics.h"
+#include "flash_math.h"
 #include <cmath>
 #include <algorithm>
 
@@ -369,36 +370,33 @@ int32_t tree_update_leaf(DynamicTree* tree, int32_t proxyId, const AABB& aabb) {
 int query_tree_pairs(DynamicTree* tree, BroadphasePair* outPairs, int maxPairs) {
     if (tree->root == -1) return 0;
     
+    // Algorithm: for each leaf (in depth-first order), query the tree for overlaps.
+    // To avoid duplicates (A,B and B,A), we only report leaves with index > leaf.
+    // Fixed stacks (Box2D style): the tree is AVL balanced so depth stays small,
+    // and the pair pass never touches the heap.
+    const int stackCapacity = 256;
+    int32_t leafStack[stackCapacity];
+    int32_t queryStack[stackCapacity];
     int pairCount = 0;
-    std::vector<int32_t> stack;
     
-    // We traverse the tree to find all overlapping leaves.
-    // Algorithm: for each leaf, query the tree for overlaps.
-    // To avoid duplicates (A,B and B,A), we only query leaves with index > leaf.
-    
-    std::vector<int32_t> leaves;
-    stack.push_back(tree->root);
-    while(!stack.empty()){
-        int32_t curr = stack.back();
-        stack.pop_back();
-        if(tree->nodes[curr].isLeaf()) leaves.push_back(curr);
-        else {
-            stack.push_back(tree->nodes[curr].left);
-            stack.push_back(tree->nodes[curr].right);
+    int leafTop = 0;
+    leafStack[leafTop++] = tree->root;
+    while (leafTop > 0) {
+        int32_t leafA = leafStack[--leafTop];
+        if (!tree->nodes[leafA].isLeaf()) {
+            if (leafTop + 2 > stackCapacity) continue;
+            leafStack[leafTop++] = tree->nodes[leafA].left;
+            leafStack[leafTop++] = tree->nodes[leafA].right;
+            continue;
         }
-    }
-    
-    for(size_t i = 0; i < leaves.size(); ++i){
-        int32_t leafA = leaves[i];
         const AABB& aabbA = tree->nodes[leafA].aabb;
         
         // Query tree for overlaps with aabbA
-        stack.clear();
-        stack.push_back(tree->root);
+        int queryTop = 0;
+        queryStack[queryTop++] = tree->root;
         
-        while(!stack.empty()){
-            int32_t curr = stack.back();
-            stack.pop_back();
+        while (queryTop > 0) {
+            int32_t curr = queryStack[--queryTop];
             
             if(!tree->nodes[curr].aabb.overlaps(aabbA)) continue;
             
@@ -411,9 +409,9 @@ int query_tree_pairs(DynamicTree* tree, BroadphasePair* outPairs, int maxPairs)
                     outPairs[pairCount].bodyB = tree->nodes[leafB].bodyId;
                     pairCount++;
                 }
-            } else {
-                stack.push_back(tree->nodes[curr].left);
-                stack.push_back(tree->nodes[curr].right);
+            } else if (queryTop + 2 <= stackCapacity) {
+                queryStack[queryTop++] = tree->nodes[curr].left;
+                queryStack[queryTop++] = tree->nodes[curr].right;
             }
         }
     }
@@ -421,6 +419,30 @@ int query_tree_pairs(DynamicTree* tree, BroadphasePair* outPairs, int maxPairs)
     return pairCount;
 }
 
+void tree_query(const DynamicTree* tree, const AABB& aabb, TreeQueryCallback callback, void* context) {
+    if (!tree || tree->root == -1) return;
+    
+    // Fixed stack (Box2D style). Tree is AVL balanced so depth stays small.
+    const int stackCapacity = 256;
+    int32_t stack[stackCapacity];
+    int stackCount = 0;
+    stack[stackCount++] = tree->root;
+    
+    while (stackCount > 0) {
+        int32_t curr = stack[--stackCount];
+        const TreeNode& node = tree->nodes[curr];
+        
+        if (!node.aabb.overlaps(aabb)) continue;
+        
+        if (node.isLeaf()) {
+            if (!callback(node.bodyId, context)) return;
+        } else if (stackCount + 2 <= stackCapacity) {
+            stack[stackCount++] = node.left;
+            stack[stackCount++] = node.right;
+        }
+    }
+}
+
 AABB calculate_body_aabb(const NativeBody& body) {
     AABB aabb;
     
@@ -433,8 +455,8 @@ AABB calculate_body_aabb(const NativeBody& body) {
         // Box - need to account for rotation
         float hw = body.width * 0.5f;
         float hh = body.height * 0.5f;
-        float c = std::cos(body.rotation);
-        float s = std::sin(body.rotation);
+        float c = flash_cos(body.rotation);
+        float s = flash_sin(body.rotation);
         
         // Calculate rotated corners
         float corners[4][2] = {
@@ -73,6 +73,12 @@ int32_t tree_update_leaf(DynamicTree* tree, int32_t proxyId, const AABB& aabb);
 // Query tree for potential collision pairs against all bodies
 int query_tree_pairs(DynamicTree* tree, BroadphasePair* outPairs, int maxPairs);
 
+// Callback for tree queries. Return false to stop the query early.
+typedef bool (*TreeQueryCallback)(uint32_t bodyId, void* context);
+
+// Query tree for all leaves whose (fattened) AABB overlaps the given AABB
+void tree_query(const DynamicTree* tree, const AABB& aabb, TreeQueryCallback callback, void* context);
+
 // Helper: Calculate AABB for a body
 AABB calculate_body_aabb(const struct NativeBody& body);
 
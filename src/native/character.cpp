@@ -0,0 +1,95 @@
+#include "character.h"
+#include "queries.h"
+#include "physics.h"
+#include "broadphase.h"
+#include <cmath>
+
+extern "C" {
+
+void init_character_controller(CharacterController* controller, int shapeType, float w, float h, float x, float y) {
+    if (!controller) return;
+    controller->bodyId = -1;
+    controller->shapeType = shapeType;
+    controller->width = w;
+    controller->height = h;
+    controller->skinWidth = 0.5f;
+    controller->minGroundNormalY = 0.7f; // ~45 degree slopes
+    controller->maxIterations = 4;
+    controller->categoryBits = 0x0001;
+    controller->maskBits = 0xFFFF;
+    controller->x = x;
+    controller->y = y;
+    controller->onGround = 0;
+    controller->groundNormalX = 0.0f;
+    controller->groundNormalY = 0.0f;
+    controller->groundBodyId = -1;
+    controller->hitCount = 0;
+}
+
+namespace {
+    void record_ground(CharacterController* c, const ShapeCastHit& hit) {
+        if (hit.normalY < c->minGroundNormalY) return;
+        c->onGround = 1;
+        c->groundNormalX = hit.normalX;
+        c->groundNormalY = hit.normalY;
+        c->groundBodyId = hit.bodyId;
+    }
+}
+
+void character_move(PhysicsWorld* world, CharacterController* c, float dx, float dy) {
+    if (!world || !c) return;
+
+    c->onGround = 0;
+    c->groundNormalX = c->groundNormalY = 0.0f;
+    c->groundBodyId = -1;
+    c->hitCount = 0;
+
+    float remX = dx, remY = dy;
+    for (int iter = 0; iter < c->maxIterations; ++iter) {
+        float len = std::sqrt(remX * remX + remY * remY);
+        if (len < 1e-4f) break;
+
+        ShapeCastHit hit = shape_cast(world, c->shapeType, c->width, c->height, 0.0f,
+                                      c->x, c->y, remX, remY, c->categoryBits, c->maskBits, c->bodyId);
+        if (!hit.hit) {
+            c->x += remX;
+            c->y += remY;
+            break;
+        }
+
+        // Advance up to the contact, keeping skinWidth of clearance
+        float travel = hit.fraction * len - c->skinWidth;
+        if (travel < 0.0f) travel = 0.0f;
+        c->x += remX / len * travel;
+        c->y += remY / len * travel;
+
+        c->hitCount++;
+        record_ground(c, hit);
+
+        // Slide: drop the part of the leftover motion that goes into the surface
+        float leftover = 1.0f - travel / len;
+        remX *= leftover;
+        remY *= leftover;
+        float vn = remX * hit.normalX + remY * hit.normalY;
+        if (vn < 0.0f) {
+            remX -= hit.normalX * vn;
+            remY -= hit.normalY * vn;
+        }
+    }
+
+    // Ground probe: standing still on a floor should still report onGround (Y-Up, gravity is -Y)
+    if (!c->onGround) {
+        ShapeCastHit probe = shape_cast(world, c->shapeType, c->width, c->height, 0.0f,
+                                        c->x, c->y, 0.0f, -c->skinWidth * 2.0f, c->categoryBits, c->maskBits, c->bodyId);
+        if (probe.hit) record_ground(c, probe);
+    }
+
+    if (c->bodyId >= 0 && c->bodyId < world->activeCount) {
+        NativeBody& b = world->bodies[c->bodyId];
+        b.x = c->x;
+        b.y = c->y;
+        b.proxyId = tree_update_leaf(world->tree, b.proxyId, calculate_body_aabb(b));
+    }
+}
+
+}
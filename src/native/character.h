@@ -0,0 +1,40 @@
+#ifndef FLASH_CHARACTER_H
+#define FLASH_CHARACTER_H
+
+#include <stdint.h>
+
+extern "C" {
+
+// Kinematic character controller (collide-and-slide on top of shape_cast).
+// The struct is owned by the caller; character_move reads the configuration
+// fields and writes the position and contact outputs.
+struct CharacterController {
+    // Configuration
+    int32_t bodyId;         // Optional body moved with the controller (-1 = none)
+    int shapeType;          // SHAPE_CIRCLE or SHAPE_BOX
+    float width, height;    // Same meaning as create_body
+    float skinWidth;        // Gap kept between the shape and obstacles
+    float minGroundNormalY; // cos(max walkable slope), contacts steeper than this are walls
+    int maxIterations;      // Slide iterations per move
+    uint32_t categoryBits;
+    uint32_t maskBits;
+
+    // State
+    float x, y;
+
+    // Output of the last move
+    int onGround;
+    float groundNormalX, groundNormalY;
+    int32_t groundBodyId;
+    int hitCount;
+};
+
+// Fill a controller with defaults for the given shape at (x, y)
+void init_character_controller(CharacterController* controller, int shapeType, float w, float h, float x, float y);
+
+// Move by (dx, dy), sliding along anything in the way
+void character_move(struct PhysicsWorld* world, CharacterController* controller, float dx, float dy);
+
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include "events.h"
+#include "physics.h"
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+// Pair key: (minId << 32) | maxId
+inline uint64_t contact_pair_key(uint32_t a, uint32_t b) {
+    uint64_t minId = std::min(a, b);
+    uint64_t maxId = std::max(a, b);
+    return (minId << 32) | maxId;
+}
+
+extern "C" {
+
+ContactEventBuffer* create_contact_event_buffer(int capacity) {
+    ContactEventBuffer* buffer = (ContactEventBuffer*)calloc(1, sizeof(ContactEventBuffer));
+    if (!buffer) return NULL;
+    buffer->capacity = capacity > 0 ? capacity : 1;
+    buffer->events = (ContactEvent*)calloc(buffer->capacity, sizeof(ContactEvent));
+    return buffer;
+}
+
+void destroy_contact_event_buffer(ContactEventBuffer* buffer) {
+    if (!buffer) return;
+    free(buffer->events);
+    free(buffer);
+}
+
+void push_contact_event(ContactEventBuffer* buffer, const ContactEvent& event) {
+    if (!buffer || !buffer->events) return;
+
+    // Ring full: keep the unread events and drop the new one. Only the
+    // consumer writes readIndex, so the producer never races its drain loop.
+    if (buffer->writeIndex - buffer->readIndex >= (uint32_t)buffer->capacity) {
+        buffer->droppedCount++;
+        return;
+    }
+    buffer->events[buffer->writeIndex % (uint32_t)buffer->capacity] = event;
+    buffer->writeIndex++;
+}
+
+ContactEventBuffer* get_contact_events(PhysicsWorld* world) {
+    return world ? world->contactEvents : NULL;
+}
+
+void set_hit_event_threshold(PhysicsWorld* world, float threshold) {
+    if (world) world->hitEventThreshold = threshold;
+}
+
+ContactTracker* create_contact_tracker() {
+    return new ContactTracker();
+}
+
+void destroy_contact_tracker(ContactTracker* tracker) {
+    delete tracker;
+}
+
+void contact_tracker_begin_step(ContactTracker* tracker) {
+    tracker->currentContacts.clear();
+    tracker->currentSensors.clear();
+}
+
+bool contact_tracker_touch(ContactTracker* tracker, uint32_t bodyA, uint32_t bodyB, int isSensor) {
+    uint64_t key = contact_pair_key(bodyA, bodyB);
+    if (isSensor) {
+        tracker->currentSensors.push_back(key);
+        return !std::binary_search(tracker->previousSensors.begin(), tracker->previousSensors.end(), key);
+    }
+    tracker->currentContacts.push_back(key);
+    return !std::binary_search(tracker->previousContacts.begin(), tracker->previousContacts.end(), key);
+}
+
+namespace {
+    // Emit an end event for every key in previous that is missing from current (both sorted)
+    void emit_end_events(const std::vector<uint64_t>& previous, const std::vector<uint64_t>& current,
+                         int type, ContactEventBuffer* buffer, const NativeBody* bodies) {
+        size_t j = 0;
+        for (size_t i = 0; i < previous.size(); ++i) {
+            while (j < current.size() && current[j] < previous[i]) ++j;
+            if (j < current.size() && current[j] == previous[i]) continue;
+
+            ContactEvent e = {};
+            e.type = type;
+            e.bodyA = (int32_t)(previous[i] >> 32);
+            e.bodyB = (int32_t)(previous[i] & 0xFFFFFFFF);
+            // Sensor events report the sensor as bodyA
+            if (type == SENSOR_END && !bodies[e.bodyA].isSensor) std::swap(e.bodyA, e.bodyB);
+            push_contact_event(buffer, e);
+        }
+    }
+}
+
+void contact_tracker_end_step(ContactTracker* tracker, ContactEventBuffer* buffer, const NativeBody* bodies) {
+    std::sort(tracker->currentContacts.begin(), tracker->currentContacts.end());
+    std::sort(tracker->currentSensors.begin(), tracker->currentSensors.end());
+
+    emit_end_events(tracker->previousContacts, tracker->currentContacts, CONTACT_END, buffer, bodies);
+    emit_end_events(tracker->previousSensors, tracker->currentSensors, SENSOR_END, buffer, bodies);
+
+    tracker->previousContacts.swap(tracker->currentContacts);
+    tracker->previousSensors.swap(tracker->currentSensors);
+}
+
+}
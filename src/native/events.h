@@ -0,0 +1,75 @@
+#ifndef FLASH_EVENTS_H
+#define FLASH_EVENTS_H
+
+#include <stdint.h>
+#include <vector>
+
+extern "C" {
+
+// Contact event types (Box2D b2ContactEvents / b2SensorEvents)
+enum ContactEventType {
+    CONTACT_BEGIN = 0,   // Two solid bodies started touching
+    CONTACT_END = 1,     // Two solid bodies stopped touching
+    CONTACT_HIT = 2,     // Begin touch faster than world->hitEventThreshold
+    SENSOR_BEGIN = 3,    // A body entered a sensor
+    SENSOR_END = 4       // A body left a sensor
+};
+
+struct ContactEvent {
+    int32_t type;
+    int32_t bodyA;        // Sensor events: the sensor body
+    int32_t bodyB;        // Sensor events: the visiting body
+    float pointX, pointY; // Contact point (begin/hit/sensor begin)
+    float normalX, normalY; // Points from A to B
+    float approachSpeed;  // Relative normal speed when touching began
+};
+
+// Ring buffer shared with Dart (zero-copy).
+// The producer (step_physics) writes at writeIndex, the consumer reads from
+// readIndex up to writeIndex and then sets readIndex = writeIndex.
+// Indices grow monotonically; slot = index % capacity.
+// Only the consumer writes readIndex. When the ring is full, new events are
+// dropped (the unread ones are kept) and counted in droppedCount.
+struct ContactEventBuffer {
+    ContactEvent* events;
+    int32_t capacity;
+    uint32_t writeIndex;
+    uint32_t readIndex;
+    uint32_t droppedCount;
+};
+
+ContactEventBuffer* create_contact_event_buffer(int capacity);
+void destroy_contact_event_buffer(ContactEventBuffer* buffer);
+void push_contact_event(ContactEventBuffer* buffer, const ContactEvent& event);
+
+// Exported to Dart: the world's event buffer (valid for the lifetime of the world)
+ContactEventBuffer* get_contact_events(struct PhysicsWorld* world);
+
+// Minimum approach speed (pixels/s) for CONTACT_HIT events (default 100)
+void set_hit_event_threshold(struct PhysicsWorld* world, float threshold);
+
+// --- Begin/End tracking (internal, used by step_physics) ---
+
+// Touching pairs from the previous step, kept as sorted pair keys (minId << 32) | maxId
+struct ContactTracker {
+    std::vector<uint64_t> previousContacts;
+    std::vector<uint64_t> currentContacts;
+    std::vector<uint64_t> previousSensors;
+    std::vector<uint64_t> currentSensors;
+};
+
+struct ContactTracker* create_contact_tracker();
+void destroy_contact_tracker(struct ContactTracker* tracker);
+
+// Call once per step before reporting touching pairs
+void contact_tracker_begin_step(struct ContactTracker* tracker);
+
+// Report a touching pair. Returns true if the pair was not touching last step.
+bool contact_tracker_touch(struct ContactTracker* tracker, uint32_t bodyA, uint32_t bodyB, int isSensor);
+
+// Emit end events for pairs that stopped touching and roll the state over
+void contact_tracker_end_step(struct ContactTracker* tracker, ContactEventBuffer* buffer, const struct NativeBody* bodies);
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef FLASH_MATH_H
+#define FLASH_MATH_H
+
+#include <cmath>
+
+// Math functions used by the physics core.
+//
+// Normal builds forward to the platform libm. With FLASH_DETERMINISTIC defined the
+// trig functions use a fixed polynomial (Cephes sinf/cosf coefficients) built only
+// from IEEE +, *, floor, so arm64 and x86_64 produce bit-identical results.
+// sqrt is correctly rounded by IEEE 754 and needs no replacement.
+//
+// Deterministic builds must also disable fast-math and FMA contraction
+// (see scripts/build_native.sh).
+
+#if defined(FLASH_DETERMINISTIC)
+  #if defined(__FAST_MATH__)
+    #error "FLASH_DETERMINISTIC requires -fno-fast-math"
+  #endif
+  #if defined(__clang__)
+    #pragma clang fp contract(off)
+  #endif
+#endif
+
+#if defined(FLASH_DETERMINISTIC)
+
+// sin and cos of x, reduced to [-pi/4, pi/4] around the nearest multiple of pi/2
+inline void flash_sincos(float x, float& outSin, float& outCos) {
+    float quadrant = std::floor(x * 0.636619772367581f + 0.5f); // round(x * 2/pi)
+
+    // Cody-Waite reduction: pi/2 split into three parts that multiply exactly
+    float r = x - quadrant * 1.5703125f;
+    r = r - quadrant * 4.837512969970703125e-4f;
+    r = r - quadrant * 7.54978995489188216e-8f;
+
+    float r2 = r * r;
+    float s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    float c = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+    switch ((long long)quadrant & 3) {
+        case 0: outSin = s;  outCos = c;  break;
+        case 1: outSin = c;  outCos = -s; break;
+        case 2: outSin = -s; outCos = -c; break;
+        default: outSin = -c; outCos = s; break;
+    }
+}
+
+inline float flash_sin(float x) { float s, c; flash_sincos(x, s, c); return s; }
+inline float flash_cos(float x) { float s, c; flash_sincos(x, s, c); return c; }
+
+#else
+
+inline float flash_sin(float x) { return std::sin(x); }
+inline float flash_cos(float x) { return std::cos(x); }
+
+#endif
+
+#endif
@@ -0,0 +1,224 @@
+#include "jobs.h"
+#include "trace.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+namespace {
+    const int kMaxDefaultThreads = 8;
+    const int kSpinsBeforeSleep = 64;
+
+    struct JobBatch {
+        JobRangeFn fn;
+        void* context;
+        std::atomic<int> remaining;
+    };
+
+    struct JobTask {
+        JobBatch* batch;
+        int begin;
+        int end;
+    };
+
+    // Tasks are ranges of a few hundred items or more, so a short mutex per
+    // push/pop is cheap next to the work itself
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<JobTask> tasks;
+    };
+
+    struct JobPool {
+        int threadCount;          // Including the calling thread
+        WorkerQueue* queues;      // [0] is shared by external (non-worker) threads
+        std::vector<std::thread> workers;
+
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+        std::atomic<int> pending; // Queued tasks not yet taken
+        bool quit;
+    };
+
+    // g_pool is only replaced while no parallel_for holds it (g_activeCalls,
+    // both under g_poolMutex); background threads such as the physics and
+    // particle pipelines may be inside one whenever the thread count changes
+    std::mutex g_poolMutex;
+    std::condition_variable g_poolIdle;
+    JobPool* g_pool = NULL;
+    int g_activeCalls = 0;
+    int g_requestedThreads = 0;
+
+    // Queue index of the current thread; 0 for threads outside the pool
+    thread_local int t_queueIndex = 0;
+
+    bool pop_own(JobPool* pool, int index, JobTask& task) {
+        WorkerQueue& q = pool->queues[index];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(JobPool* pool, int thief, JobTask& task) {
+        for (int i = 1; i < pool->threadCount; ++i) {
+            WorkerQueue& q = pool->queues[(thief + i) % pool->threadCount];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            task = q.tasks.front();
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    bool run_one(JobPool* pool, int index) {
+        JobTask task;
+        if (!pop_own(pool, index, task) && !steal(pool, index, task)) return false;
+        pool->pending.fetch_sub(1, std::memory_order_relaxed);
+        task.batch->fn(task.batch->context, task.begin, task.end);
+        task.batch->remaining.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void worker_main(JobPool* pool, int index) {
+        t_queueIndex = index;
+        char name[32];
+        snprintf(name, sizeof(name), "job worker %d", index);
+        trace_set_thread_name(name);
+
+        int idleSpins = 0;
+        while (true) {
+            if (run_one(pool, index)) {
+                idleSpins = 0;
+                continue;
+            }
+            // Spin briefly: the next batch usually follows within microseconds
+            if (++idleSpins < kSpinsBeforeSleep) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(pool->sleepMutex);
+            pool->wake.wait(lock, [pool] { return pool->quit || pool->pending.load() > 0; });
+            if (pool->quit) return;
+            idleSpins = 0;
+        }
+    }
+
+    int default_thread_count() {
+        int hw = (int)std::thread::hardware_concurrency();
+        if (hw < 1) hw = 1;
+        return hw < kMaxDefaultThreads ? hw : kMaxDefaultThreads;
+    }
+
+    JobPool* create_pool(int threadCount) {
+        JobPool* pool = new JobPool();
+        pool->threadCount = threadCount;
+        pool->queues = new WorkerQueue[threadCount];
+        pool->pending.store(0);
+        pool->quit = false;
+        for (int i = 1; i < threadCount; ++i) {
+            pool->workers.emplace_back(worker_main, pool, i);
+        }
+        return pool;
+    }
+
+    void destroy_pool(JobPool* pool) {
+        if (!pool) return;
+        {
+            std::lock_guard<std::mutex> lock(pool->sleepMutex);
+            pool->quit = true;
+        }
+        pool->wake.notify_all();
+        for (size_t i = 0; i < pool->workers.size(); ++i) pool->workers[i].join();
+        delete[] pool->queues;
+        delete pool;
+    }
+
+    // Caller holds g_poolMutex
+    JobPool* get_pool_locked() {
+        if (!g_pool) {
+            int count = g_requestedThreads > 0 ? g_requestedThreads : default_thread_count();
+            g_pool = create_pool(count);
+        }
+        return g_pool;
+    }
+
+    // Keeps the pool alive for one parallel_for (nested calls pin it again)
+    struct PoolRef {
+        JobPool* pool;
+        PoolRef() {
+            std::lock_guard<std::mutex> lock(g_poolMutex);
+            pool = get_pool_locked();
+            ++g_activeCalls;
+        }
+        ~PoolRef() {
+            std::lock_guard<std::mutex> lock(g_poolMutex);
+            if (--g_activeCalls == 0) g_poolIdle.notify_all();
+        }
+    };
+}
+
+void parallel_for(int count, int grainSize, JobRangeFn fn, void* context) {
+    if (count <= 0 || !fn) return;
+    if (grainSize < 1) grainSize = 1;
+
+    if (count <= grainSize) {
+        fn(context, 0, count);
+        return;
+    }
+    PoolRef ref;
+    JobPool* pool = ref.pool;
+    if (pool->threadCount <= 1) {
+        fn(context, 0, count);
+        return;
+    }
+
+    JobBatch batch;
+    batch.fn = fn;
+    batch.context = context;
+    int taskCount = (count + grainSize - 1) / grainSize;
+    batch.remaining.store(taskCount, std::memory_order_relaxed);
+
+    // Deal tasks round-robin so every worker starts with local work; stealing
+    // evens out the rest
+    int self = t_queueIndex;
+    for (int t = 0; t < taskCount; ++t) {
+        JobTask task = {&batch, t * grainSize, (t + 1) * grainSize < count ? (t + 1) * grainSize : count};
+        WorkerQueue& q = pool->queues[(self + t) % pool->threadCount];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(task);
+    }
+    pool->pending.fetch_add(taskCount);
+    {
+        std::lock_guard<std::mutex> lock(pool->sleepMutex);
+    }
+    pool->wake.notify_all();
+
+    // Help until our batch is done (may also run tasks of other batches)
+    while (batch.remaining.load(std::memory_order_acquire) > 0) {
+        if (!run_one(pool, self)) std::this_thread::yield();
+    }
+}
+
+extern "C" {
+
+void set_job_thread_count(int count) {
+    std::unique_lock<std::mutex> lock(g_poolMutex);
+    g_requestedThreads = count > 0 ? count : 0;
+    // Let running batches finish on the old pool; the next call builds the new one
+    g_poolIdle.wait(lock, [] { return g_activeCalls == 0; });
+    JobPool* pool = g_pool;
+    g_pool = NULL;
+    destroy_pool(pool);
+}
+
+int get_job_thread_count() {
+    std::lock_guard<std::mutex> lock(g_poolMutex);
+    return get_pool_locked()->threadCount;
+}
+
+}
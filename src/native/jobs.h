@@ -0,0 +1,49 @@
+#ifndef FLASH_JOBS_H
+#define FLASH_JOBS_H
+
+#include <stdint.h>
+
+// Native job system shared by physics, particles and scene transforms.
+//
+// A fixed pool of worker threads, created once and reused every frame. Each
+// worker owns a deque of range tasks: the owner pops from the back, idle workers
+// steal from the front of other deques. The calling thread takes part in the
+// work while it waits, so parallel_for never blocks an idle core.
+//
+//   struct Ctx { float* data; };
+//   void scale(void* ctx, int begin, int end) { ... }
+//   parallel_for(count, 1024, scale, &ctx);
+//
+// Nested parallel_for calls (from inside a task) are allowed.
+
+extern "C" {
+
+// Total threads used by parallel_for, including the calling thread.
+// 0 = default (hardware concurrency, at most 8), 1 = run everything inline.
+// The pool is torn down and rebuilt once no parallel_for is running (e.g. on
+// the physics or particle thread); blocks until then. Don't call it from
+// inside a parallel_for task.
+void set_job_thread_count(int count);
+int get_job_thread_count();
+
+}
+
+// Processes items [begin, end) of a parallel_for
+typedef void (*JobRangeFn)(void* context, int begin, int end);
+
+// Runs fn over [0, count) split into tasks of grainSize items, and returns when
+// all of them are done. Ranges of at most grainSize items run inline.
+// Pick grainSize so a task takes roughly 10-50 µs; tiny tasks cost more in
+// scheduling than they save.
+void parallel_for(int count, int grainSize, JobRangeFn fn, void* context);
+
+// Lambda / functor version: f(begin, end)
+template <typename F>
+inline void parallel_for(int count, int grainSize, const F& f) {
+    struct Trampoline {
+        static void run(void* context, int begin, int end) { (*(const F*)context)(begin, end); }
+    };
+    parallel_for(count, grainSize, &Trampoline::run, (void*)&f);
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "joints.h"
 #include "physics.h"
+#include "flash_math.h"
 #include <cmath>
 #include <algorithm>
 
@@ -128,10 +129,10 @@ void solve_distance_joint_velocity(Joint* joint, PhysicsWorld* world) {
     if (!bodyA || !bodyB) return;
     
     // Rotate anchors to world space
-    float cosA = std::cos(bodyA->rotation);
-    float sinA = std::sin(bodyA->rotation);
-    float cosB = std::cos(bodyB->rotation);
-    float sinB = std::sin(bodyB->rotation);
+    float cosA = flash_cos(bodyA->rotation);
+    float sinA = flash_sin(bodyA->rotation);
+    float cosB = flash_cos(bodyB->rotation);
+    float sinB = flash_sin(bodyB->rotation);
     
     float rAx = cosA * joint->localAnchorAx - sinA * joint->localAnchorAy;
     float rAy = sinA * joint->localAnchorAx + cosA * joint->localAnchorAy;
@@ -230,10 +231,10 @@ void solve_distance_joint_position(Joint* joint, PhysicsWorld* world) {
     if (joint->distance.frequency > 0.0f) return; // Soft constraint, skip position solve
     
     // Rotate anchors to world space
-    float cosA = std::cos(bodyA->rotation);
-    float sinA = std::sin(bodyA->rotation);
-    float cosB = std::cos(bodyB->rotation);
-    float sinB = std::sin(bodyB->rotation);
+    float cosA = flash_cos(bodyA->rotation);
+    float sinA = flash_sin(bodyA->rotation);
+    float cosB = flash_cos(bodyB->rotation);
+    float sinB = flash_sin(bodyB->rotation);
     
     float rAx = cosA * joint->localAnchorAx - sinA * joint->localAnchorAy;
     float rAy = sinA * joint->localAnchorAx + cosA * joint->localAnchorAy;
@@ -313,10 +314,10 @@ void solve_revolute_joint_velocity(Joint* joint, PhysicsWorld* world) {
     if (!bodyA || !bodyB) return;
     
     // Rotate anchors to world space
-    float cosA = std::cos(bodyA->rotation);
-    float sinA = std::sin(bodyA->rotation);
-    float cosB = std::cos(bodyB->rotation);
-    float sinB = std::sin(bodyB->rotation);
+    float cosA = flash_cos(bodyA->rotation);
+    float sinA = flash_sin(bodyA->rotation);
+    float cosB = flash_cos(bodyB->rotation);
+    float sinB = flash_sin(bodyB->rotation);
     
     float rAx = cosA * joint->localAnchorAx - sinA * joint->localAnchorAy;
     float rAy = sinA * joint->localAnchorAx + cosA * joint->localAnchorAy;
@@ -412,10 +413,10 @@ void solve_revolute_joint_position(Joint* joint, PhysicsWorld* world) {
     if (!bodyA || !bodyB) return;
     
     // Rotate anchors
-    float cosA = std::cos(bodyA->rotation);
-    float sinA = std::sin(bodyA->rotation);
-    float cosB = std::cos(bodyB->rotation);
-    float sinB = std::sin(bodyB->rotation);
+    float cosA = flash_cos(bodyA->rotation);
+    float sinA = flash_sin(bodyA->rotation);
+    float cosB = flash_cos(bodyB->rotation);
+    float sinB = flash_sin(bodyB->rotation);
     
     float rAx = cosA * joint->localAnchorAx - sinA * joint->localAnchorAy;
     float rAy = sinA * joint->localAnchorAx + cosA * joint->localAnchorAy;
@@ -465,10 +466,10 @@ void solve_prismatic_joint_velocity(Joint* joint, PhysicsWorld* world) {
     if (!bodyA || !bodyB) return;
     
     // Rotate anchors and axis to world space
-    float cosA = std::cos(bodyA->rotation);
-    float sinA = std::sin(bodyA->rotation);
-    float cosB = std::cos(bodyB->rotation);
-    float sinB = std::sin(bodyB->rotation);
+    float cosA = flash_cos(bodyA->rotation);
+    float sinA = flash_sin(bodyA->rotation);
+    float cosB = flash_cos(bodyB->rotation);
+    float sinB = flash_sin(bodyB->rotation);
     
     float rAx = cosA * joint->localAnchorAx - sinA * joint->localAnchorAy;
     float rAy = sinA * joint->localAnchorAx + cosA * joint->localAnchorAy;
@@ -575,10 +576,10 @@ void solve_prismatic_joint_position(Joint* joint, PhysicsWorld* world) {
     if (!bodyA || !bodyB) return;
     
     // Rotate anchors and axis
-    float cosA = std::cos(bodyA->rotation);
-    float sinA = std::sin(bodyA->rotation);
-    float cosB = std::cos(bodyB->rotation);
-    float sinB = std::sin(bodyB->rotation);
+    float cosA = flash_cos(bodyA->rotation);
+    float sinA = flash_sin(bodyA->rotation);
+    float cosB = flash_cos(bodyB->rotation);
+    float sinB = flash_sin(bodyB->rotation);
     
     float rAx = cosA * joint->localAnchorAx - sinA * joint->localAnchorAy;
     float rAy = sinA * joint->localAnchorAx + cosA * joint->localAnchorAy;
@@ -631,10 +632,10 @@ void solve_weld_joint_velocity(Joint* joint, PhysicsWorld* world) {
     if (!bodyA || !bodyB) return;
     
     // Rotate anchors
-    float cosA = std::cos(bodyA->rotation);
-    float sinA = std::sin(bodyA->rotation);
-    float cosB = std::cos(bodyB->rotation);
-    float sinB = std::sin(bodyB->rotation);
+    float cosA = flash_cos(bodyA->rotation);
+    float sinA = flash_sin(bodyA->rotation);
+    float cosB = flash_cos(bodyB->rotation);
+    float sinB = flash_sin(bodyB->rotation);
     
     float rAx = cosA * joint->localAnchorAx - sinA * joint->localAnchorAy;
     float rAy = sinA * joint->localAnchorAx + cosA * joint->localAnchorAy;
@@ -702,10 +703,10 @@ void solve_weld_joint_position(Joint* joint, PhysicsWorld* world) {
     if (!bodyA || !bodyB) return;
     
     // Rotate anchors
-    float cosA = std::cos(bodyA->rotation);
-    float sinA = std::sin(bodyA->rotation);
-    float cosB = std::cos(bodyB->rotation);
-    float sinB = std::sin(bodyB->rotation);
+    float cosA = flash_cos(bodyA->rotation);
+    float sinA = flash_sin(bodyA->rotation);
+    float cosB = flash_cos(bodyB->rotation);
+    float sinB = flash_sin(bodyB->rotation);
     
     float rAx = cosA * joint->localAnchorAx - sinA * joint->localAnchorAy;
     float rAy = sinA * joint->localAnchorAx + cosA * joint->localAnchorAy;
@@ -1,8 +1,14 @@
 #include "nodes.h"
+#include "trace.h"
+#include "jobs.h"
 #include <cmath>
 #include <cstring>
 #include <algorithm>
 
+namespace {
+    const int kLocalMatrixGrainSize = 1024; // Nodes per local matrix task
+}
+
 extern "C" {
 
 // Helper: Matrix Multiply (Column-Major)
@@ -86,33 +92,38 @@ int32_t create_native_node(NativeScene* scene, int32_t parentId) {
 }
 
 void update_scene_transforms(NativeScene* scene) {
+    FLASH_TRACE_ZONE("update_scene_transforms");
     scene->totalUpdates++;
-    
-    for (int i = 0; i < scene->activeCount; ++i) {
-        NativeNode& node = scene->nodes[i];
-        
-        bool localChanged = false;
-        if (node.dirty) {
+
+    // Pass 1 (parallel): rebuild local matrices of dirty nodes. worldVersion = 0
+    // marks them for the world pass.
+    parallel_for(scene->activeCount, kLocalMatrixGrainSize, [scene](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            NativeNode& node = scene->nodes[i];
+            if (!node.dirty) continue;
             mat4_from_prs(node.localMatrix.m, 
                 node.posX, node.posY, node.posZ,
                 node.rotX, node.rotY, node.rotZ,
                 node.scaleX, node.scaleY, node.scaleZ
             );
             node.dirty = 0;
-            localChanged = true;
+            node.worldVersion = 0;
         }
+    });
+
+    // Pass 2 (serial): parents come before their children in the array
+    for (int i = 0; i < scene->activeCount; ++i) {
+        NativeNode& node = scene->nodes[i];
         
         bool parentChanged = false;
-        uint32_t parentWorldVersion = 0;
         if (node.parentId != -1) {
             NativeNode& parent = scene->nodes[node.parentId];
-            parentWorldVersion = parent.worldVersion;
-            if (node.worldVersion < parentWorldVersion) {
+            if (node.worldVersion < parent.worldVersion) {
                 parentChanged = true;
             }
         }
 
-        if (localChanged || parentChanged || node.worldVersion == 0) {
+        if (parentChanged || node.worldVersion == 0) {
             if (node.parentId == -1) {
                 memcpy(node.worldMatrix.m, node.localMatrix.m, 16 * sizeof(float));
             } else {
@@ -1,27 +1,1305 @@
 #include "particles.h"
-#include <thread>
+#include "trace.h"
+#include "jobs.h"
+#include "simd.h"
+#include "physics.h"
+#include "broadphase.h"
+#include "flash_math.h"
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    const int kUpdateGrainSize = 8192;  // Particles per update task
+    const int kFillChunkSize = 16384;   // Particles per fill task
+    const int kStreamCount = 10;        // 4-byte streams in ParticleStreams
+    const int kSortGrainSize = 65536;   // Keys per radix sort task
+    const int kBurstGrainSize = 4096;   // Particles per spawn_burst task
+    const int kCollisionTileSize = 32;  // Target particles per collision tile (one broadphase query each)
+    const int kMaxCollisionTiles = 64;  // Per axis
+
+    // Curve lookup: sample pair and blend factor for a particle's remaining life
+    inline void curve_position(float life, int& i0, float& frac) {
+        float t = 1.0f - life;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        float f = t * (PARTICLE_CURVE_SAMPLES - 1);
+        i0 = (int)f;
+        if (i0 >= PARTICLE_CURVE_SAMPLES - 1) i0 = PARTICLE_CURVE_SAMPLES - 2;
+        frac = f - i0;
+    }
+
+    inline float sample_curve(const float* curve, float life) {
+        int i0;
+        float frac;
+        curve_position(life, i0, frac);
+        return curve[i0] + (curve[i0 + 1] - curve[i0]) * frac;
+    }
+
+    inline uint32_t sample_color(const uint32_t* curve, float life) {
+        int i0;
+        float frac;
+        curve_position(life, i0, frac);
+        uint32_t a = curve[i0], b = curve[i0 + 1];
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            float ca = (float)((a >> shift) & 0xFF), cb = (float)((b >> shift) & 0xFF);
+            out |= (uint32_t)(ca + (cb - ca) * frac + 0.5f) << shift;
+        }
+        return out;
+    }
+
+    // Curve color: RGB multiplies the particle's RGB, A is the output alpha
+    inline uint32_t tint_color(uint32_t particle, uint32_t curve) {
+        uint32_t out = curve & 0xFF000000u;
+        for (int shift = 0; shift < 24; shift += 8) {
+            uint32_t c = ((particle >> shift) & 0xFF) * ((curve >> shift) & 0xFF);
+            out |= ((c + 127) / 255) << shift;
+        }
+        return out;
+    }
+
+    inline const float* drag_curve(const ParticleEmitter* e) {
+        return (e->curves && (e->curves->flags & CURVE_DRAG)) ? e->curves->drag : NULL;
+    }
+
+    ParticleStreams* create_streams(int maxParticles) {
+        int capacity = simd::padded_count(maxParticles);
+        size_t streamBytes = (size_t)capacity * sizeof(float);
+        void* block = NULL;
+        if (posix_memalign(&block, simd::kAlignment, streamBytes * kStreamCount) != 0) return NULL;
+        memset(block, 0, streamBytes * kStreamCount);
+
+        // capacity is a multiple of 8, so every stream starts 32-byte aligned
+        float* base = (float*)block;
+        ParticleStreams* s = (ParticleStreams*)calloc(1, sizeof(ParticleStreams));
+        s->x = base;
+        s->y = base + capacity;
+        s->z = base + capacity * 2;
+        s->vx = base + capacity * 3;
+        s->vy = base + capacity * 4;
+        s->vz = base + capacity * 5;
+        s->life = base + capacity * 6;
+        s->lifeRate = base + capacity * 7;
+        s->size = base + capacity * 8;
+        s->color = (uint32_t*)(base + capacity * 9);
+        s->capacity = capacity;
+        s->block = block;
+        return s;
+    }
+
+    // Integrates batches [begin, end) of 8 particles. Returns true if any live
+    // lane (index < activeCount) expired; padding lanes are ignored.
+    // With a drag curve, velocities are scaled by (1 - drag(age) * dt) after gravity.
+    template <bool DRAG>
+    bool integrate_streams(ParticleStreams* s, const ParticleEmitter* e, float dt, int begin, int end) {
+        using namespace simd;
+        const float* drag = DRAG ? e->curves->drag : NULL;
+        F32x8 vdt = set1(dt);
+        F32x8 gx = set1(e->gravityX * dt);
+        F32x8 gy = set1(e->gravityY * dt);
+        F32x8 gz = set1(e->gravityZ * dt);
+        int dead = 0;
+
+        for (int b = begin; b < end; ++b) {
+            int i = b * kLanes;
+            F32x8 vx = load(s->vx + i), vy = load(s->vy + i), vz = load(s->vz + i);
+            store(s->x + i, mul_add(vx, vdt, load(s->x + i)));
+            store(s->y + i, mul_add(vy, vdt, load(s->y + i)));
+            store(s->z + i, mul_add(vz, vdt, load(s->z + i)));
+            if (DRAG) {
+                // Curve lookups are per lane; the scaling stays vectorized
+                alignas(32) float damp[kLanes];
+                for (int l = 0; l < kLanes; ++l) {
+                    float d = 1.0f - sample_curve(drag, s->life[i + l]) * dt;
+                    damp[l] = d > 0.0f ? d : 0.0f;
+                }
+                F32x8 vd = load(damp);
+                store(s->vx + i, mul(add(vx, gx), vd));
+                store(s->vy + i, mul(add(vy, gy), vd));
+                store(s->vz + i, mul(add(vz, gz), vd));
+            } else {
+                store(s->vx + i, add(vx, gx));
+                store(s->vy + i, add(vy, gy));
+                store(s->vz + i, add(vz, gz));
+            }
+
+            F32x8 life = sub(load(s->life + i), mul(load(s->lifeRate + i), vdt));
+            store(s->life + i, life);
+
+            int lanes = e->activeCount - i;
+            int valid = lanes >= kLanes ? 0xFF : (1 << lanes) - 1;
+            dead |= mask_le_zero(life) & valid;
+        }
+        return dead != 0;
+    }
+
+    // Parabolic approximation of a period-1 sine (s) and its derivative scaled
+    // to [-1, 1] (d); C1-continuous, which is all the curl noise needs
+    inline void wave(simd::F32x8 x, simd::F32x8& s, simd::F32x8& d) {
+        using namespace simd;
+        F32x8 one = set1(1.0f);
+        F32x8 t = sub(mul(sub(x, simd::floor(x)), set1(2.0f)), one);
+        F32x8 a = simd::max(t, sub(set1(0.0f), t));
+        s = mul(mul(set1(4.0f), t), sub(one, a));
+        d = sub(one, add(a, a));
+    }
+
+    inline bool normalize3(float& x, float& y, float& z) {
+        float len = sqrtf(x * x + y * y + z * z);
+        if (len <= 0.0f) return false;
+        x /= len; y /= len; z /= len;
+        return true;
+    }
+
+    // 1 - dist / radius clamped to [0, 1]; radius 0 means no falloff
+    inline simd::F32x8 falloff(simd::F32x8 dist, float radius) {
+        using namespace simd;
+        if (radius <= 0.0f) return set1(1.0f);
+        return simd::max(set1(0.0f), sub(set1(1.0f), mul(dist, set1(1.0f / radius))));
+    }
+
+    // Applies the emitter's force fields to batches [begin, end), one field at a
+    // time over the whole range (the range is small enough to stay in cache)
+    void apply_force_fields(ParticleStreams* s, const ParticleEmitter* e, float dt, int begin, int end) {
+        using namespace simd;
+        const F32x8 eps = set1(1e-6f);
+        for (int f = 0; f < e->forceFieldCount; ++f) {
+            const ForceField& field = e->forceFields[f];
+            float ax = field.axisX, ay = field.axisY, az = field.axisZ;
+            F32x8 cx = set1(field.x), cy = set1(field.y), cz = set1(field.z);
+            F32x8 k = set1(field.strength * dt);
+
+            switch (field.type) {
+            case FORCE_POINT:
+                for (int b = begin; b < end; ++b) {
+                    int i = b * kLanes;
+                    F32x8 dx = sub(cx, load(s->x + i)), dy = sub(cy, load(s->y + i)), dz = sub(cz, load(s->z + i));
+                    F32x8 dist = simd::sqrt(add(mul_add(dx, dx, mul_add(dy, dy, mul(dz, dz))), eps));
+                    F32x8 scale = div(mul(k, falloff(dist, field.radius)), dist);
+                    store(s->vx + i, mul_add(dx, scale, load(s->vx + i)));
+                    store(s->vy + i, mul_add(dy, scale, load(s->vy + i)));
+                    store(s->vz + i, mul_add(dz, scale, load(s->vz + i)));
+                }
+                break;
+
+            case FORCE_VORTEX: {
+                if (!normalize3(ax, ay, az)) { ax = 0; ay = 0; az = 1; }
+                F32x8 nx = set1(ax), ny = set1(ay), nz = set1(az);
+                for (int b = begin; b < end; ++b) {
+                    int i = b * kLanes;
+                    F32x8 rx = sub(load(s->x + i), cx), ry = sub(load(s->y + i), cy), rz = sub(load(s->z + i), cz);
+                    // Tangent = axis x r; its length is the distance from the axis
+                    F32x8 tx = sub(mul(ny, rz), mul(nz, ry));
+                    F32x8 ty = sub(mul(nz, rx), mul(nx, rz));
+                    F32x8 tz = sub(mul(nx, ry), mul(ny, rx));
+                    F32x8 dist = simd::sqrt(add(mul_add(tx, tx, mul_add(ty, ty, mul(tz, tz))), eps));
+                    F32x8 scale = div(mul(k, falloff(dist, field.radius)), dist);
+                    store(s->vx + i, mul_add(tx, scale, load(s->vx + i)));
+                    store(s->vy + i, mul_add(ty, scale, load(s->vy + i)));
+                    store(s->vz + i, mul_add(tz, scale, load(s->vz + i)));
+                }
+                break;
+            }
+
+            case FORCE_TURBULENCE: {
+                // Curl of the potential (S(y)S(z'), S(z)S(x'), S(x)S(y')) with
+                // offset arguments x' = x + 2.3 etc.: divergence-free, so
+                // particles swirl instead of bunching up
+                F32x8 freq = set1(field.frequency);
+                F32x8 ox = set1(2.3f), oy = set1(3.1f), oz = set1(1.7f);
+                for (int b = begin; b < end; ++b) {
+                    int i = b * kLanes;
+                    F32x8 px = mul(sub(load(s->x + i), cx), freq);
+                    F32x8 py = mul(sub(load(s->y + i), cy), freq);
+                    F32x8 pz = mul(sub(load(s->z + i), cz), freq);
+                    F32x8 sx, dx, sy, dy, sz, dz, sx2, dx2, sy2, dy2, sz2, dz2;
+                    wave(px, sx, dx); wave(add(px, ox), sx2, dx2);
+                    wave(py, sy, dy); wave(add(py, oy), sy2, dy2);
+                    wave(pz, sz, dz); wave(add(pz, oz), sz2, dz2);
+                    F32x8 curlX = sub(mul(sx, dy2), mul(dz, sx2));
+                    F32x8 curlY = sub(mul(sy, dz2), mul(dx, sy2));
+                    F32x8 curlZ = sub(mul(sz, dx2), mul(dy, sz2));
+                    store(s->vx + i, mul_add(curlX, k, load(s->vx + i)));
+                    store(s->vy + i, mul_add(curlY, k, load(s->vy + i)));
+                    store(s->vz + i, mul_add(curlZ, k, load(s->vz + i)));
+                }
+                break;
+            }
+
+            case FORCE_DRAG: {
+                float d = 1.0f - field.strength * dt;
+                F32x8 damp = set1(d > 0.0f ? d : 0.0f);
+                for (int b = begin; b < end; ++b) {
+                    int i = b * kLanes;
+                    store(s->vx + i, mul(load(s->vx + i), damp));
+                    store(s->vy + i, mul(load(s->vy + i), damp));
+                    store(s->vz + i, mul(load(s->vz + i), damp));
+                }
+                break;
+            }
+
+            case FORCE_PLANE: {
+                if (!normalize3(ax, ay, az)) { ax = 0; ay = 1; az = 0; }
+                F32x8 nx = set1(ax), ny = set1(ay), nz = set1(az);
+                F32x8 zero = set1(0.0f);
+                F32x8 restitution = set1(-(1.0f + field.bounce));
+                for (int b = begin; b < end; ++b) {
+                    int i = b * kLanes;
+                    F32x8 x = load(s->x + i), y = load(s->y + i), z = load(s->z + i);
+                    F32x8 dist = mul_add(sub(x, cx), nx, mul_add(sub(y, cy), ny, mul(sub(z, cz), nz)));
+                    // Push penetrating particles back onto the plane...
+                    F32x8 pen = simd::min(dist, zero);
+                    store(s->x + i, sub(x, mul(pen, nx)));
+                    store(s->y + i, sub(y, mul(pen, ny)));
+                    store(s->z + i, sub(z, mul(pen, nz)));
+                    // ...and reflect their inward normal velocity
+                    F32x8 vx = load(s->vx + i), vy = load(s->vy + i), vz = load(s->vz + i);
+                    F32x8 vn = mul_add(vx, nx, mul_add(vy, ny, mul(vz, nz)));
+                    F32x8 impulse = mul(select_lt(dist, zero, simd::min(vn, zero)), restitution);
+                    store(s->vx + i, mul_add(impulse, nx, vx));
+                    store(s->vy + i, mul_add(impulse, ny, vy));
+                    store(s->vz + i, mul_add(impulse, nz, vz));
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    // Body near a particle cluster, with its rotation and bounds precomputed
+    struct CollisionCandidate {
+        const NativeBody* body;
+        float c, s;
+        AABB bounds;  // Grown by the particle radius
+    };
+
+    // Candidates for one particle cluster, reused across frames
+    struct CollisionQuery {
+        const PhysicsWorld* world;
+        const ParticleCollision* params;
+        std::vector<CollisionCandidate> candidates;
+        std::vector<int> tileStart;   // Counting sort of particles into tiles
+        std::vector<int> tileOrder;
+        std::vector<int> particleTile;
+    };
+    thread_local CollisionQuery t_collisionQuery;
+
+    bool collect_collision_body(uint32_t bodyId, void* context) {
+        CollisionQuery* q = (CollisionQuery*)context;
+        if (bodyId >= (uint32_t)q->world->activeCount) return true;
+        const NativeBody& b = q->world->bodies[bodyId];
+        if (b.type == DYNAMIC || b.isSensor) return true;
+        if ((b.categoryBits & q->params->maskBits) == 0 || (b.maskBits & q->params->categoryBits) == 0) return true;
+
+        CollisionCandidate cand;
+        cand.body = &b;
+        cand.c = flash_cos(b.rotation);
+        cand.s = flash_sin(b.rotation);
+        cand.bounds = calculate_body_aabb(b);
+        cand.bounds.fatten(q->params->radius);
+        q->candidates.push_back(cand);
+        return true;
+    }
+
+    // Penetration of a disc (px, py, r) into a body: outward normal and depth.
+    // Boxes use the box grown by r (square corners), which is plenty for particles.
+    bool particle_contact(const CollisionCandidate& cand, float px, float py, float r, float& nx, float& ny, float& depth) {
+        const NativeBody& b = *cand.body;
+        float dx = px - b.x, dy = py - b.y;
+        if (b.shapeType == SHAPE_CIRCLE) {
+            float reach = b.radius + r;
+            float d2 = dx * dx + dy * dy;
+            if (d2 >= reach * reach) return false;
+            float d = sqrtf(d2);
+            if (d > 1e-6f) { nx = dx / d; ny = dy / d; } else { nx = 0; ny = 1; }
+            depth = reach - d;
+            return true;
+        }
+        float c = cand.c, s = cand.s;
+        float lx = dx * c + dy * s;
+        float ly = -dx * s + dy * c;
+        float ex = b.width * 0.5f + r - fabsf(lx);
+        float ey = b.height * 0.5f + r - fabsf(ly);
+        if (ex <= 0 || ey <= 0) return false;
+        // Leave through the nearest face
+        float lnx = 0, lny = 0;
+        if (ex < ey) { lnx = lx < 0 ? -1.0f : 1.0f; depth = ex; }
+        else { lny = ly < 0 ? -1.0f : 1.0f; depth = ey; }
+        nx = lnx * c - lny * s;
+        ny = lnx * s + lny * c;
+        return true;
+    }
+
+    // Collides batches [begin, end) against the bound world. Particles are
+    // binned into a grid of tiles over the range's bounds and the broadphase
+    // is queried once per occupied tile; particles then test only that tile's
+    // candidates. Returns true if a particle was killed.
+    bool collide_streams(ParticleStreams* s, const ParticleEmitter* e, int begin, int end) {
+        const ParticleCollision& params = *e->collision;
+        const PhysicsWorld* world = params.world;
+        float r = params.radius;
+        CollisionQuery& q = t_collisionQuery;
+        q.world = world;
+        q.params = &params;
+        bool killed = false;
+
+        int first = begin * simd::kLanes;
+        int last = std::min(end * simd::kLanes, e->activeCount);
+        int count = last - first;
+        if (count <= 0) return false;
+
+        float minX = s->x[first], maxX = minX, minY = s->y[first], maxY = minY;
+        for (int i = first + 1; i < last; ++i) {
+            minX = std::min(minX, s->x[i]); maxX = std::max(maxX, s->x[i]);
+            minY = std::min(minY, s->y[i]); maxY = std::max(maxY, s->y[i]);
+        }
+        int tiles = (int)sqrtf((float)count / kCollisionTileSize);
+        tiles = std::max(1, std::min(tiles, kMaxCollisionTiles));
+        float tileW = std::max((maxX - minX) / tiles, 1e-3f);
+        float tileH = std::max((maxY - minY) / tiles, 1e-3f);
+        float invW = 1.0f / tileW, invH = 1.0f / tileH;
+
+        q.tileStart.assign(tiles * tiles + 1, 0);
+        q.tileOrder.resize(count);
+        q.particleTile.resize(count);
+        for (int i = 0; i < count; ++i) {
+            int tx = std::min((int)((s->x[first + i] - minX) * invW), tiles - 1);
+            int ty = std::min((int)((s->y[first + i] - minY) * invH), tiles - 1);
+            q.particleTile[i] = ty * tiles + tx;
+            q.tileStart[q.particleTile[i] + 1]++;
+        }
+        for (int t = 0; t < tiles * tiles; ++t) q.tileStart[t + 1] += q.tileStart[t];
+        // Scatter; afterwards tileStart[t] is the end of tile t
+        for (int i = 0; i < count; ++i) q.tileOrder[q.tileStart[q.particleTile[i]]++] = first + i;
+        for (int t = 0; t < tiles * tiles; ++t) {
+            int tBegin = t > 0 ? q.tileStart[t - 1] : 0;
+            int tEnd = q.tileStart[t];
+            if (tBegin == tEnd) continue;
+
+            AABB bounds;
+            bounds.minX = minX + (t % tiles) * tileW;
+            bounds.minY = minY + (t / tiles) * tileH;
+            bounds.maxX = bounds.minX + tileW;
+            bounds.maxY = bounds.minY + tileH;
+            bounds.fatten(r);
+            q.candidates.clear();
+            tree_query(world->tree, bounds, collect_collision_body, &q);
+            if (q.candidates.empty()) continue;
+
+            for (int n = tBegin; n < tEnd; ++n) {
+                int i = q.tileOrder[n];
+                for (size_t k = 0; k < q.candidates.size(); ++k) {
+                    const CollisionCandidate& cand = q.candidates[k];
+                    float px = s->x[i], py = s->y[i];
+                    if (px < cand.bounds.minX || px > cand.bounds.maxX || py < cand.bounds.minY || py > cand.bounds.maxY) continue;
+                    const NativeBody& b = *cand.body;
+                    float nx, ny, depth;
+                    if (!particle_contact(cand, px, py, r, nx, ny, depth)) continue;
+
+                    if (params.response == COLLIDE_KILL) {
+                        s->life[i] = 0.0f;
+                        killed = true;
+                        break;
+                    }
+                    s->x[i] += nx * depth;
+                    s->y[i] += ny * depth;
+                    if (params.response == COLLIDE_STICK) {
+                        s->vx[i] = b.vx; s->vy[i] = b.vy; s->vz[i] = 0.0f;
+                        continue;
+                    }
+                    // Bounce relative to the (kinematic) body's velocity
+                    float rvx = s->vx[i] - b.vx, rvy = s->vy[i] - b.vy;
+                    float vn = rvx * nx + rvy * ny;
+                    if (vn >= 0) continue;  // Already separating
+                    float tx = rvx - vn * nx, ty = rvy - vn * ny;
+                    float keep = 1.0f - params.friction;
+                    s->vx[i] = b.vx + tx * keep - vn * params.bounce * nx;
+                    s->vy[i] = b.vy + ty * keep - vn * params.bounce * ny;
+                }
+            }
+        }
+        return killed;
+    }
+
+    // One forward pass over all streams; survivors keep their order (and their trails)
+    int compact_streams(ParticleStreams* s, ParticleTrails* trails, int count) {
+        int w = 0;
+        for (int i = 0; i < count; ++i) {
+            if (s->life[i] <= 0) continue;
+            if (w != i) {
+                s->x[w] = s->x[i]; s->y[w] = s->y[i]; s->z[w] = s->z[i];
+                s->vx[w] = s->vx[i]; s->vy[w] = s->vy[i]; s->vz[w] = s->vz[i];
+                s->life[w] = s->life[i]; s->lifeRate[w] = s->lifeRate[i];
+                s->size[w] = s->size[i]; s->color[w] = s->color[i];
+                if (trails) {
+                    size_t slotFloats = (size_t)trails->length * 3;
+                    memcpy(trails->points + w * slotFloats, trails->points + i * slotFloats, slotFloats * sizeof(float));
+                    trails->counts[w] = trails->counts[i];
+                }
+            }
+            ++w;
+        }
+        return w;
+    }
+
+    // Pushes every live particle's position onto its ring once the interval
+    // has elapsed. All rings advance together, so the head is shared.
+    void record_trails(const ParticleStreams* s, ParticleTrails* trails, int count, float dt) {
+        trails->timer += dt;
+        if (trails->timer < trails->interval) return;
+        trails->timer = trails->interval > 0 ? fmodf(trails->timer, trails->interval) : 0.0f;
+
+        const int length = trails->length;
+        const int head = (trails->head + 1) % length;
+        trails->head = head;
+        parallel_for(count, kUpdateGrainSize, [s, trails, length, head](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                float* p = trails->points + ((size_t)i * length + head) * 3;
+                p[0] = s->x[i]; p[1] = s->y[i]; p[2] = s->z[i];
+                if (trails->counts[i] < length) trails->counts[i]++;
+            }
+        });
+    }
+
+    void free_trails(ParticleTrails* trails) {
+        if (!trails) return;
+        free(trails->points);
+        free(trails->counts);
+        free(trails);
+    }
+
+    // Writes one particle into slot (either layout); the caller owns activeCount
+    inline void store_particle(ParticleEmitter* emitter, int slot, float x, float y, float z, float vx, float vy, float vz, float maxLife, float size, uint32_t color) {
+        if (ParticleStreams* s = emitter->streams) {
+            s->x[slot] = x; s->y[slot] = y; s->z[slot] = z;
+            s->vx[slot] = vx; s->vy[slot] = vy; s->vz[slot] = vz;
+            s->life[slot] = 1.0f;
+            // Zero lifetime expires on the next update, like dt / 0 in the AoS path
+            s->lifeRate[slot] = maxLife > 0 ? 1.0f / maxLife : FLT_MAX;
+            s->size[slot] = size;
+            s->color[slot] = color;
+            if (emitter->trails) emitter->trails->counts[slot] = 0;
+            return;
+        }
+        NativeParticle& p = emitter->particles[slot];
+        p.x = x; p.y = y; p.z = z;
+        p.vx = vx; p.vy = vy; p.vz = vz;
+        p.life = 1.0f;
+        p.maxLife = maxLife;
+        p.size = size;
+        p.color = color;
+    }
+
+    // Counter-based RNG: random number `lane` of particle `index` is a pure
+    // hash of (seed, index, lane), so particles can be generated in any order
+    inline uint32_t hash32(uint32_t x) {
+        x ^= x >> 16; x *= 0x7feb352dU;
+        x ^= x >> 15; x *= 0x846ca68bU;
+        x ^= x >> 16;
+        return x;
+    }
+
+    struct BurstRng {
+        uint32_t key;
+        uint32_t lane;
+        // Uniform in [0, 1)
+        float next() { return (hash32(key + 0x9E3779B9U * ++lane) >> 8) * (1.0f / 16777216.0f); }
+        float range(float a, float b) { return a + (b - a) * next(); }
+    };
+
+    // Velocity box plus the Dart-side spread (rotate about X, then Z)
+    inline void box_velocity(const EmitterShapeDef& def, BurstRng& rng, float& vx, float& vy, float& vz) {
+        vx = rng.range(def.velMinX, def.velMaxX);
+        vy = rng.range(def.velMinY, def.velMaxY);
+        vz = rng.range(def.velMinZ, def.velMaxZ);
+        if (def.spreadAngle > 0) {
+            float ax = rng.range(-def.spreadAngle, def.spreadAngle);
+            float az = rng.range(-def.spreadAngle, def.spreadAngle);
+            float cx = cosf(ax), sx = sinf(ax), cz = cosf(az), sz = sinf(az);
+            float y1 = vy * cx - vz * sx;
+            float z1 = vy * sx + vz * cx;
+            float x2 = vx * cz - y1 * sz;
+            float y2 = vx * sz + y1 * cz;
+            vx = x2; vy = y2; vz = z1;
+        }
+    }
+
+    void burst_particles(ParticleEmitter* emitter, const EmitterShapeDef& def, int firstSlot, uint32_t firstCounter, int begin, int end) {
+        const float kTwoPi = 6.28318530718f;
+
+        // Cone basis: axis plus two perpendiculars
+        float ax = def.dirX, ay = def.dirY, az = def.dirZ;
+        float len = sqrtf(ax * ax + ay * ay + az * az);
+        if (len > 0) { ax /= len; ay /= len; az /= len; } else { ax = 0; ay = 1; az = 0; }
+        float ux, uy, uz;
+        if (fabsf(ax) < 0.9f) { ux = 0; uy = -az; uz = ay; } else { ux = az; uy = 0; uz = -ax; }
+        float ul = sqrtf(ux * ux + uy * uy + uz * uz);
+        ux /= ul; uy /= ul; uz /= ul;
+        float wx = ay * uz - az * uy, wy = az * ux - ax * uz, wz = ax * uy - ay * ux;
+        float cosSpread = cosf(def.spreadAngle);
+
+        for (int i = begin; i < end; ++i) {
+            BurstRng rng = {hash32(def.seed ^ hash32(firstCounter + (uint32_t)i)), 0};
+            float px = def.x, py = def.y, pz = def.z;
+            float vx = 0, vy = 0, vz = 0;
+
+            switch (def.shape) {
+                case EMIT_CONE: {
+                    // Uniform over the spherical cap around the axis
+                    float cosT = rng.range(cosSpread, 1.0f);
+                    float sinT = sqrtf(fmaxf(0.0f, 1.0f - cosT * cosT));
+                    float phi = rng.next() * kTwoPi;
+                    float cu = cosf(phi) * sinT, cw = sinf(phi) * sinT;
+                    float speed = rng.range(def.speedMin, def.speedMax);
+                    vx = (ax * cosT + ux * cu + wx * cw) * speed;
+                    vy = (ay * cosT + uy * cu + wy * cw) * speed;
+                    vz = (az * cosT + uz * cu + wz * cw) * speed;
+                    break;
+                }
+                case EMIT_SPHERE: {
+                    float dz = rng.range(-1.0f, 1.0f);
+                    float r = sqrtf(fmaxf(0.0f, 1.0f - dz * dz));
+                    float phi = rng.next() * kTwoPi;
+                    float dx = cosf(phi) * r, dy = sinf(phi) * r;
+                    float dist = def.radius * cbrtf(rng.next());
+                    float speed = rng.range(def.speedMin, def.speedMax);
+                    px += dx * dist; py += dy * dist; pz += dz * dist;
+                    vx = dx * speed; vy = dy * speed; vz = dz * speed;
+                    break;
+                }
+                case EMIT_RING: {
+                    float phi = rng.next() * kTwoPi;
+                    float dx = cosf(phi), dy = sinf(phi);
+                    float speed = rng.range(def.speedMin, def.speedMax);
+                    px += dx * def.radius; py += dy * def.radius;
+                    vx = dx * speed; vy = dy * speed;
+                    break;
+                }
+                case EMIT_BOX:
+                    px += rng.range(-def.halfX, def.halfX);
+                    py += rng.range(-def.halfY, def.halfY);
+                    pz += rng.range(-def.halfZ, def.halfZ);
+                    box_velocity(def, rng, vx, vy, vz);
+                    break;
+                default:
+                    box_velocity(def, rng, vx, vy, vz);
+                    break;
+            }
+
+            float life = rng.range(def.lifeMin, def.lifeMax);
+            float size = rng.range(def.sizeMin, def.sizeMax);
+            store_particle(emitter, firstSlot + i, px, py, pz, vx, vy, vz, life, size, def.color);
+        }
+    }
+
+    // Read access to either storage layout, so the fill passes exist once
+    struct AosSource {
+        const NativeParticle* p;
+        float x(int i) const { return p[i].x; }
+        float y(int i) const { return p[i].y; }
+        float z(int i) const { return p[i].z; }
+        float life(int i) const { return p[i].life; }
+        float size(int i) const { return p[i].size; }
+        uint32_t color(int i) const { return p[i].color; }
+    };
+
+    struct SoaSource {
+        const ParticleStreams* s;
+        float x(int i) const { return s->x[i]; }
+        float y(int i) const { return s->y[i]; }
+        float z(int i) const { return s->z[i]; }
+        float life(int i) const { return s->life[i]; }
+        float size(int i) const { return s->size[i]; }
+        uint32_t color(int i) const { return s->color[i]; }
+    };
+
+    struct ThreadWork {
+        int startIdx;
+        int endIdx;
+        int visibleCount;
+        std::vector<int> visibleIndices;
+        std::vector<uint32_t> depthKeys;  // Parallel to visibleIndices when depth sorting
+    };
+
+    // Projected particle: screen-space center and clamped half size
+    struct ScreenDisc {
+        float x, y;
+        float halfSize;
+        float rawHalfSize;  // Before clamping, for the sub-pixel cull
+    };
+
+    template <typename Source>
+    inline ScreenDisc project_particle(const Source& src, int idx, const float* m, const float* sizeCurve) {
+        float x = src.x(idx), y = src.y(idx), z = src.z(idx);
+        float wz = x * m[3] + y * m[7] + z * m[11] + m[15];
+        float invW = 1.0f / wz;
+        ScreenDisc d;
+        d.x = (x * m[0] + y * m[4] + z * m[8] + m[12]) * invW;
+        d.y = (x * m[1] + y * m[5] + z * m[9] + m[13]) * invW;
+        float life = src.life(idx);
+        float lifeScale = sizeCurve ? sample_curve(sizeCurve, life) : life;
+        d.rawHalfSize = (src.size(idx) * lifeScale * invW * 500.0f);
+        d.halfSize = d.rawHalfSize;
+        if (d.halfSize < 0.2f) d.halfSize = 0.2f;
+        if (d.halfSize > 50.0f) d.halfSize = 50.0f;
+        return d;
+    }
+
+    // Emitter cull and sort settings for one fill call (see ParticleEmitter)
+    struct FillParams {
+        bool rect;
+        float minX, minY, maxX, maxY;
+        float minSize;
+        bool sortByDepth;
+        const float* sizeCurve;      // NULL = size * life
+        const uint32_t* colorCurve;  // NULL = particle color, alpha = life
+        const ParticleTrails* trails;
+        const ParticleAtlas* atlas;
+    };
+
+    FillParams fill_params(const ParticleEmitter* emitter) {
+        FillParams c;
+        c.rect = emitter->viewMaxX > emitter->viewMinX && emitter->viewMaxY > emitter->viewMinY;
+        c.minX = emitter->viewMinX;
+        c.minY = emitter->viewMinY;
+        c.maxX = emitter->viewMaxX;
+        c.maxY = emitter->viewMaxY;
+        c.minSize = emitter->minScreenSize;
+        c.sortByDepth = emitter->sortMode == 1;
+        const ParticleCurves* curves = emitter->curves;
+        c.sizeCurve = (curves && (curves->flags & CURVE_SIZE)) ? curves->size : NULL;
+        c.colorCurve = (curves && (curves->flags & CURVE_COLOR)) ? curves->color : NULL;
+        c.trails = emitter->trails;
+        c.atlas = emitter->atlas;
+        return c;
+    }
+
+    // Radix key that sorts descending NDC depth (farthest first) as ascending uint32
+    inline uint32_t back_to_front_key(float depth) {
+        uint32_t u;
+        memcpy(&u, &depth, sizeof(u));
+        // Flip so float order becomes unsigned order, then invert for descending
+        uint32_t ascending = u ^ ((uint32_t)(-(int32_t)(u >> 31)) | 0x80000000u);
+        return ~ascending;
+    }
+
+    template <typename Source>
+    void fill_chunk_pass1(const Source& src, float* m, const FillParams& params, ThreadWork& work) {
+        FLASH_TRACE_ZONE("fill_cull");
+        int range = work.endIdx - work.startIdx;
+        work.visibleIndices.resize(range);
+        if (params.sortByDepth) work.depthKeys.resize(range);
+        int* out = work.visibleIndices.data();
+        uint32_t* keys = work.depthKeys.data();
+        bool project = params.rect || params.minSize > 0;
+        int n = 0;
+
+        // Branch-free: always write the index, advance only if it's kept
+        // (visibility of scattered particles is unpredictable)
+        for (int i = work.startIdx; i < work.endIdx; ++i) {
+            float wz = src.x(i) * m[3] + src.y(i) * m[7] + src.z(i) * m[11] + m[15];
+            bool keep = wz >= 0.1f;
+            if (project) {
+                ScreenDisc d = project_particle(src, i, m, params.sizeCurve);
+                keep &= d.rawHalfSize >= params.minSize;
+                if (params.rect) {
+                    keep &= (d.x + d.halfSize >= params.minX) & (d.x - d.halfSize <= params.maxX) &
+                            (d.y + d.halfSize >= params.minY) & (d.y - d.halfSize <= params.maxY);
+                }
+            }
+            if (params.sortByDepth) {
+                float zc = src.x(i) * m[2] + src.y(i) * m[6] + src.z(i) * m[10] + m[14];
+                keys[n] = back_to_front_key(zc / wz);
+            }
+            out[n] = i;
+            n += keep;
+        }
+        work.visibleIndices.resize(n);
+        work.visibleCount = n;
+    }
+
+    // Stable LSD radix sort of (key, value) pairs, 8 bits per pass. Each pass
+    // builds per-task histograms in parallel, prefix-sums them serially (256
+    // buckets x tasks) and scatters in parallel. Passes where every key has the
+    // same digit are skipped. Returns the buffer holding the sorted values
+    // (either values or valuesTmp).
+    struct RadixBuffers {
+        std::vector<uint32_t> keysTmp;
+        std::vector<int> valuesTmp;
+        std::vector<uint32_t> histograms;
+    };
+
+    int* radix_sort_pairs(uint32_t* keys, int* values, int count, RadixBuffers& buffers) {
+        FLASH_TRACE_ZONE("fill_depth_sort");
+        const int kBuckets = 256;
+        int taskCount = (count + kSortGrainSize - 1) / kSortGrainSize;
+        buffers.keysTmp.resize(count);
+        buffers.valuesTmp.resize(count);
+        buffers.histograms.resize((size_t)taskCount * kBuckets);
+
+        uint32_t* srcKeys = keys;
+        int* srcValues = values;
+        uint32_t* dstKeys = buffers.keysTmp.data();
+        int* dstValues = buffers.valuesTmp.data();
+        uint32_t* hist = buffers.histograms.data();
+
+        for (int shift = 0; shift < 32; shift += 8) {
+            parallel_for(taskCount, 1, [&](int begin, int end) {
+                for (int t = begin; t < end; ++t) {
+                    uint32_t h[kBuckets] = {0};
+                    int last = std::min(count, (t + 1) * kSortGrainSize);
+                    for (int i = t * kSortGrainSize; i < last; ++i) h[(srcKeys[i] >> shift) & 0xFF]++;
+                    memcpy(hist + t * kBuckets, h, sizeof(h));
+                }
+            });
+
+            // Bucket-major prefix: task t's share of bucket b follows task t-1's
+            uint32_t sum = 0;
+            bool trivial = false;
+            for (int b = 0; b < kBuckets; ++b) {
+                uint32_t bucketStart = sum;
+                for (int t = 0; t < taskCount; ++t) {
+                    uint32_t c = hist[t * kBuckets + b];
+                    hist[t * kBuckets + b] = sum;
+                    sum += c;
+                }
+                if (sum - bucketStart == (uint32_t)count) trivial = true;
+            }
+            if (trivial) continue;
+
+            parallel_for(taskCount, 1, [&](int begin, int end) {
+                for (int t = begin; t < end; ++t) {
+                    // Local copy: the compiler can't prove dstKeys doesn't alias hist
+                    uint32_t offsets[kBuckets];
+                    memcpy(offsets, hist + t * kBuckets, sizeof(offsets));
+                    int last = std::min(count, (t + 1) * kSortGrainSize);
+                    for (int i = t * kSortGrainSize; i < last; ++i) {
+                        uint32_t key = srcKeys[i];
+                        uint32_t slot = offsets[(key >> shift) & 0xFF]++;
+                        dstKeys[slot] = key;
+                        dstValues[slot] = srcValues[i];
+                    }
+                }
+            });
+            std::swap(srcKeys, dstKeys);
+            std::swap(srcValues, dstValues);
+        }
+        return srcValues;
+    }
+
+    // Unit polygon as x,y pairs, padded with zeros to whole SIMD batches. Built
+    // once per shape, so per-particle vertex generation is only multiply-adds.
+    // INDEXED: the SIDES corners (see build_particle_indices).
+    // Otherwise: fan-expanded, (SIDES - 2) triangles of corners (0, i, i+1).
+    template <int SIDES, bool INDEXED>
+    struct UnitPolygon {
+        enum {
+            kVertices = INDEXED ? SIDES : (SIDES - 2) * 3,
+            kFloats = kVertices * 2,
+            kBatches = kFloats / simd::kLanes,
+            kPadded = (kFloats + simd::kLanes - 1) & ~(simd::kLanes - 1)
+        };
+        alignas(32) float xy[kPadded];
+
+        UnitPolygon() {
+            float px[SIDES], py[SIDES];
+            for (int i = 0; i < SIDES; ++i) {
+                float angle = i * (2.0f * M_PI / SIDES);
+                px[i] = cosf(angle);
+                py[i] = sinf(angle);
+            }
+            int k = 0;
+            if (INDEXED) {
+                for (int i = 0; i < SIDES; ++i) {
+                    xy[k++] = px[i]; xy[k++] = py[i];
+                }
+            } else {
+                for (int i = 1; i < SIDES - 1; ++i) {
+                    xy[k++] = px[0]; xy[k++] = py[0];
+                    xy[k++] = px[i]; xy[k++] = py[i];
+                    xy[k++] = px[i+1]; xy[k++] = py[i+1];
+                }
+            }
+            while (k < kPadded) xy[k++] = 0.0f;
+        }
+
+        static const UnitPolygon& get() {
+            static const UnitPolygon table;
+            return table;
+        }
+    };
+
+    template <typename Source>
+    inline uint32_t particle_color(const Source& src, int idx, const FillParams& params) {
+        float life = src.life(idx);
+        if (params.colorCurve) return tint_color(src.color(idx), sample_color(params.colorCurve, life));
+        uint32_t alpha = (uint32_t)(life * 255.0f);
+        return (src.color(idx) & 0x00FFFFFF) | (alpha << 24);
+    }
+
+    template <typename Source, int SIDES, bool INDEXED>
+    void fill_polygons(const Source& src, const FillParams& params, float* m, float* vertices, uint32_t* colors, const int* indices, int count, int globalOffset) {
+        FLASH_TRACE_ZONE("fill_vertices");
+        typedef UnitPolygon<SIDES, INDEXED> Shape;
+        const Shape& shape = Shape::get();
+
+        float* out = vertices + globalOffset * Shape::kFloats;
+        uint32_t* outColors = colors + globalOffset * Shape::kVertices;
+
+        for (int n = 0; n < count; ++n) {
+            int idx = indices[n];
+            ScreenDisc d = project_particle(src, idx, m, params.sizeCurve);
+            float screenX = d.x, screenY = d.y, halfSize = d.halfSize;
+            uint32_t col = particle_color(src, idx, params);
+
+            // vertex = center + unit * halfSize, 4 vertices per batch
+            simd::F32x8 center = simd::set_pair(screenX, screenY);
+            simd::F32x8 scale = simd::set1(halfSize);
+            for (int b = 0; b < Shape::kBatches; ++b) {
+                int k = b * simd::kLanes;
+                simd::storeu(out + k, simd::mul_add(simd::load(shape.xy + k), scale, center));
+            }
+            for (int k = Shape::kBatches * simd::kLanes; k < Shape::kFloats; k += 2) {
+                out[k] = screenX + shape.xy[k] * halfSize;
+                out[k + 1] = screenY + shape.xy[k + 1] * halfSize;
+            }
+            out += Shape::kFloats;
+
+            for (int i = 0; i < Shape::kVertices; ++i) outColors[i] = col;
+            outColors += Shape::kVertices;
+        }
+    }
+
+    // One RSTransform {scos, ssin, tx, ty} and one color per particle: scales
+    // the PARTICLE_SPRITE_SIZE sprite to the particle's disc, top-left at tx,ty
+    template <typename Source>
+    void fill_sprites(const Source& src, const FillParams& params, float* m, float* transforms, uint32_t* colors, const int* indices, int count, int globalOffset) {
+        FLASH_TRACE_ZONE("fill_sprites");
+        const float toScale = 2.0f / PARTICLE_SPRITE_SIZE;
+        float* out = transforms + globalOffset * 4;
+        uint32_t* outColors = colors + globalOffset;
+        for (int n = 0; n < count; ++n) {
+            int idx = indices[n];
+            ScreenDisc d = project_particle(src, idx, m, params.sizeCurve);
+            out[0] = d.halfSize * toScale;
+            out[1] = 0.0f;
+            out[2] = d.x - d.halfSize;
+            out[3] = d.y - d.halfSize;
+            out += 4;
+            outColors[n] = particle_color(src, idx, params);
+        }
+    }
+
+    // Ribbon through the particle's position and its recorded points, newest
+    // first (see fill_trail_buffer). Sides are perpendicular to the screen-space
+    // direction at each point; zero-length steps keep the previous direction.
+    template <typename Source>
+    void fill_trails(const Source& src, const FillParams& params, float* m, float* vertices, uint32_t* colors, const int* indices, int count, int globalOffset) {
+        FLASH_TRACE_ZONE("fill_trails");
+        const ParticleTrails* trails = params.trails;
+        const int length = trails->length;
+        const int points = length + 1;
+        float* out = vertices + (size_t)globalOffset * points * 4;
+        uint32_t* outColors = colors + (size_t)globalOffset * points * 2;
+        float sx[PARTICLE_TRAIL_MAX_POINTS + 1], sy[PARTICLE_TRAIL_MAX_POINTS + 1];
+
+        for (int n = 0; n < count; ++n) {
+            int idx = indices[n];
+            ScreenDisc d = project_particle(src, idx, m, params.sizeCurve);
+            uint32_t col = particle_color(src, idx, params);
+
+            sx[0] = d.x;
+            sy[0] = d.y;
+            int recorded = trails->counts[idx];
+            const float* ring = trails->points + (size_t)idx * length * 3;
+            for (int j = 1, slot = trails->head; j <= recorded; ++j, slot = slot > 0 ? slot - 1 : length - 1) {
+                const float* p = ring + slot * 3;
+                float invW = 1.0f / (p[0] * m[3] + p[1] * m[7] + p[2] * m[11] + m[15]);
+                sx[j] = (p[0] * m[0] + p[1] * m[4] + p[2] * m[8] + m[12]) * invW;
+                sy[j] = (p[0] * m[1] + p[1] * m[5] + p[2] * m[9] + m[13]) * invW;
+            }
+            for (int j = recorded + 1; j < points; ++j) {
+                sx[j] = sx[recorded];
+                sy[j] = sy[recorded];
+            }
+
+            // Start with the first non-degenerate segment's direction
+            float nx = 0.0f, ny = 0.0f;
+            for (int j = 0; j < recorded; ++j) {
+                float dx = sx[j] - sx[j + 1], dy = sy[j] - sy[j + 1];
+                float len2 = dx * dx + dy * dy;
+                if (len2 > 1e-8f) {
+                    float inv = 1.0f / sqrtf(len2);
+                    nx = -dy * inv;
+                    ny = dx * inv;
+                    break;
+                }
+            }
+
+            float alpha = (float)(col >> 24);
+            uint32_t rgb = col & 0x00FFFFFF;
+            float invRecorded = recorded > 0 ? 1.0f / recorded : 0.0f;
+            for (int j = 0; j < points; ++j) {
+                int a = j > 0 ? j - 1 : 0;
+                int b = j < recorded ? j + 1 : j;
+                float dx = sx[a] - sx[b], dy = sy[a] - sy[b];
+                float len2 = dx * dx + dy * dy;
+                if (len2 > 1e-8f) {
+                    float inv = 1.0f / sqrtf(len2);
+                    nx = -dy * inv;
+                    ny = dx * inv;
+                }
+
+                float t = std::min(j * invRecorded, 1.0f);
+                float half = d.halfSize * (1.0f + (trails->tailWidth - 1.0f) * t);
+                uint32_t c = rgb | ((uint32_t)(alpha * (1.0f + (trails->tailAlpha - 1.0f) * t)) << 24);
+                out[0] = sx[j] + nx * half;
+                out[1] = sy[j] + ny * half;
+                out[2] = sx[j] - nx * half;
+                out[3] = sy[j] - ny * half;
+                out += 4;
+                outColors[0] = c;
+                outColors[1] = c;
+                outColors += 2;
+            }
+        }
+    }
+
+    // Screen-aligned square around the particle's disc, with the UVs of the atlas
+    // cell its age selects (see ParticleAtlas)
+    template <typename Source>
+    void fill_textured(const Source& src, const FillParams& params, float* m, float* vertices, uint32_t* colors, float* uvs, const int* indices, int count, int globalOffset) {
+        FLASH_TRACE_ZONE("fill_textured");
+        const ParticleAtlas& atlas = *params.atlas;
+        const int columns = atlas.columns > 0 ? atlas.columns : 1;
+        const int rows = atlas.rows > 0 ? atlas.rows : 1;
+        const int cells = columns * rows;
+        const int frames = atlas.frameCount > 0 ? atlas.frameCount : 1;
+        const float framesPerAge = frames * atlas.cycles;
+        const float cellW = atlas.width / columns, cellH = atlas.height / rows;
+
+        float* out = vertices + (size_t)globalOffset * 8;
+        float* outUvs = uvs + (size_t)globalOffset * 8;
+        uint32_t* outColors = colors + (size_t)globalOffset * 4;
+        for (int n = 0; n < count; ++n) {
+            int idx = indices[n];
+            ScreenDisc d = project_particle(src, idx, m, params.sizeCurve);
+            uint32_t col = particle_color(src, idx, params);
+
+            float age = 1.0f - src.life(idx);
+            int frame = (int)(std::min(std::max(age, 0.0f), 1.0f) * framesPerAge);
+            int cell = (atlas.firstFrame + frame % frames) % cells;
+            float u0 = (cell % columns) * cellW, v0 = (cell / columns) * cellH;
+            float u1 = u0 + cellW, v1 = v0 + cellH;
+
+            float x0 = d.x - d.halfSize, y0 = d.y - d.halfSize;
+            float x1 = d.x + d.halfSize, y1 = d.y + d.halfSize;
+            out[0] = x0; out[1] = y0; out[2] = x1; out[3] = y0;
+            out[4] = x1; out[5] = y1; out[6] = x0; out[7] = y1;
+            outUvs[0] = u0; outUvs[1] = v0; outUvs[2] = u1; outUvs[3] = v0;
+            outUvs[4] = u1; outUvs[5] = v1; outUvs[6] = u0; outUvs[7] = v1;
+            out += 8;
+            outUvs += 8;
+            for (int i = 0; i < 4; ++i) outColors[i] = col;
+            outColors += 4;
+        }
+    }
+
+    template <typename Source, int LAYOUT>
+    void fill_chunk_pass2(const Source& src, int shapeType, const FillParams& params, float* m, float* vertices, uint32_t* colors, float* uvs, const int* indices, int count, int globalOffset) {
+        const bool kIndexed = LAYOUT == LAYOUT_CORNERS;
+        if (LAYOUT == LAYOUT_TEXTURED) {
+            fill_textured(src, params, m, vertices, colors, uvs, indices, count, globalOffset);
+            return;
+        }
+        if (LAYOUT == LAYOUT_SPRITES) {
+            fill_sprites(src, params, m, vertices, colors, indices, count, globalOffset);
+            return;
+        }
+        if (LAYOUT == LAYOUT_TRAILS) {
+            fill_trails(src, params, m, vertices, colors, indices, count, globalOffset);
+            return;
+        }
+        switch (shapeType) {
+            case 1: fill_polygons<Source, 6, kIndexed>(src, params, m, vertices, colors, indices, count, globalOffset); break;
+            case 2: fill_polygons<Source, 8, kIndexed>(src, params, m, vertices, colors, indices, count, globalOffset); break;
+            case 3: fill_polygons<Source, 12, kIndexed>(src, params, m, vertices, colors, indices, count, globalOffset); break;
+            case 4: fill_polygons<Source, 3, kIndexed>(src, params, m, vertices, colors, indices, count, globalOffset); break;
+            default: fill_polygons<Source, 4, kIndexed>(src, params, m, vertices, colors, indices, count, globalOffset); break;
+        }
+    }
+
+    int shape_sides(int shapeType) {
+        switch (shapeType) {
+            case 1: return 6;
+            case 2: return 8;
+            case 3: return 12;
+            case 4: return 3;
+            default: return 4;
+        }
+    }
+
+    // Reused between frames by the (single) rendering thread
+    struct DepthSortBuffers {
+        std::vector<uint32_t> keys;
+        std::vector<int> indices;
+        RadixBuffers radix;
+    };
+    thread_local DepthSortBuffers t_depthSort;
+
+    // One emitter's share of a (multi-emitter) fill
+    struct EmitterFill {
+        const ParticleEmitter* emitter;
+        FillParams params;
+        int firstChunk, chunkCount;
+        int visible;
+        int firstVertex;  // Start of the emitter's output in the shared buffers
+    };
+
+    // Output records per particle and floats per record of a ParticleVertexLayout
+    inline int vertices_per_particle(const ParticleEmitter* e, int layout) {
+        if (layout == LAYOUT_TRAILS) return e->trails ? 2 * (e->trails->length + 1) : 0;
+        if (layout == LAYOUT_TEXTURED) return 4;
+        int sides = shape_sides(e->shapeType);
+        return layout == LAYOUT_SPRITES ? 1 : layout == LAYOUT_CORNERS ? sides : (sides - 2) * 3;
+    }
+
+    inline int floats_per_vertex(int layout) {
+        return layout == LAYOUT_SPRITES ? 4 : 2;
+    }
+
+    void fill_pass1(const EmitterFill& f, float* m, ThreadWork& work) {
+        if (f.emitter->streams) {
+            SoaSource src = {f.emitter->streams};
+            fill_chunk_pass1(src, m, f.params, work);
+        } else {
+            AosSource src = {f.emitter->particles};
+            fill_chunk_pass1(src, m, f.params, work);
+        }
+    }
+
+    // indices/offset are relative to the emitter
+    template <int LAYOUT>
+    void fill_pass2(const EmitterFill& f, float* m, float* vertices, uint32_t* colors, float* uvs, const int* indices, int count, int offset) {
+        float* v = vertices + (size_t)f.firstVertex * floats_per_vertex(LAYOUT);
+        uint32_t* c = colors + f.firstVertex;
+        float* uv = uvs ? uvs + (size_t)f.firstVertex * 2 : NULL;
+        if (f.emitter->streams) {
+            SoaSource src = {f.emitter->streams};
+            fill_chunk_pass2<SoaSource, LAYOUT>(src, f.emitter->shapeType, f.params, m, v, c, uv, indices, count, offset);
+        } else {
+            AosSource src = {f.emitter->particles};
+            fill_chunk_pass2<AosSource, LAYOUT>(src, f.emitter->shapeType, f.params, m, v, c, uv, indices, count, offset);
+        }
+    }
+
+    // Fills emitters back to back into one pair of buffers. Culling runs as one
+    // parallel pass over the chunks of all emitters, then one pass emits the
+    // geometry of every unsorted emitter; depth-sorted emitters sort and emit
+    // one after another. ranges (optional) receives {firstVertex, visibleCount}
+    // per emitter. Returns the total vertex count.
+    // Chunk state reused between frames by the rendering thread, so steady
+    // frames don't allocate
+    struct FillScratch {
+        std::vector<EmitterFill> fills;
+        std::vector<ThreadWork> works;
+        std::vector<int> workEmitter;
+        std::vector<int> offsets;
+    };
+    thread_local FillScratch t_fillScratch;
+
+    template <int LAYOUT>
+    int fill_emitters(ParticleEmitter* const* emitters, int emitterCount, float* m, float* vertices, uint32_t* colors, float* uvs, int maxRenderCount, int32_t* ranges) {
+        // Fixed-size chunks on the shared job pool (see jobs.h); a single chunk
+        // runs inline without any scheduling
+        FillScratch& scratch = t_fillScratch;
+        std::vector<EmitterFill>& fills = scratch.fills;
+        std::vector<ThreadWork>& works = scratch.works;
+        std::vector<int>& workEmitter = scratch.workEmitter;
+        fills.resize(emitterCount);
+        workEmitter.clear();
+        int chunkCount = 0;
+        int budget = maxRenderCount;
+        for (int i = 0; i < emitterCount; ++i) {
+            const ParticleEmitter* e = emitters[i];
+            EmitterFill& f = fills[i];
+            f.emitter = e;
+            f.firstChunk = chunkCount;
+            f.chunkCount = 0;
+            f.visible = 0;
+            f.firstVertex = 0;
+            if (!e || (!e->particles && !e->streams) || e->activeCount == 0 || budget <= 0) continue;
+            if (LAYOUT == LAYOUT_TRAILS && !e->trails) continue;
+            if (LAYOUT == LAYOUT_TEXTURED && !e->atlas) continue;
+
+            int total = std::min(e->activeCount, budget);
+            budget -= total;
+            f.params = fill_params(e);
+            f.chunkCount = (total + kFillChunkSize - 1) / kFillChunkSize;
+            chunkCount += f.chunkCount;
+            if ((int)works.size() < chunkCount) works.resize(chunkCount);
+            for (int c = 0; c < f.chunkCount; ++c) {
+                ThreadWork& work = works[f.firstChunk + c];
+                work.startIdx = c * kFillChunkSize;
+                work.endIdx = std::min(total, (c + 1) * kFillChunkSize);
+                work.visibleCount = 0;
+                workEmitter.push_back(i);
+            }
+        }
+
+        parallel_for(chunkCount, 1, [&](int begin, int end) {
+            for (int c = begin; c < end; ++c) fill_pass1(fills[workEmitter[c]], m, works[c]);
+        });
+
+        int totalVertices = 0;
+        bool anyUnsorted = false;
+        std::vector<int>& offsets = scratch.offsets;
+        offsets.resize(chunkCount);
+        for (int i = 0; i < emitterCount; ++i) {
+            EmitterFill& f = fills[i];
+            for (int c = f.firstChunk; c < f.firstChunk + f.chunkCount; ++c) {
+                offsets[c] = f.visible;
+                f.visible += works[c].visibleCount;
+            }
+            f.firstVertex = totalVertices;
+            if (f.visible > 0) {
+                totalVertices += f.visible * vertices_per_particle(f.emitter, LAYOUT);
+                anyUnsorted = anyUnsorted || !f.params.sortByDepth;
+            }
+            if (ranges) {
+                ranges[i * 2] = f.firstVertex;
+                ranges[i * 2 + 1] = f.visible;
+            }
+        }
+        if (totalVertices == 0) return 0;
+
+        if (anyUnsorted) {
+            parallel_for(chunkCount, 1, [&](int begin, int end) {
+                for (int c = begin; c < end; ++c) {
+                    const EmitterFill& f = fills[workEmitter[c]];
+                    if (f.params.sortByDepth || works[c].visibleCount == 0) continue;
+                    fill_pass2<LAYOUT>(f, m, vertices, colors, uvs, works[c].visibleIndices.data(), works[c].visibleCount, offsets[c]);
+                }
+            });
+        }
+
+        // Back to front: gather the chunks' keys, sort, then emit in sorted order
+        for (int i = 0; i < emitterCount; ++i) {
+            const EmitterFill& f = fills[i];
+            if (f.visible == 0 || !f.params.sortByDepth) continue;
+
+            DepthSortBuffers& sort = t_depthSort;
+            sort.keys.resize(f.visible);
+            sort.indices.resize(f.visible);
+            parallel_for(f.chunkCount, 1, [&](int begin, int end) {
+                for (int c = f.firstChunk + begin; c < f.firstChunk + end; ++c) {
+                    std::copy(works[c].depthKeys.begin(), works[c].depthKeys.begin() + works[c].visibleCount, sort.keys.begin() + offsets[c]);
+                    std::copy(works[c].visibleIndices.begin(), works[c].visibleIndices.end(), sort.indices.begin() + offsets[c]);
+                }
+            });
+            const int* sorted = radix_sort_pairs(sort.keys.data(), sort.indices.data(), f.visible, sort.radix);
+
+            int sortedChunks = (f.visible + kFillChunkSize - 1) / kFillChunkSize;
+            parallel_for(sortedChunks, 1, [&](int begin, int end) {
+                for (int c = begin; c < end; ++c) {
+                    int first = c * kFillChunkSize;
+                    int n = std::min(f.visible - first, kFillChunkSize);
+                    fill_pass2<LAYOUT>(f, m, vertices, colors, uvs, sorted + first, n, first);
+                }
+            });
+        }
+        return totalVertices;
+    }
+
+    template <int LAYOUT>
+    int fill_emitter(ParticleEmitter* emitter, float* m, float* vertices, uint32_t* colors, float* uvs, int maxRenderCount) {
+        int32_t range[2];
+        fill_emitters<LAYOUT>(&emitter, 1, m, vertices, colors, uvs, maxRenderCount, range);
+        return range[1];
+    }
+}
 
 extern "C" {
 
+ParticleEmitter* create_particle_emitter(int maxParticles, int shapeType) {
+    if (maxParticles <= 0) return NULL;
+    ParticleStreams* streams = create_streams(maxParticles);
+    if (!streams) return NULL;
+
+    ParticleEmitter* emitter = (ParticleEmitter*)calloc(1, sizeof(ParticleEmitter));
+    emitter->maxParticles = maxParticles;
+    emitter->shapeType = shapeType;
+    emitter->streams = streams;
+    return emitter;
+}
+
+void destroy_particle_emitter(ParticleEmitter* emitter) {
+    if (!emitter) return;
+    if (emitter->streams) {
+        free(emitter->streams->block);
+        free(emitter->streams);
+    }
+    free_trails(emitter->trails);
+    free(emitter);
+}
+
 void update_particles(ParticleEmitter* emitter, float dt) {
-    if (!emitter || !emitter->particles) return;
+    FLASH_TRACE_ZONE("update_particles");
+    if (!emitter) return;
 
-    for (int i = emitter->activeCount - 1; i >= 0; --i) {
-        NativeParticle& p = emitter->particles[i];
+    if (ParticleStreams* s = emitter->streams) {
+        if (emitter->activeCount == 0) return;
 
-        p.x += p.vx * dt;
-        p.y += p.vy * dt;
-        p.z += p.vz * dt;
+        // Whole 8-lane batches; the padding lanes are integrated too but never read
+        int batches = simd::padded_count(emitter->activeCount) / simd::kLanes;
+        std::atomic<int> anyDead(0);
+        bool drag = drag_curve(emitter) != NULL;
+        parallel_for(batches, kUpdateGrainSize / simd::kLanes, [&](int begin, int end) {
+            bool died = drag ? integrate_streams<true>(s, emitter, dt, begin, end) : integrate_streams<false>(s, emitter, dt, begin, end);
+            if (emitter->forceFields) apply_force_fields(s, emitter, dt, begin, end);
+            if (emitter->collision && emitter->collision->world) died = collide_streams(s, emitter, begin, end) || died;
+            if (died) anyDead.store(1, std::memory_order_relaxed);
+        });
+
+        // Most frames nothing expires, so the compaction pass is skipped
+        if (anyDead.load()) emitter->activeCount = compact_streams(s, emitter->trails, emitter->activeCount);
+        if (emitter->trails) record_trails(s, emitter->trails, emitter->activeCount, dt);
+        return;
+    }
 
-        p.vx += emitter->gravityX * dt;
-        p.vy += emitter->gravityY * dt;
-        p.vz += emitter->gravityZ * dt;
+    if (!emitter->particles) return;
 
-        p.life -= dt / p.maxLife;
+    // Integrate in parallel; particles are independent
+    const float* drag = drag_curve(emitter);
+    parallel_for(emitter->activeCount, kUpdateGrainSize, [emitter, dt, drag](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            NativeParticle& p = emitter->particles[i];
 
-        if (p.life <= 0) {
+            p.x += p.vx * dt;
+            p.y += p.vy * dt;
+            p.z += p.vz * dt;
+
+            p.vx += emitter->gravityX * dt;
+            p.vy += emitter->gravityY * dt;
+            p.vz += emitter->gravityZ * dt;
+
+            if (drag) {
+                float d = 1.0f - sample_curve(drag, p.life) * dt;
+                if (d < 0.0f) d = 0.0f;
+                p.vx *= d; p.vy *= d; p.vz *= d;
+            }
+
+            p.life -= dt / p.maxLife;
+        }
+    });
+
+    // Remove dead particles (swap with last, same order as before)
+    for (int i = emitter->activeCount - 1; i >= 0; --i) {
+        if (emitter->particles[i].life <= 0) {
             if (i < emitter->activeCount - 1) {
                 emitter->particles[i] = emitter->particles[emitter->activeCount - 1];
             }
@@ -31,136 +1309,138 @@ void update_particles(ParticleEmitter* emitter, float dt) {
 }
 
 void spawn_particle(ParticleEmitter* emitter, float x, float y, float z, float vx, float vy, float vz, float maxLife, float size, uint32_t color) {
-    if (!emitter || !emitter->particles || emitter->activeCount >= emitter->maxParticles) return;
-
-    NativeParticle& p = emitter->particles[emitter->activeCount++];
-    p.x = x; p.y = y; p.z = z;
-    p.vx = vx; p.vy = vy; p.vz = vz;
-    p.life = 1.0f;
-    p.maxLife = maxLife;
-    p.size = size;
-    p.color = color;
+    if (!emitter || (!emitter->particles && !emitter->streams) || emitter->activeCount >= emitter->maxParticles) return;
+    store_particle(emitter, emitter->activeCount++, x, y, z, vx, vy, vz, maxLife, size, color);
 }
 
-struct ThreadWork {
-    int startIdx;
-    int endIdx;
-    int visibleCount;
-    std::vector<int> visibleIndices;
-};
+int spawn_burst(ParticleEmitter* emitter, int count, EmitterShapeDef* def) {
+    FLASH_TRACE_ZONE("spawn_burst");
+    if (!emitter || !def || (!emitter->particles && !emitter->streams)) return 0;
+    int spawned = std::min(count, emitter->maxParticles - emitter->activeCount);
+    if (spawned <= 0) return 0;
 
-void fill_chunk_pass1(ParticleEmitter* emitter, float* m, ThreadWork& work) {
-    work.visibleCount = 0;
-    work.visibleIndices.clear();
-    work.visibleIndices.reserve(work.endIdx - work.startIdx);
+    int firstSlot = emitter->activeCount;
+    uint32_t firstCounter = def->counter;
+    const EmitterShapeDef& shape = *def;
+    parallel_for(spawned, kBurstGrainSize, [&](int begin, int end) {
+        burst_particles(emitter, shape, firstSlot, firstCounter, begin, end);
+    });
 
-    for (int i = work.startIdx; i < work.endIdx; ++i) {
-        NativeParticle& p = emitter->particles[i];
-        float wz = p.x * m[3] + p.y * m[7] + p.z * m[11] + m[15];
-        if (wz >= 0.1f) {
-            work.visibleIndices.push_back(i);
-            work.visibleCount++;
-        }
-    }
+    emitter->activeCount += spawned;
+    def->counter += (uint32_t)spawned;
+    return spawned;
 }
 
-void fill_chunk_pass2(ParticleEmitter* emitter, float* m, float* vertices, uint32_t* colors, const ThreadWork& work, int globalOffset) {
-    int sides = 4;
-    if (emitter->shapeType == 1) sides = 6;
-    else if (emitter->shapeType == 2) sides = 8;
-    else if (emitter->shapeType == 3) sides = 12;
-    else if (emitter->shapeType == 4) sides = 3;
+int fill_vertex_buffer(ParticleEmitter* emitter, float* m, float* vertices, uint32_t* colors, int maxRenderCount) {
+    FLASH_TRACE_ZONE("fill_vertex_buffer");
+    return fill_emitter<LAYOUT_TRIANGLES>(emitter, m, vertices, colors, NULL, maxRenderCount);
+}
 
-    int triCount = sides - 2;
-    int vCount = triCount * 3;
+int fill_vertex_buffer_indexed(ParticleEmitter* emitter, float* m, float* vertices, uint32_t* colors, int maxRenderCount) {
+    FLASH_TRACE_ZONE("fill_vertex_buffer_indexed");
+    return fill_emitter<LAYOUT_CORNERS>(emitter, m, vertices, colors, NULL, maxRenderCount);
+}
 
-    int vPtr = globalOffset * vCount * 2;
-    int cPtr = globalOffset * vCount;
+int fill_sprite_buffer(ParticleEmitter* emitter, float* m, float* transforms, uint32_t* colors, int maxRenderCount) {
+    FLASH_TRACE_ZONE("fill_sprite_buffer");
+    return fill_emitter<LAYOUT_SPRITES>(emitter, m, transforms, colors, NULL, maxRenderCount);
+}
 
-    for (int idx : work.visibleIndices) {
-        NativeParticle& p = emitter->particles[idx];
-        float wz = p.x * m[3] + p.y * m[7] + p.z * m[11] + m[15];
-        float invW = 1.0f / wz;
-        float screenX = (p.x * m[0] + p.y * m[4] + p.z * m[8] + m[12]) * invW;
-        float screenY = (p.x * m[1] + p.y * m[5] + p.z * m[9] + m[13]) * invW;
-        
-        float halfSize = (p.size * p.life * invW * 500.0f);
-        if (halfSize < 0.2f) halfSize = 0.2f;
-        if (halfSize > 50.0f) halfSize = 50.0f;
-        
-        uint32_t alpha = (uint32_t)(p.life * 255.0f);
-        uint32_t col = (p.color & 0x00FFFFFF) | (alpha << 24);
-
-        // Generate N-sided polygon vertices
-        float px[12], py[12];
-        for (int i = 0; i < sides; ++i) {
-            float angle = i * (2.0f * M_PI / sides);
-            px[i] = screenX + cosf(angle) * halfSize;
-            py[i] = screenY + sinf(angle) * halfSize;
-        }
-
-        // Fan-out triangles (0-i-(i+1))
-        for (int i = 1; i < sides - 1; ++i) {
-            vertices[vPtr++] = px[0]; vertices[vPtr++] = py[0];
-            vertices[vPtr++] = px[i]; vertices[vPtr++] = py[i];
-            vertices[vPtr++] = px[i+1]; vertices[vPtr++] = py[i+1];
-        }
+int32_t set_particle_trails(ParticleEmitter* emitter, int32_t length, float interval) {
+    if (!emitter || !emitter->streams) return 0;
+    if (length != 0 && (length < 2 || length > PARTICLE_TRAIL_MAX_POINTS)) return 0;
+    free_trails(emitter->trails);
+    emitter->trails = NULL;
+    if (length == 0) return 1;
 
-        for (int i = 0; i < vCount; ++i) colors[cPtr++] = col;
+    ParticleTrails* trails = (ParticleTrails*)calloc(1, sizeof(ParticleTrails));
+    if (!trails) return 0;
+    trails->points = (float*)calloc((size_t)emitter->maxParticles * length * 3, sizeof(float));
+    trails->counts = (uint8_t*)calloc(emitter->maxParticles, sizeof(uint8_t));
+    if (!trails->points || !trails->counts) {
+        free_trails(trails);
+        return 0;
     }
+    trails->length = length;
+    trails->interval = interval > 0 ? interval : 0.0f;
+    emitter->trails = trails;
+    return 1;
 }
 
-int fill_vertex_buffer(ParticleEmitter* emitter, float* m, float* vertices, uint32_t* colors, int maxRenderCount) {
-    if (!emitter || !emitter->particles || emitter->activeCount == 0) return 0;
+int fill_trail_buffer(ParticleEmitter* emitter, float* m, float* vertices, uint32_t* colors, int maxRenderCount) {
+    FLASH_TRACE_ZONE("fill_trail_buffer");
+    return fill_emitter<LAYOUT_TRAILS>(emitter, m, vertices, colors, NULL, maxRenderCount);
+}
 
-    int totalToProcess = std::min(emitter->activeCount, maxRenderCount);
-    
-    // Performance optimization: Avoid thread-spawning overhead for small-medium counts.
-    // std::thread is expensive to create every frame. 
-    // Single-threaded is often faster for up to 100k particles on modern CPUs.
-    if (totalToProcess < 100000) {
-        ThreadWork work;
-        work.startIdx = 0;
-        work.endIdx = totalToProcess;
-        fill_chunk_pass1(emitter, m, work);
-        if (work.visibleCount > 0) {
-            fill_chunk_pass2(emitter, m, vertices, colors, work, 0);
-        }
-        return work.visibleCount;
+int fill_vertex_buffer_multi(ParticleEmitter** emitters, int emitterCount, float* matrix, float* vertices, uint32_t* colors,
+                             int maxRenderCount, int32_t layout, int32_t* ranges) {
+    FLASH_TRACE_ZONE("fill_vertex_buffer_multi");
+    if (!emitters || emitterCount <= 0) return 0;
+    switch (layout) {
+        case LAYOUT_CORNERS: return fill_emitters<LAYOUT_CORNERS>(emitters, emitterCount, matrix, vertices, colors, NULL, maxRenderCount, ranges);
+        case LAYOUT_SPRITES: return fill_emitters<LAYOUT_SPRITES>(emitters, emitterCount, matrix, vertices, colors, NULL, maxRenderCount, ranges);
+        case LAYOUT_TEXTURED: return 0;
+        case LAYOUT_TRAILS: return fill_emitters<LAYOUT_TRAILS>(emitters, emitterCount, matrix, vertices, colors, NULL, maxRenderCount, ranges);
+        default: return fill_emitters<LAYOUT_TRIANGLES>(emitters, emitterCount, matrix, vertices, colors, NULL, maxRenderCount, ranges);
     }
+}
 
-    unsigned int numThreads = std::min((unsigned int)4, std::thread::hardware_concurrency());
-    if (numThreads < 1) numThreads = 1;
+int fill_textured_buffer(ParticleEmitter* emitter, float* m, float* vertices, uint32_t* colors, float* uvs, int maxRenderCount) {
+    FLASH_TRACE_ZONE("fill_textured_buffer");
+    if (!uvs) return 0;
+    return fill_emitter<LAYOUT_TEXTURED>(emitter, m, vertices, colors, uvs, maxRenderCount);
+}
 
-    std::vector<ThreadWork> works(numThreads);
-    std::vector<std::thread> threads;
-    int chunkSize = totalToProcess / numThreads;
+int fill_textured_buffer_multi(ParticleEmitter** emitters, int emitterCount, float* matrix, float* vertices,
+                               uint32_t* colors, float* uvs, int maxRenderCount, int32_t* ranges) {
+    FLASH_TRACE_ZONE("fill_textured_buffer_multi");
+    if (!emitters || emitterCount <= 0 || !uvs) return 0;
+    return fill_emitters<LAYOUT_TEXTURED>(emitters, emitterCount, matrix, vertices, colors, uvs, maxRenderCount, ranges);
+}
 
-    for (unsigned int t = 0; t < numThreads; ++t) {
-        works[t].startIdx = t * chunkSize;
-        works[t].endIdx = (t == numThreads - 1) ? totalToProcess : (t + 1) * chunkSize;
-        threads.emplace_back(fill_chunk_pass1, emitter, m, std::ref(works[t]));
-    }
-    for (auto& t : threads) t.join();
-    threads.clear();
+int particle_shape_sides(int shapeType) {
+    return shape_sides(shapeType);
+}
 
-    int totalVisible = 0;
-    std::vector<int> offsets(numThreads);
-    for (unsigned int t = 0; t < numThreads; ++t) {
-        offsets[t] = totalVisible;
-        totalVisible += works[t].visibleCount;
+int build_particle_indices(int shapeType, int particleCount, uint16_t* indices) {
+    int sides = shape_sides(shapeType);
+    if (!indices || particleCount <= 0 || particleCount * sides > 65536) return 0;
+
+    int k = 0;
+    for (int p = 0; p < particleCount; ++p) {
+        int base = p * sides;
+        for (int i = 1; i < sides - 1; ++i) {
+            indices[k++] = (uint16_t)base;
+            indices[k++] = (uint16_t)(base + i);
+            indices[k++] = (uint16_t)(base + i + 1);
+        }
     }
+    return k;
+}
 
-    if (totalVisible == 0) return 0;
+int particle_trail_vertices(int length) {
+    return 2 * (length + 1);
+}
+
+int build_trail_indices(int length, int particleCount, uint16_t* indices) {
+    int vertices = particle_trail_vertices(length);
+    if (!indices || length < 1 || particleCount <= 0 || particleCount * vertices > 65536) return 0;
 
-    for (unsigned int t = 0; t < numThreads; ++t) {
-        if (works[t].visibleCount > 0) {
-            threads.emplace_back(fill_chunk_pass2, emitter, m, vertices, colors, std::ref(works[t]), offsets[t]);
+    // Two triangles per segment between point j (2j left, 2j+1 right) and j+1
+    int k = 0;
+    for (int p = 0; p < particleCount; ++p) {
+        int base = p * vertices;
+        for (int j = 0; j < length; ++j) {
+            int v = base + j * 2;
+            indices[k++] = (uint16_t)v;
+            indices[k++] = (uint16_t)(v + 1);
+            indices[k++] = (uint16_t)(v + 2);
+            indices[k++] = (uint16_t)(v + 1);
+            indices[k++] = (uint16_t)(v + 3);
+            indices[k++] = (uint16_t)(v + 2);
         }
     }
-    for (auto& t : threads) t.join();
-
-    return totalVisible;
+    return k;
 }
 
 }
@@ -14,20 +14,263 @@ struct NativeParticle {
     uint32_t color;
 };
 
+// Struct-of-arrays particle storage used by emitters from create_particle_emitter.
+// Every stream is 32-byte aligned and holds `capacity` entries (maxParticles
+// rounded up to a multiple of 8), so the update kernel runs 8 lanes at a time
+// without a scalar tail.
+struct ParticleStreams {
+    float* x; float* y; float* z;
+    float* vx; float* vy; float* vz;
+    float* life;      // Remaining life (0 to 1)
+    float* lifeRate;  // 1 / maxLife
+    float* size;
+    uint32_t* color;
+    int capacity;
+    void* block;      // Single allocation backing all streams
+};
+
+// Over-lifetime curves, sampled at normalized age (0 = spawn, 1 = death) and
+// linearly interpolated. Owned by the caller; set ParticleEmitter::curves.
+enum { PARTICLE_CURVE_SAMPLES = 64 };
+
+enum ParticleCurveFlags {
+    CURVE_SIZE = 1,   // Size multiplier (replaces the linear size * life fade)
+    CURVE_COLOR = 2,  // ARGB: RGB tints the particle color, A replaces the linear alpha fade
+    CURVE_DRAG = 4    // Velocity damping per second
+};
+
+struct ParticleCurves {
+    int32_t flags;  // ParticleCurveFlags
+    float size[PARTICLE_CURVE_SAMPLES];
+    uint32_t color[PARTICLE_CURVE_SAMPLES];
+    float drag[PARTICLE_CURVE_SAMPLES];
+};
+
+// Forces applied by update_particles after gravity (SoA emitters only)
+enum ForceFieldType {
+    FORCE_POINT = 0,       // Toward the position; negative strength repels
+    FORCE_VORTEX = 1,      // Around the axis through the position
+    FORCE_TURBULENCE = 2,  // Divergence-free curl noise; move the position to animate it
+    FORCE_DRAG = 3,        // Velocity damping per second
+    FORCE_PLANE = 4        // Keeps particles on the normal's side, bouncing them off
+};
+
+struct ForceField {
+    int32_t type;               // ForceFieldType
+    float x, y, z;              // Center / point on the plane / noise offset
+    float axisX, axisY, axisZ;  // Vortex axis / plane normal (normalized internally)
+    float strength;             // Acceleration (drag: 1/s)
+    float radius;               // Point / vortex: linear falloff to zero at radius (0 = unlimited)
+    float frequency;            // Turbulence: noise cells per unit
+    float bounce;               // Plane: restitution of the normal velocity (0 = stick, 1 = elastic)
+};
+
+// What happens to a particle that hits a body
+enum ParticleCollisionResponse {
+    COLLIDE_BOUNCE = 0,  // Reflect the normal velocity (bounce), damp the tangent (friction)
+    COLLIDE_STICK = 1,   // Rest on the surface, moving with the body
+    COLLIDE_KILL = 2     // Expire immediately
+};
+
+// Collision of particle x/y against the static and kinematic bodies of a 2D
+// physics world (z is ignored; dynamic bodies and sensors are skipped).
+// Discrete: a particle moving more than the thinnest body per step can pass
+// through it. The world must not be stepping (step_physics_async) while the
+// emitter updates.
+struct ParticleCollision {
+    struct PhysicsWorld* world;
+    uint32_t categoryBits;  // Filtered like query_aabb
+    uint32_t maskBits;
+    int32_t response;       // ParticleCollisionResponse
+    float bounce;           // Restitution of the normal velocity
+    float friction;         // Fraction of the tangential velocity removed per contact (0 to 1)
+    float radius;           // Particle collision radius in world units
+};
+
+// Position history for ribbon trails (SoA emitters only), created by
+// set_particle_trails and owned by the emitter. Each particle slot holds a
+// ring of its last `length` positions; all rings share one head, since every
+// live particle records at the same time.
+enum { PARTICLE_TRAIL_MAX_POINTS = 32 };
+
+struct ParticleTrails {
+    int32_t length;   // Recorded points per particle (2 to PARTICLE_TRAIL_MAX_POINTS)
+    float interval;   // Seconds between recorded points (0 = every update)
+    float tailWidth;  // Width at the oldest point, relative to the particle's projected size
+    float tailAlpha;  // Alpha at the oldest point, relative to the particle's alpha
+
+    float* points;    // length x,y,z points per particle slot
+    uint8_t* counts;  // Points recorded per particle (0 to length)
+    int32_t head;     // Ring index of the newest point
+    float timer;      // Time since the last recorded point
+};
+
+// Sprite-atlas grid for textured particles (LAYOUT_TEXTURED). Owned by the
+// caller; set ParticleEmitter::atlas. Each particle shows one cell, picked
+// from its normalized age: frame = age * frameCount * cycles (mod frameCount),
+// counted row-major from firstFrame.
+struct ParticleAtlas {
+    int32_t columns;     // Grid cells across the image
+    int32_t rows;        // Grid cells down the image
+    int32_t firstFrame;  // Cell of frame 0
+    int32_t frameCount;  // Flipbook cells (1 = one static cell)
+    float cycles;        // Flipbook plays per lifetime (1 = once from spawn to death)
+    float width;         // Image size in texture coordinates: pixels for an
+    float height;        // ImageShader, 1 for normalized UVs
+};
+
 struct ParticleEmitter {
-    NativeParticle* particles;
+    NativeParticle* particles; // Array-of-structs storage (NULL for SoA emitters)
     int maxParticles;
     int activeCount;
     
     float gravityX, gravityY, gravityZ;
     int shapeType; // 0 = Quad, 1 = Hexagon, 2 = Octagon
+
+    ParticleStreams* streams;  // SoA storage; takes precedence over particles
+
+    // Screen-space cull rect for fill_vertex_buffer, in the units the matrix
+    // maps to (pixels for the painter). Particles whose disc lies entirely
+    // outside are skipped. Disabled while viewMaxX <= viewMinX.
+    float viewMinX, viewMinY, viewMaxX, viewMaxY;
+    float minScreenSize; // Skip particles with a projected half size below this (0 = off)
+
+    int sortMode;        // 0 = storage order, 1 = back to front by projected depth
+
+    ParticleCurves* curves;  // Optional over-lifetime curves (NULL = linear fades)
+
+    ForceField* forceFields;  // Optional, owned by the caller; applied in list order
+    int forceFieldCount;
+
+    ParticleCollision* collision;  // Optional, owned by the caller (SoA emitters only)
+
+    ParticleTrails* trails;  // Owned by the emitter, see set_particle_trails
+
+    ParticleAtlas* atlas;  // Optional, owned by the caller (textured fills)
+};
+
+// Output of the fill functions
+enum ParticleVertexLayout {
+    LAYOUT_TRIANGLES = 0,  // Fan-expanded triangles, x,y + color per vertex (fill_vertex_buffer)
+    LAYOUT_CORNERS = 1,    // Polygon corners, x,y + color per corner (fill_vertex_buffer_indexed)
+    LAYOUT_SPRITES = 2,    // One RSTransform (4 floats) + one color per particle (fill_sprite_buffer)
+    LAYOUT_TRAILS = 3,     // Ribbon along the trail, x,y + color per vertex (fill_trail_buffer)
+    LAYOUT_TEXTURED = 4    // Axis-aligned quad, x,y + color + u,v per corner (fill_textured_buffer)
+};
+
+// Edge length in pixels of the sprite LAYOUT_SPRITES transforms are scaled for
+enum { PARTICLE_SPRITE_SIZE = 128 };
+
+// Spawn distributions for spawn_burst
+enum EmitterShape {
+    EMIT_POINT = 0,   // At the origin; velocity from the vel box + spread
+    EMIT_CONE = 1,    // At the origin; direction within spreadAngle of dir, speed range
+    EMIT_SPHERE = 2,  // Uniform in a ball of radius; radial velocity, speed range
+    EMIT_BOX = 3,     // Uniform in the half extents; velocity from the vel box + spread
+    EMIT_RING = 4     // On a circle of radius in the XY plane; radial velocity, speed range
+};
+
+struct EmitterShapeDef {
+    int32_t shape;              // EmitterShape
+    float x, y, z;              // Origin
+    float radius;               // Sphere / ring radius
+    float halfX, halfY, halfZ;  // Box half extents
+    float dirX, dirY, dirZ;     // Cone axis (normalized internally)
+    float spreadAngle;          // Cone half angle; POINT/BOX: max X and Z rotation (radians)
+    float speedMin, speedMax;   // Cone / sphere / ring
+    float velMinX, velMinY, velMinZ; // Point / box: per-axis velocity range
+    float velMaxX, velMaxY, velMaxZ;
+    float lifeMin, lifeMax;     // Seconds
+    float sizeMin, sizeMax;
+    uint32_t color;
+    uint32_t seed;              // RNG key
+    uint32_t counter;           // RNG position; spawn_burst advances it by the spawned count
 };
 
 // Functions exported to Dart via FFI
+
+// Emitter with SoA storage. Free with destroy_particle_emitter.
+ParticleEmitter* create_particle_emitter(int maxParticles, int shapeType);
+void destroy_particle_emitter(ParticleEmitter* emitter);
+
 void update_particles(ParticleEmitter* emitter, float dt);
 void spawn_particle(ParticleEmitter* emitter, float x, float y, float z, float vx, float vy, float vz, float maxLife, float size, uint32_t color);
 int fill_vertex_buffer(ParticleEmitter* emitter, float* matrix, float* vertices, uint32_t* colors, int maxRenderCount);
 
+// Spawns up to count particles (limited by free capacity) from the shape's
+// distributions, generated in parallel with a counter-based RNG: the result
+// depends only on seed and counter, not on the thread count. Returns the
+// number spawned.
+int spawn_burst(ParticleEmitter* emitter, int count, EmitterShapeDef* def);
+
+// Indexed variant: writes only the particle_shape_sides(shapeType) corners of
+// each visible particle (x,y pairs, one color per corner) and returns the
+// visible count. Draw with the pattern from build_particle_indices.
+int fill_vertex_buffer_indexed(ParticleEmitter* emitter, float* matrix, float* vertices, uint32_t* colors, int maxRenderCount);
+
+// Compact variant for Canvas.drawRawAtlas: per visible particle, one
+// RSTransform {scos, ssin, tx, ty} that maps a PARTICLE_SPRITE_SIZE square
+// sprite of the emitter's shape onto the particle, and one color. 20 bytes per
+// particle instead of 12 per corner (48 for a quad, 144 for a round particle).
+// Returns the visible count.
+int fill_sprite_buffer(ParticleEmitter* emitter, float* matrix, float* transforms, uint32_t* colors, int maxRenderCount);
+
+// Gives the emitter trails of `length` points recorded every `interval`
+// seconds by update_particles (length 0 removes them). Existing particles
+// start with empty trails. Returns 0 for AoS emitters or an invalid length.
+int32_t set_particle_trails(ParticleEmitter* emitter, int32_t length, float interval);
+
+// Ribbon per visible particle: a camera-facing strip from the particle's
+// current position through its recorded points, newest first, 2 vertices
+// (x,y + color) per point and particle_trail_vertices(length) per particle.
+// Width starts at the particle's projected size and alpha at its color's,
+// both tapering linearly to tailWidth / tailAlpha at the oldest point.
+// Unrecorded points repeat the oldest one (zero-area triangles), so every
+// ribbon has the same size. Particles are culled by their head. Returns the
+// visible count.
+int fill_trail_buffer(ParticleEmitter* emitter, float* matrix, float* vertices, uint32_t* colors, int maxRenderCount);
+
+// Vertices per trail ribbon: 2 * (length + 1)
+int particle_trail_vertices(int length);
+
+// Triangle indices for particleCount ribbons of trail length `length`,
+// starting at vertex 0 (see build_particle_indices). Returns the index count
+// (0 if the batch exceeds 16-bit indices).
+int build_trail_indices(int length, int particleCount, uint16_t* indices);
+
+// Fills several emitters back to back into one pair of buffers (one parallel
+// fill instead of one per emitter), so emitters drawn with the same state can
+// share a draw call. Emitters may have different shapes; layout is a
+// ParticleVertexLayout, and each emitter's output matches the single-emitter
+// fill of that layout.
+// maxRenderCount bounds the particles of all emitters together. ranges (2 per
+// emitter, may be NULL) receives {firstVertex, visibleCount}, where a sprite
+// counts as one vertex. Returns the total vertex count (0 for LAYOUT_TEXTURED,
+// see fill_textured_buffer_multi).
+int fill_vertex_buffer_multi(ParticleEmitter** emitters, int emitterCount, float* matrix, float* vertices, uint32_t* colors,
+                             int maxRenderCount, int32_t layout, int32_t* ranges);
+
+// Textured quad per visible particle: 4 corners (x,y + color + u,v) of the
+// square around the particle's projected disc, top-left first and clockwise
+// on screen, with the UVs of its atlas cell (see ParticleAtlas). Index them
+// with build_particle_indices(0, ...). Emitters without an atlas are skipped.
+// Returns the visible count.
+int fill_textured_buffer(ParticleEmitter* emitter, float* matrix, float* vertices, uint32_t* colors, float* uvs, int maxRenderCount);
+
+// fill_vertex_buffer_multi for LAYOUT_TEXTURED, which needs the UV stream:
+// emitters sharing one atlas image fill one draw. Returns the vertex count.
+int fill_textured_buffer_multi(ParticleEmitter** emitters, int emitterCount, float* matrix, float* vertices,
+                               uint32_t* colors, float* uvs, int maxRenderCount, int32_t* ranges);
+
+// Corners per particle for a shape type (4, 6, 8, 12 or 3)
+int particle_shape_sides(int shapeType);
+
+// Writes triangle-fan indices for particleCount particles whose corners start
+// at vertex 0. The pattern is the same for every draw, so build it once per
+// shape and capacity. 16-bit indices: particleCount * sides must be <= 65536.
+// Returns the index count (0 if the batch is too large).
+int build_particle_indices(int shapeType, int particleCount, uint16_t* indices);
+
 }
 
 #endif // FLASH_PARTICLES_H
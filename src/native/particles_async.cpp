@@ -0,0 +1,255 @@
+#include "particles_async.h"
+#include "particles.h"
+#include "physics_async.h"
+#include "trace.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// Particle thread with double-buffered geometry. Frame N+1 is simulated and
+// filled into the back buffer while the renderer draws frame N from the
+// front one; publishing is one atomic store, as in physics_async.
+struct ParticlePipeline {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool busy;
+    bool quit;
+    int maxRenderCount;
+
+    // Job, written by submit while the thread is idle
+    std::vector<ParticleEmitter*> updateEmitters;
+    std::vector<ParticleEmitter*> drawEmitters;
+    std::vector<int32_t> drawGroups; // {layout, emitterCount} per group
+    std::vector<int> groupBudgets;   // Particles each group may fill (thread only)
+    float dt;
+    float matrix[16];
+
+    ParticleFrame frames[2];
+    int capacity[2];        // Vertex slots the vertex/color buffers hold
+    int uvCapacity[2];      // Vertex slots the UV buffer holds
+    int rangeCapacity[2];   // Emitters the ranges buffer holds
+    int groupCapacity[2];   // Groups the groupStarts buffer holds
+    std::atomic<int> front;
+};
+
+namespace {
+    // Vertex slots one particle takes in a frame (see ParticleFrame), 0 if the
+    // fill of that layout skips the emitter
+    int particle_slots(const ParticleEmitter* e, int layout) {
+        switch (layout) {
+            case LAYOUT_SPRITES: return 2;
+            case LAYOUT_TRAILS: return e->trails ? particle_trail_vertices(e->trails->length) : 0;
+            case LAYOUT_TEXTURED: return e->atlas ? 4 : 0;
+            default: return particle_shape_sides(e->shapeType);
+        }
+    }
+
+    void reserve_frame(ParticlePipeline* pipeline, int back, int slotCount, int uvSlotCount, int emitterCount, int groupCount) {
+        ParticleFrame& frame = pipeline->frames[back];
+        if (pipeline->capacity[back] < slotCount) {
+            int capacity = pipeline->capacity[back] + pipeline->capacity[back] / 2;
+            if (capacity < slotCount) capacity = slotCount;
+            free(frame.vertices);
+            free(frame.colors);
+            frame.vertices = (float*)malloc(sizeof(float) * 2 * capacity);
+            frame.colors = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+            pipeline->capacity[back] = capacity;
+        }
+        if (pipeline->uvCapacity[back] < uvSlotCount) {
+            // Textured groups may start anywhere, so the UV stream spans every slot
+            free(frame.uvs);
+            frame.uvs = (float*)malloc(sizeof(float) * 2 * pipeline->capacity[back]);
+            pipeline->uvCapacity[back] = pipeline->capacity[back];
+        }
+        if (pipeline->rangeCapacity[back] < emitterCount) {
+            free(frame.ranges);
+            frame.ranges = (int32_t*)malloc(sizeof(int32_t) * 2 * emitterCount);
+            pipeline->rangeCapacity[back] = emitterCount;
+        }
+        if (pipeline->groupCapacity[back] < groupCount) {
+            free(frame.groupStarts);
+            frame.groupStarts = (int32_t*)malloc(sizeof(int32_t) * groupCount);
+            pipeline->groupCapacity[back] = groupCount;
+        }
+    }
+
+    void run_frame(ParticlePipeline* pipeline) {
+        FLASH_TRACE_ZONE("particle_frame");
+        const std::vector<ParticleEmitter*>& updates = pipeline->updateEmitters;
+        ParticleEmitter** draws = pipeline->drawEmitters.data();
+        int drawCount = (int)pipeline->drawEmitters.size();
+        const int32_t* groups = pipeline->drawGroups.data();
+        int groupCount = (int)pipeline->drawGroups.size() / 2;
+
+        // Collision reads the world; never overlap an asynchronous physics batch
+        for (size_t i = 0; i < updates.size(); ++i) {
+            if (updates[i] && updates[i]->collision && updates[i]->collision->world) {
+                wait_physics(updates[i]->collision->world);
+            }
+        }
+        for (size_t i = 0; i < updates.size(); ++i) update_particles(updates[i], pipeline->dt);
+
+        // Split maxRenderCount over the groups the way the fills consume it:
+        // in draw order, by active count, skipping the emitters they skip
+        std::vector<int>& budgets = pipeline->groupBudgets;
+        budgets.assign(groupCount, 0);
+        int budget = pipeline->maxRenderCount;
+        int slotCount = 0;
+        bool textured = false;
+        for (int g = 0, first = 0; g < groupCount; first += groups[g * 2 + 1], ++g) {
+            for (int i = first; i < first + groups[g * 2 + 1]; ++i) {
+                const ParticleEmitter* e = draws[i];
+                if (!e || (!e->particles && !e->streams) || e->activeCount == 0) continue;
+                int slots = particle_slots(e, groups[g * 2]);
+                if (slots == 0) continue;
+                textured = textured || groups[g * 2] == LAYOUT_TEXTURED;
+                int taken = e->activeCount < budget ? e->activeCount : budget;
+                budget -= taken;
+                budgets[g] += taken;
+                slotCount += taken * slots;
+            }
+        }
+
+        int back = 1 - pipeline->front.load(std::memory_order_relaxed);
+        ParticleFrame& frame = pipeline->frames[back];
+        reserve_frame(pipeline, back, slotCount, textured ? slotCount : 0, drawCount, groupCount);
+
+        memcpy(frame.matrix, pipeline->matrix, sizeof(frame.matrix));
+        int slot = 0;
+        for (int g = 0, first = 0; g < groupCount; first += groups[g * 2 + 1], ++g) {
+            int layout = groups[g * 2];
+            frame.groupStarts[g] = slot;
+            if (layout == LAYOUT_TEXTURED) {
+                if (budgets[g] == 0) { // No UV stream may exist yet; nothing to fill anyway
+                    memset(frame.ranges + first * 2, 0, sizeof(int32_t) * 2 * groups[g * 2 + 1]);
+                    continue;
+                }
+                slot += fill_textured_buffer_multi(draws + first, groups[g * 2 + 1], frame.matrix, frame.vertices + slot * 2,
+                                                   frame.colors + slot, frame.uvs + slot * 2, budgets[g], frame.ranges + first * 2);
+                continue;
+            }
+            if (layout != LAYOUT_SPRITES && layout != LAYOUT_TRAILS) layout = LAYOUT_CORNERS;
+            int count = fill_vertex_buffer_multi(draws + first, groups[g * 2 + 1], frame.matrix, frame.vertices + slot * 2,
+                                                 frame.colors + slot, budgets[g], layout, frame.ranges + first * 2);
+            slot += layout == LAYOUT_SPRITES ? count * 2 : count;
+        }
+        frame.vertexCount = slot;
+        frame.groupCount = groupCount;
+        frame.emitterCount = drawCount;
+        frame.frameIndex = pipeline->frames[1 - back].frameIndex + 1;
+        pipeline->front.store(back, std::memory_order_release);
+    }
+
+    void particle_thread_main(ParticlePipeline* pipeline) {
+        trace_set_thread_name("particles");
+        std::unique_lock<std::mutex> lock(pipeline->mutex);
+        while (true) {
+            pipeline->cv.wait(lock, [pipeline] { return pipeline->quit || pipeline->busy; });
+            if (pipeline->quit) return;
+            lock.unlock();
+
+            run_frame(pipeline);
+
+            lock.lock();
+            pipeline->busy = false;
+            pipeline->cv.notify_all();
+        }
+    }
+}
+
+extern "C" {
+
+ParticlePipeline* create_particle_pipeline(int32_t maxRenderCount) {
+    if (maxRenderCount <= 0) return NULL;
+    ParticlePipeline* pipeline = new ParticlePipeline();
+    pipeline->busy = false;
+    pipeline->quit = false;
+    pipeline->maxRenderCount = maxRenderCount;
+    pipeline->dt = 0;
+    memset(pipeline->matrix, 0, sizeof(pipeline->matrix));
+    memset(pipeline->frames, 0, sizeof(pipeline->frames));
+    for (int i = 0; i < 2; ++i) {
+        pipeline->capacity[i] = 0;
+        pipeline->rangeCapacity[i] = 0;
+        pipeline->groupCapacity[i] = 0;
+        pipeline->uvCapacity[i] = 0;
+    }
+    pipeline->front.store(0);
+    pipeline->thread = std::thread(particle_thread_main, pipeline);
+    return pipeline;
+}
+
+void destroy_particle_pipeline(ParticlePipeline* pipeline) {
+    if (!pipeline) return;
+    {
+        std::unique_lock<std::mutex> lock(pipeline->mutex);
+        pipeline->cv.wait(lock, [pipeline] { return !pipeline->busy; });
+        pipeline->quit = true;
+    }
+    pipeline->cv.notify_all();
+    pipeline->thread.join();
+    for (int i = 0; i < 2; ++i) {
+        free(pipeline->frames[i].vertices);
+        free(pipeline->frames[i].colors);
+        free(pipeline->frames[i].uvs);
+        free(pipeline->frames[i].ranges);
+        free(pipeline->frames[i].groupStarts);
+    }
+    delete pipeline;
+}
+
+void submit_particle_frame(ParticlePipeline* pipeline, ParticleEmitter** updateEmitters, int32_t updateCount,
+                           ParticleEmitter** drawEmitters, int32_t drawCount, const int32_t* drawGroups,
+                           int32_t groupCount, float dt, const float* matrix) {
+    if (!pipeline || !matrix) return;
+    if (!updateEmitters || updateCount < 0) updateCount = 0;
+    if (!drawEmitters || drawCount < 0) drawCount = 0;
+
+    std::unique_lock<std::mutex> lock(pipeline->mutex);
+    pipeline->cv.wait(lock, [pipeline] { return !pipeline->busy; });
+    pipeline->updateEmitters.assign(updateEmitters, updateEmitters + updateCount);
+    pipeline->drawEmitters.assign(drawEmitters, drawEmitters + drawCount);
+    pipeline->drawGroups.clear();
+    // Groups are cut to the draw list; emitters past them form a last corners group
+    int remaining = drawCount;
+    for (int g = 0; drawGroups && g < groupCount; ++g) {
+        int count = std::max(0, std::min((int)drawGroups[g * 2 + 1], remaining));
+        pipeline->drawGroups.push_back(drawGroups[g * 2]);
+        pipeline->drawGroups.push_back(count);
+        remaining -= count;
+    }
+    if (remaining > 0) {
+        pipeline->drawGroups.push_back(LAYOUT_CORNERS);
+        pipeline->drawGroups.push_back(remaining);
+    }
+    pipeline->dt = dt;
+    memcpy(pipeline->matrix, matrix, sizeof(pipeline->matrix));
+    pipeline->busy = true;
+    pipeline->cv.notify_all();
+}
+
+void wait_particle_pipeline(ParticlePipeline* pipeline) {
+    if (!pipeline) return;
+    FLASH_TRACE_ZONE("wait_particle_pipeline");
+    std::unique_lock<std::mutex> lock(pipeline->mutex);
+    pipeline->cv.wait(lock, [pipeline] { return !pipeline->busy; });
+}
+
+int32_t is_particle_pipeline_busy(ParticlePipeline* pipeline) {
+    if (!pipeline) return 0;
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    return pipeline->busy ? 1 : 0;
+}
+
+const ParticleFrame* get_particle_frame(ParticlePipeline* pipeline) {
+    if (!pipeline) return NULL;
+    return &pipeline->frames[pipeline->front.load(std::memory_order_acquire)];
+}
+
+}
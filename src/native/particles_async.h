@@ -0,0 +1,72 @@
+#ifndef FLASH_PARTICLES_ASYNC_H
+#define FLASH_PARTICLES_ASYNC_H
+
+#include <stdint.h>
+
+struct ParticleEmitter;
+struct ParticlePipeline;
+
+extern "C" {
+
+// Geometry of one frame, published by the pipeline thread. Dart reads it
+// without locks.
+//
+// Each draw group is filled back to back with fill_vertex_buffer_multi in its
+// own layout, starting at vertex slot groupStarts[g]: floats 2 * slot of
+// vertices, color slot of colors and floats 2 * slot of uvs. A slot holds
+// one corner or ribbon vertex (x,y + color, u,v for textured groups); a
+// sprite takes two (its RSTransform fills 4 floats, its
+// color the first slot of its pair, so a group's sprite colors are contiguous).
+// ranges are those of the group's fill, relative to its start.
+struct ParticleFrame {
+    float* vertices;       // x,y pairs (RSTransforms for sprite groups)
+    uint32_t* colors;      // One color per vertex or sprite
+    float* uvs;            // u,v pairs per vertex slot (NULL until a textured group is filled)
+    int32_t* ranges;       // {firstVertex, visibleCount} per drawn emitter
+    int32_t* groupStarts;  // First vertex slot per draw group
+    int32_t groupCount;
+    int32_t emitterCount;  // Drawn emitters
+    int32_t vertexCount;   // Vertex slots used by all groups
+    float matrix[16];      // Camera matrix the frame was projected with
+    uint32_t frameIndex;   // Increments with every published frame
+};
+
+// Creates a pipeline and its thread. maxRenderCount bounds the particles of
+// one frame; the buffers grow to the frame's particle count, not to the bound.
+ParticlePipeline* create_particle_pipeline(int32_t maxRenderCount);
+
+// Waits for the running frame and joins the thread
+void destroy_particle_pipeline(ParticlePipeline* pipeline);
+
+// Copies the emitter lists and matrix, then on the pipeline thread runs
+// update_particles(dt) on each emitter of updateEmitters and fills
+// drawEmitters into the back buffer. drawGroups holds {layout, emitterCount}
+// per group: consecutive runs of drawEmitters filled with one
+// fill_vertex_buffer_multi call each (LAYOUT_CORNERS, LAYOUT_SPRITES or
+// LAYOUT_TRAILS; LAYOUT_TEXTURED uses fill_textured_buffer_multi and the UV
+// stream; other layouts fill corners). Emitters past the groups (all
+// of them when drawGroups is NULL) are filled as one last LAYOUT_CORNERS group.
+// The lists may overlap: hidden emitters keep simulating without being drawn,
+// paused ones are drawn without being updated. Returns immediately; if a
+// frame is still running, waits for it first.
+//
+// Until wait_particle_pipeline returns, the emitters belong to the pipeline
+// thread: don't spawn, change settings or destroy them. Physics worlds the
+// updated emitters collide with are waited on (wait_physics) first.
+void submit_particle_frame(ParticlePipeline* pipeline, ParticleEmitter** updateEmitters, int32_t updateCount,
+                           ParticleEmitter** drawEmitters, int32_t drawCount, const int32_t* drawGroups,
+                           int32_t groupCount, float dt, const float* matrix);
+
+// Blocks until the running frame (if any) is finished
+void wait_particle_pipeline(ParticlePipeline* pipeline);
+
+// 1 while a frame is running
+int32_t is_particle_pipeline_busy(ParticlePipeline* pipeline);
+
+// Last completed frame (empty before the first one). Its buffers are not
+// written again until a newer frame has completed and another one is submitted.
+const ParticleFrame* get_particle_frame(ParticlePipeline* pipeline);
+
+}
+
+#endif
@@ -1,12 +1,25 @@
 #include "physics.h"
 #include "broadphase.h"
 #include "joints.h"
+#include "events.h"
+#include "flash_math.h"
+#include "trace.h"
+#include "jobs.h"
+#include "physics_async.h"
 #include <cmath>
 #include <algorithm>
 #include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
 
 #define PI 3.14159265359f
 
+// Items per job system task (see jobs.h)
+const int kNarrowphaseGrainSize = 64;
+const int kBodyGrainSize = 512;
+
 struct Vec2 {
     float x, y;
     Vec2 operator+(const Vec2& v) const { return {x + v.x, y + v.y}; }
@@ -21,21 +34,53 @@ struct Vec2 {
 inline Vec2 cross(Vec2 v, float s) { return {s * v.y, -s * v.x}; }
 inline Vec2 cross(float s, Vec2 v) { return {-s * v.y, s * v.x}; }
 inline Vec2 rotate(Vec2 v, float angle) {
-    float c = std::cos(angle);
-    float s = std::sin(angle);
+    float c = flash_cos(angle);
+    float s = flash_sin(angle);
     return { v.x * c - v.y * s, v.x * s + v.y * c };
 }
 
-#include <map>
+typedef std::chrono::steady_clock ProfileClock;
+
+// Milliseconds since mark, then move mark to now
+inline float profile_lap(ProfileClock::time_point& mark) {
+    ProfileClock::time_point now = ProfileClock::now();
+    float ms = std::chrono::duration<float, std::milli>(now - mark).count();
+    mark = now;
+    return ms;
+}
+
+inline bool broadphase_pair_less(const BroadphasePair& a, const BroadphasePair& b) {
+    return a.bodyA != b.bodyA ? a.bodyA < b.bodyA : a.bodyB < b.bodyB;
+}
+
+inline bool warm_start_key_less(const WarmStartEntry& e, uint64_t key) { return e.key < key; }
+inline bool warm_start_entry_less(const WarmStartEntry& a, const WarmStartEntry& b) { return a.key < b.key; }
+
+struct CollisionManifold {
+    Vec2 normal;
+    float penetration;
+    Vec2 contacts[2];
+    int contactCount;
+    bool collided;
+};
 
-// Internal cache for warm starting
-// Key: (minId << 32) | maxId
-// Value: Stored impulses for the contact point
-struct CachedImpulse {
-    float normalImpulse;
-    float tangentImpulse;
+struct PhysicsScratch {
+    BroadphasePair* pairs;
+    int pairCapacity;
+    CollisionManifold* manifolds;
+    int manifoldCapacity;
 };
-using ImpulseCache = std::map<uint64_t, CachedImpulse>;
+
+// Grows a scratch array to at least count items (contents are not preserved)
+template <typename T>
+T* reserve_scratch(T*& items, int& capacity, int count) {
+    if (count > capacity) {
+        free(items);
+        capacity = std::max(count, capacity * 2);
+        items = (T*)malloc(capacity * sizeof(T));
+    }
+    return items;
+}
 
 extern "C" {
 
@@ -82,12 +127,23 @@ PhysicsWorld* create_physics_world(int maxBodies) {
     world->maxBoxJoints = 200;
     world->boxJoints = (Joint*)calloc(world->maxBoxJoints, sizeof(Joint));
     world->activeBoxJoints = 0;
+
+    // Contact / sensor events
+    world->contactEvents = create_contact_event_buffer(maxBodies * 4 > 256 ? maxBodies * 4 : 256);
+    world->hitEventThreshold = 1.0f * 100.0f;
+    world->contactTracker = create_contact_tracker();
+
+    // Warm starting cache (up to 2 points per constraint)
+    world->warmStartCache = (WarmStartCache*)calloc(1, sizeof(WarmStartCache));
+    world->warmStartCache->capacity = world->maxConstraints * 2;
+    world->warmStartCache->entries = (WarmStartEntry*)calloc(world->warmStartCache->capacity, sizeof(WarmStartEntry));
     
     return world;
 }
 
 void destroy_physics_world(PhysicsWorld* world) {
     if (!world) return;
+    destroy_physics_async(world->async); // Joins the physics thread first
     delete[] world->bodies;
     delete[] world->manifolds;
     delete[] world->constraints;
@@ -100,17 +156,22 @@ void destroy_physics_world(PhysicsWorld* world) {
     }
     delete[] world->softBodies;
 
+    destroy_contact_event_buffer(world->contactEvents);
+    destroy_contact_tracker(world->contactTracker);
+    free(world->profile);
+    if (world->scratch) {
+        free(world->scratch->pairs);
+        free(world->scratch->manifolds);
+        free(world->scratch);
+    }
+    if (world->warmStartCache) {
+        free(world->warmStartCache->entries);
+        free(world->warmStartCache);
+    }
+
     delete world;
 }
 
-struct CollisionManifold {
-    Vec2 normal;
-    float penetration;
-    Vec2 contacts[2];
-    int contactCount;
-    bool collided;
-};
-
 // --- Collision Detection (SAT & Math) ---
 
 CollisionManifold detectCircleCircle(NativeBody& a, NativeBody& b) {
@@ -289,6 +350,23 @@ CollisionManifold detectCircleBox(NativeBody& circle, NativeBody& box) {
     return m;
 }
 
+// Filters a broadphase pair and runs the matching narrowphase test. The normal
+// points from a to b. Reads the bodies only, so pairs can be tested in parallel.
+CollisionManifold collide_pair(NativeBody& a, NativeBody& b) {
+    CollisionManifold m = {{0,0}, 0, {{0,0}}, 0, false};
+    if (a.type == STATIC && b.type == STATIC) return m;
+    if (!((a.maskBits & b.categoryBits) != 0 && (b.maskBits & a.categoryBits) != 0)) return m;
+    if (a.isSensor && b.isSensor) return m; // Sensors don't detect other sensors
+
+    if (a.shapeType == SHAPE_CIRCLE && b.shapeType == SHAPE_CIRCLE) m = detectCircleCircle(a, b);
+    else if (a.shapeType == SHAPE_BOX && b.shapeType == SHAPE_BOX) m = detectBoxBox(a, b);
+    else if (a.shapeType == SHAPE_CIRCLE) m = detectCircleBox(a, b);
+    else { m = detectCircleBox(b, a); }
+
+    if (m.collided && a.shapeType == SHAPE_CIRCLE && b.shapeType == SHAPE_BOX) m.normal = m.normal * -1.0f;
+    return m;
+}
+
 // --- Solver ---
 
 void step_soft_body(PhysicsWorld* world, float dt);
@@ -296,10 +374,25 @@ void step_soft_body(PhysicsWorld* world, float dt);
 void step_physics(PhysicsWorld* world, float dt) {
     if (!world || dt <= 0) return;
 
+    FLASH_TRACE_ZONE("step_physics");
+    PhysicsProfile* profile = world->profile;
+    ProfileClock::time_point stepStart, mark;
+    if (profile) {
+        memset(profile, 0, sizeof(PhysicsProfile));
+        stepStart = mark = ProfileClock::now();
+    }
+
+    FLASH_TRACE_PHASE(phase, "soft_bodies");
+
     // Step Soft Bodies
     step_soft_body(world, dt);
+    if (profile) profile->softBodies = profile_lap(mark);
+    FLASH_TRACE_NEXT_PHASE(phase, "broadphase");
 
-    if (world->activeCount == 0) return;
+    if (world->activeCount == 0) {
+        if (profile) profile->total = profile_lap(stepStart);
+        return;
+    }
 
     // Phase 1: Update Broadphase Tree
     for (int i = 0; i < world->activeCount; ++i) {
@@ -312,30 +405,79 @@ void step_physics(PhysicsWorld* world, float dt) {
         b.proxyId = tree_update_leaf(world->tree, b.proxyId, aabb);
     }
 
+    if (profile) profile->broadphase = profile_lap(mark);
+    FLASH_TRACE_NEXT_PHASE(phase, "pairs");
+
     world->activeConstraints = 0;
     const int maxPairs = world->maxBodies * 8; // Increased for complex scenes
-    BroadphasePair* pairs = new BroadphasePair[maxPairs];
+    if (!world->scratch) world->scratch = (PhysicsScratch*)calloc(1, sizeof(PhysicsScratch));
+    PhysicsScratch* scratch = world->scratch;
+    BroadphasePair* pairs = reserve_scratch(scratch->pairs, scratch->pairCapacity, maxPairs);
     int pairCount = query_tree_pairs(world->tree, pairs, maxPairs);
 
+#if defined(FLASH_DETERMINISTIC)
+    // Pair order from the tree depends on node indices; solve in body ID order instead
+    for (int p = 0; p < pairCount; ++p) {
+        if (pairs[p].bodyA > pairs[p].bodyB) std::swap(pairs[p].bodyA, pairs[p].bodyB);
+    }
+    std::sort(pairs, pairs + pairCount, broadphase_pair_less);
+#endif
+    if (profile) profile->pairs = profile_lap(mark);
+    FLASH_TRACE_NEXT_PHASE(phase, "narrowphase");
+
     Softness contactSoftness = makeSoftness(world->contactHertz, world->contactDampingRatio, dt);
+    if (world->contactTracker) contact_tracker_begin_step(world->contactTracker);
+
+    // Collision detection runs in parallel (pairs are independent); constraints
+    // and events are then built serially in pair order
+    CollisionManifold* manifolds = reserve_scratch(scratch->manifolds, scratch->manifoldCapacity, pairCount);
+    parallel_for(pairCount, kNarrowphaseGrainSize, [world, pairs, manifolds](int begin, int end) {
+        for (int p = begin; p < end; ++p) {
+            manifolds[p] = collide_pair(world->bodies[pairs[p].bodyA], world->bodies[pairs[p].bodyB]);
+        }
+    });
+
+    for (int p = 0; p < pairCount; ++p) {
+        const CollisionManifold& m = manifolds[p];
+        if (!m.collided) continue;
 
-    for (int p = 0; p < pairCount && world->activeConstraints < world->maxConstraints; ++p) {
         int i = pairs[p].bodyA;
         int j = pairs[p].bodyB;
-        
         NativeBody& a = world->bodies[i];
         NativeBody& b = world->bodies[j];
-        if (a.type == STATIC && b.type == STATIC) continue;
-        if (!((a.maskBits & b.categoryBits) != 0 && (b.maskBits & a.categoryBits) != 0)) continue;
-
-        CollisionManifold m = {{0,0}, 0, {{0,0}}, 0, false};
-        if (a.shapeType == SHAPE_CIRCLE && b.shapeType == SHAPE_CIRCLE) m = detectCircleCircle(a, b);
-        else if (a.shapeType == SHAPE_BOX && b.shapeType == SHAPE_BOX) m = detectBoxBox(a, b);
-        else if (a.shapeType == SHAPE_CIRCLE) m = detectCircleBox(a, b);
-        else { m = detectCircleBox(b, a); }
 
-        if (!m.collided) continue;
-        if (a.shapeType == SHAPE_CIRCLE && b.shapeType == SHAPE_BOX) m.normal = m.normal * -1.0f;
+        // Begin / hit / sensor events (end events are found by diffing after the loop)
+        bool sensorPair = a.isSensor || b.isSensor;
+        if (world->contactTracker && contact_tracker_touch(world->contactTracker, i, j, sensorPair)) {
+            ContactEvent e = {};
+            e.bodyA = i;
+            e.bodyB = j;
+            e.pointX = m.contacts[0].x;
+            e.pointY = m.contacts[0].y;
+            e.normalX = m.normal.x;
+            e.normalY = m.normal.y;
+            e.approachSpeed = -(Vec2{b.vx, b.vy} - Vec2{a.vx, a.vy}).dot(m.normal);
+            if (sensorPair) {
+                e.type = SENSOR_BEGIN;
+                if (!a.isSensor) { // Report the sensor as bodyA
+                    std::swap(e.bodyA, e.bodyB);
+                    e.normalX = -e.normalX;
+                    e.normalY = -e.normalY;
+                }
+                push_contact_event(world->contactEvents, e);
+            } else {
+                e.type = CONTACT_BEGIN;
+                push_contact_event(world->contactEvents, e);
+                if (e.approachSpeed > world->hitEventThreshold) {
+                    e.type = CONTACT_HIT;
+                    push_contact_event(world->contactEvents, e);
+                }
+            }
+        }
+        if (sensorPair) continue; // Sensors detect overlap but never collide
+        // Constraint buffer full: the contact stays tracked (no spurious
+        // END/BEGIN pair), it just isn't solved this step
+        if (world->activeConstraints >= world->maxConstraints) continue;
 
         ContactConstraint& constraint = world->constraints[world->activeConstraints++];
         constraint.bodyA = i;
@@ -372,48 +514,55 @@ void step_physics(PhysicsWorld* world, float dt) {
         }
         a.collision_count++; b.collision_count++;
     }
-    delete[] pairs;
+    if (world->contactTracker) contact_tracker_end_step(world->contactTracker, world->contactEvents, world->bodies);
+    if (profile) {
+        profile->narrowphase = profile_lap(mark);
+        profile->pairCount = pairCount;
+        profile->constraintCount = world->activeConstraints;
+    }
+    FLASH_TRACE_NEXT_PHASE(phase, "integrate_velocities");
 
-    // Phase 2: Integrate Velocities & Apply Sleep
-    for (int i = 0; i < world->activeCount; ++i) {
-        NativeBody& b = world->bodies[i];
-        if (b.type == STATIC) continue;
-        
-        // Sleep check
-        if (b.vx * b.vx + b.vy * b.vy < 0.2f && std::abs(b.angularVelocity) < 0.2f && 
-            b.forceX == 0 && b.forceY == 0 && b.torque == 0) {
-            b.sleepTime += dt;
-        } else {
-            b.sleepTime = 0.0f;
-            b.isAwake = 1;
-        }
+    // Phase 2: Integrate Velocities & Apply Sleep (bodies are independent)
+    parallel_for(world->activeCount, kBodyGrainSize, [world, dt](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            NativeBody& b = world->bodies[i];
+            if (b.type == STATIC) continue;
+            
+            // Sleep check
+            if (b.vx * b.vx + b.vy * b.vy < 0.2f && std::abs(b.angularVelocity) < 0.2f && 
+                b.forceX == 0 && b.forceY == 0 && b.torque == 0) {
+                b.sleepTime += dt;
+            } else {
+                b.sleepTime = 0.0f;
+                b.isAwake = 1;
+            }
 
-        if (b.sleepTime > 1.0f) {
-            b.isAwake = 0;
-            b.vx = b.vy = b.angularVelocity = 0;
-            continue;
-        }
+            if (b.sleepTime > 1.0f) {
+                b.isAwake = 0;
+                b.vx = b.vy = b.angularVelocity = 0;
+                continue;
+            }
 
-        b.vx += (world->gravityX + b.forceX * b.inverseMass) * dt;
-        b.vy += (world->gravityY + b.forceY * b.inverseMass) * dt;
-        b.angularVelocity += (b.torque * b.inverseInertia) * dt;
-        
-        // Damping for stability (Reduced from 0.99 to 0.999 to allow gravity to be snappy)
-        b.vx *= 0.999f;
-        b.vy *= 0.999f;
-        b.angularVelocity *= 0.999f;
+            b.vx += (world->gravityX + b.forceX * b.inverseMass) * dt;
+            b.vy += (world->gravityY + b.forceY * b.inverseMass) * dt;
+            b.angularVelocity += (b.torque * b.inverseInertia) * dt;
+            
+            // Damping for stability (Reduced from 0.99 to 0.999 to allow gravity to be snappy)
+            b.vx *= 0.999f;
+            b.vy *= 0.999f;
+            b.angularVelocity *= 0.999f;
 
-        b.forceX = b.forceY = b.torque = 0;
-    }
+            b.forceX = b.forceY = b.torque = 0;
+        }
+    });
+
+    if (profile) profile->integrate = profile_lap(mark);
+    FLASH_TRACE_NEXT_PHASE(phase, "warm_start");
 
     // Phase 3: Solve Velocity Constraints
     init_joint_velocity_constraints(world, dt);
 
-    ImpulseCache* cache = (ImpulseCache*)world->warmStartCache;
-    if (!cache) {
-        cache = new ImpulseCache();
-        world->warmStartCache = cache;
-    }
+    WarmStartCache* cache = world->warmStartCache;
     
     // warm start
     if (world->enableWarmStarting) {
@@ -431,10 +580,11 @@ void step_physics(PhysicsWorld* world, float dt) {
                  uint64_t maxId = std::max(c.bodyA, c.bodyB);
                  uint64_t key = (minId << 32) | (maxId << 4) | j; // Use 4 bits for index (up to 16 points)
                  
-                 if (cache->count(key)) {
-                     CachedImpulse& imp = (*cache)[key];
-                     cp.normalImpulse = imp.normalImpulse;
-                     cp.tangentImpulse = imp.tangentImpulse;
+                 const WarmStartEntry* end = cache->entries + cache->count;
+                 const WarmStartEntry* imp = std::lower_bound((const WarmStartEntry*)cache->entries, end, key, warm_start_key_less);
+                 if (imp != end && imp->key == key) {
+                     cp.normalImpulse = imp->normalImpulse;
+                     cp.tangentImpulse = imp->tangentImpulse;
                      
                      // Apply cached impulses for warm start
                      Vec2 normal = {c.normalX, c.normalY}, tangent = {-c.normalY, c.normalX};
@@ -460,6 +610,9 @@ void step_physics(PhysicsWorld* world, float dt) {
         }
     }
     
+    if (profile) profile->warmStart = profile_lap(mark);
+    FLASH_TRACE_NEXT_PHASE(phase, "velocity_solve");
+
     for (int iter = 0; iter < world->velocityIterations; ++iter) {
         for (int i = 0; i < world->activeConstraints; ++i) {
             ContactConstraint& c = world->constraints[i];
@@ -506,27 +659,39 @@ void step_physics(PhysicsWorld* world, float dt) {
         solve_joint_velocity_constraints(world);
     }
     
-    // Store impulses for next frame
+    // Store impulses for next frame (contacts that ended are dropped)
     if (world->enableWarmStarting) {
+         cache->count = 0;
          for (int i = 0; i < world->activeConstraints; ++i) {
             ContactConstraint& c = world->constraints[i];
-            for (int j = 0; j < c.pointCount; ++j) {
+            for (int j = 0; j < c.pointCount && cache->count < cache->capacity; ++j) {
                  ContactConstraintPoint& cp = c.points[j];
                  uint64_t minId = std::min(c.bodyA, c.bodyB);
                  uint64_t maxId = std::max(c.bodyA, c.bodyB);
                  uint64_t key = (minId << 32) | (maxId << 4) | j;
                  
-                 (*cache)[key] = {cp.normalImpulse, cp.tangentImpulse};
+                 WarmStartEntry& entry = cache->entries[cache->count++];
+                 entry.key = key;
+                 entry.normalImpulse = cp.normalImpulse;
+                 entry.tangentImpulse = cp.tangentImpulse;
             }
          }
+         std::sort(cache->entries, cache->entries + cache->count, warm_start_entry_less);
     }
 
+    if (profile) profile->velocitySolve = profile_lap(mark);
+    FLASH_TRACE_NEXT_PHASE(phase, "integrate_positions");
+
     // Phase 4: Integrate Positions
-    for (int i = 0; i < world->activeCount; ++i) {
-        NativeBody& b = world->bodies[i];
-        if (b.type == STATIC || !b.isAwake) continue;
-        b.x += b.vx * dt; b.y += b.vy * dt; b.rotation += b.angularVelocity * dt;
-    }
+    parallel_for(world->activeCount, kBodyGrainSize, [world, dt](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            NativeBody& b = world->bodies[i];
+            if (b.type == STATIC || !b.isAwake) continue;
+            b.x += b.vx * dt; b.y += b.vy * dt; b.rotation += b.angularVelocity * dt;
+        }
+    });
+    if (profile) profile->integrate += profile_lap(mark);
+    FLASH_TRACE_NEXT_PHASE(phase, "position_solve");
 
     // Phase 5: Position Correction (pseudo-impulse for rotation stability)
     const float slop = 0.01f, baumgarte = 0.2f;
@@ -563,6 +728,15 @@ void step_physics(PhysicsWorld* world, float dt) {
         }
         solve_joint_position_constraints(world);
     }
+
+    if (profile) {
+        profile->positionSolve = profile_lap(mark);
+        profile->total = profile_lap(stepStart);
+        for (int i = 0; i < world->activeCount; ++i) {
+            if (world->bodies[i].type != STATIC && world->bodies[i].isAwake) profile->awakeBodyCount++;
+        }
+        profile->treeHeight = world->tree->root != -1 ? world->tree->nodes[world->tree->root].height : 0;
+    }
 }
 
 // Removed get_physics_version from here
@@ -794,12 +968,8 @@ void step_soft_body(PhysicsWorld* world, float dt) {
         }
 
         // 4. Collision with Rigid Bodies
-        // Debug print to see if we are even checking
-        fprintf(stderr, "Checking soft body %d against %d rigid bodies\n", i, world->activeCount);
-        
         for (int bIdx = 0; bIdx < world->activeCount; bIdx++) {
             NativeBody& b = world->bodies[bIdx];
-            fprintf(stderr, "  Checking Body %d: Type=%d Shape=%d W=%f H=%f Y=%f\n", b.id, b.type, b.shapeType, b.width, b.height, b.y);
 
             if (b.type == 0 && b.shapeType == 1 && b.width > 1000) { 
                 // Optimization: For huge static ground, use simple plane check if possible?
@@ -834,8 +1004,8 @@ void step_soft_body(PhysicsWorld* world, float dt) {
                     }
                 } else if (b.shapeType == 1) { // Box
                     // Transform point to box local space
-                    float c = std::cos(-b.rotation);
-                    float s = std::sin(-b.rotation);
+                    float c = flash_cos(-b.rotation);
+                    float s = flash_sin(-b.rotation);
                     
                     float dx = p.x - b.x;
                     float dy = p.y - b.y;
@@ -881,8 +1051,8 @@ void step_soft_body(PhysicsWorld* world, float dt) {
                         else if (minPen == dTop) nLocalY = 1;
                         
                         // Transform normal back to world
-                        float c_rot = std::cos(b.rotation);
-                        float s_rot = std::sin(b.rotation);
+                        float c_rot = flash_cos(b.rotation);
+                        float s_rot = flash_sin(b.rotation);
                         
                         float worldNx = nLocalX * c_rot - nLocalY * s_rot;
                         float worldNy = nLocalX * s_rot + nLocalY * c_rot;
@@ -948,6 +1118,72 @@ void get_body_position(PhysicsWorld* world, int32_t bodyId, float* x, float* y)
     }
 }
 
+void set_body_sensor(PhysicsWorld* world, int32_t bodyId, int isSensor) {
+    if (world && bodyId >= 0 && bodyId < world->activeCount) {
+        world->bodies[bodyId].isSensor = isSensor ? 1 : 0;
+    }
+}
+
+void enable_physics_profile(PhysicsWorld* world, int enable) {
+    if (!world) return;
+    // An asynchronous batch writes through the pointer it read at step start
+    wait_physics(world);
+    if (enable && !world->profile) {
+        world->profile = (PhysicsProfile*)calloc(1, sizeof(PhysicsProfile));
+    } else if (!enable && world->profile) {
+        free(world->profile);
+        world->profile = NULL;
+    }
+}
+
+PhysicsProfile* get_physics_profile(PhysicsWorld* world) {
+    if (!world) return NULL;
+    wait_physics(world);  // Never hand out a profile the physics thread is filling
+    return world->profile;
+}
+
+int32_t is_physics_deterministic() {
+#if defined(FLASH_DETERMINISTIC)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+namespace {
+    // FNV-1a over raw bytes
+    inline uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+        const uint8_t* bytes = (const uint8_t*)data;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+uint64_t hash_world_state(PhysicsWorld* world) {
+    if (!world) return 0;
+
+    uint64_t hash = 14695981039346656037ULL;
+    hash = fnv1a(hash, &world->activeCount, sizeof(world->activeCount));
+    for (int i = 0; i < world->activeCount; ++i) {
+        const NativeBody& b = world->bodies[i];
+        // Bit patterns of the simulated state (positions, velocities, sleep)
+        const float state[6] = { b.x, b.y, b.rotation, b.vx, b.vy, b.angularVelocity };
+        hash = fnv1a(hash, state, sizeof(state));
+        hash = fnv1a(hash, &b.isAwake, sizeof(b.isAwake));
+    }
+    for (int i = 0; i < world->activeSoftBodies; ++i) {
+        const NativeSoftBody& sb = world->softBodies[i];
+        for (int p = 0; p < sb.pointCount; ++p) {
+            const float state[4] = { sb.points[p].x, sb.points[p].y, sb.points[p].oldX, sb.points[p].oldY };
+            hash = fnv1a(hash, state, sizeof(state));
+        }
+    }
+    return hash;
+}
+
 // --- RayCasting Implementation ---
 
 bool intersectRayCircle(float startX, float startY, float dx, float dy, 
@@ -1053,8 +1289,8 @@ RayCastHit ray_cast(PhysicsWorld* world, float startX, float startY, float endX,
              hit = intersectRayCircle(startX, startY, dx, dy, b.x, b.y, b.radius, hitFraction, nx, ny);
         } else if (b.shapeType == SHAPE_BOX) {
             // Transform Ray to Box Local Space
-            float c = std::cos(-b.rotation);
-            float s = std::sin(-b.rotation);
+            float c = flash_cos(-b.rotation);
+            float s = flash_sin(-b.rotation);
             
             float localStartX = (startX - b.x) * c - (startY - b.y) * s;
             float localStartY = (startX - b.x) * s + (startY - b.y) * c;
@@ -1069,8 +1305,8 @@ RayCastHit ray_cast(PhysicsWorld* world, float startX, float startY, float endX,
                                 -hw, -hh, hw, hh, hitFraction, nx, ny)) {
                 
                 // Transform normal back to world space
-                float c_rot = std::cos(b.rotation); // Assuming previous c was cos(-rot) = cos(rot)
-                float s_rot = std::sin(b.rotation); // existing s was sin(-rot) = -sin(rot)
+                float c_rot = flash_cos(b.rotation); // Assuming previous c was cos(-rot) = cos(rot)
+                float s_rot = flash_sin(b.rotation); // existing s was sin(-rot) = -sin(rot)
                 
                 // Manually recalculate C/S for clarity
                 c_rot = c;
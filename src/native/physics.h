@@ -115,6 +115,41 @@ struct NativeJoint {
     float impulse;
 };
 
+// Warm starting cache entry: accumulated impulses of one contact point from the last step.
+// Key: (minId << 32) | (maxId << 4) | pointIndex
+struct WarmStartEntry {
+    uint64_t key;
+    float normalImpulse;
+    float tangentImpulse;
+};
+
+// Flat cache sorted by key (binary search lookup, copyable with memcpy for snapshots).
+// Rebuilt every step from the active contact constraints.
+struct WarmStartCache {
+    WarmStartEntry* entries;
+    int count;
+    int capacity;
+};
+
+// Per-step profile, filled by step_physics when enabled (Box2D b2Profile-style).
+// Timings are in milliseconds for the last step.
+struct PhysicsProfile {
+    float softBodies;
+    float broadphase;     // Tree leaf updates
+    float pairs;          // Tree pair query
+    float narrowphase;    // Collision detection, contact constraints, events
+    float warmStart;      // Joint init + contact warm starting
+    float velocitySolve;  // Velocity iterations + impulse caching
+    float integrate;      // Velocity and position integration, sleep
+    float positionSolve;  // Position iterations
+    float total;
+
+    int32_t pairCount;
+    int32_t constraintCount;
+    int32_t awakeBodyCount;
+    int32_t treeHeight;
+};
+
 struct PhysicsWorld {
     NativeBody* bodies;
     int maxBodies;
@@ -155,8 +190,23 @@ struct PhysicsWorld {
     int maxBoxJoints;
     int activeBoxJoints;
 
-    // Internal cache for warm starting (C++ std::map<uint64_t, ...>*)
-    void* warmStartCache;
+    // Internal cache for warm starting
+    struct WarmStartCache* warmStartCache;
+
+    // Contact / sensor events (see events.h)
+    struct ContactEventBuffer* contactEvents;
+    float hitEventThreshold;        // Minimum approach speed for CONTACT_HIT
+    struct ContactTracker* contactTracker; // Internal begin/end state
+
+    // Step profile (NULL when profiling is disabled)
+    PhysicsProfile* profile;
+
+    // Physics thread for step_physics_async (see physics_async.h), NULL until first used
+    struct PhysicsAsync* async;
+
+    // Per-step scratch memory owned by this world, grown on demand and reused
+    // (no global heap traffic per step once warmed up)
+    struct PhysicsScratch* scratch;
 };
 
 PhysicsWorld* create_physics_world(int maxBodies);
@@ -168,6 +218,18 @@ void apply_force(PhysicsWorld* world, int32_t bodyId, float fx, float fy);
 void apply_torque(PhysicsWorld* world, int32_t bodyId, float torque);
 void set_body_velocity(PhysicsWorld* world, int32_t bodyId, float vx, float vy);
 void get_body_position(PhysicsWorld* world, int32_t bodyId, float* x, float* y);
+void set_body_sensor(PhysicsWorld* world, int32_t bodyId, int isSensor);
+
+// Profiling. While enabled, every step_physics call overwrites the profile.
+// Both calls first wait for a running asynchronous batch (see wait_physics).
+void enable_physics_profile(PhysicsWorld* world, int enable);
+PhysicsProfile* get_physics_profile(PhysicsWorld* world);
+
+// Determinism (lockstep). Built with FLASH_DETERMINISTIC, identical inputs produce
+// bit-identical worlds on every platform.
+int32_t is_physics_deterministic();
+// 64-bit FNV-1a hash of the simulated state, compare between peers to detect desyncs
+uint64_t hash_world_state(PhysicsWorld* world);
 
 // Soft Body functions
 int32_t create_soft_body(PhysicsWorld* world, int pointCount, float* initialX, float* initialY, float pressure, float stiffness);
@@ -0,0 +1,140 @@
+#include "physics_async.h"
+#include "physics.h"
+#include "trace.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <cstdlib>
+
+// Per-world physics thread with a double-buffered transform output.
+// The thread only writes the back buffer and publishes it with one atomic
+// store, so readers of the front buffer never see a half-written batch.
+struct PhysicsAsync {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    int pendingSteps;
+    float dt;
+    bool busy;
+    bool quit;
+
+    BodyTransformBuffer buffers[2];
+    std::atomic<int> front;
+};
+
+namespace {
+    void publish_transforms(PhysicsWorld* world, PhysicsAsync* async) {
+        int back = 1 - async->front.load(std::memory_order_relaxed);
+        BodyTransformBuffer& buffer = async->buffers[back];
+
+        if (buffer.capacity < world->activeCount) {
+            free(buffer.transforms);
+            buffer.capacity = world->maxBodies;
+            buffer.transforms = (BodyTransform*)calloc(buffer.capacity, sizeof(BodyTransform));
+        }
+        for (int i = 0; i < world->activeCount; ++i) {
+            const NativeBody& b = world->bodies[i];
+            BodyTransform& t = buffer.transforms[i];
+            t.x = b.x;
+            t.y = b.y;
+            t.rotation = b.rotation;
+            t.collisionCount = b.collision_count;
+        }
+        buffer.count = world->activeCount;
+        buffer.batchIndex = async->buffers[1 - back].batchIndex + 1;
+        async->front.store(back, std::memory_order_release);
+    }
+
+    void physics_thread_main(PhysicsWorld* world, PhysicsAsync* async) {
+        trace_set_thread_name("physics");
+        std::unique_lock<std::mutex> lock(async->mutex);
+        while (true) {
+            async->cv.wait(lock, [async] { return async->quit || async->pendingSteps > 0; });
+            if (async->quit) return;
+
+            int steps = async->pendingSteps;
+            float dt = async->dt;
+            async->pendingSteps = 0;
+            lock.unlock();
+
+            for (int i = 0; i < steps; ++i) step_physics(world, dt);
+            publish_transforms(world, async);
+
+            lock.lock();
+            async->busy = false;
+            async->cv.notify_all();
+        }
+    }
+
+    PhysicsAsync* get_async(PhysicsWorld* world) {
+        if (!world->async) {
+            PhysicsAsync* async = new PhysicsAsync();
+            async->pendingSteps = 0;
+            async->dt = 0;
+            async->busy = false;
+            async->quit = false;
+            for (int i = 0; i < 2; ++i) {
+                async->buffers[i].transforms = NULL;
+                async->buffers[i].count = 0;
+                async->buffers[i].capacity = 0;
+                async->buffers[i].batchIndex = 0;
+            }
+            async->front.store(0);
+            // Readers get the current state before the first batch completes
+            publish_transforms(world, async);
+            async->thread = std::thread(physics_thread_main, world, async);
+            world->async = async;
+        }
+        return world->async;
+    }
+}
+
+extern "C" {
+
+void step_physics_async(PhysicsWorld* world, float dt, int32_t stepCount) {
+    if (!world || dt <= 0 || stepCount <= 0) return;
+    PhysicsAsync* async = get_async(world);
+
+    std::unique_lock<std::mutex> lock(async->mutex);
+    async->cv.wait(lock, [async] { return !async->busy; });
+    async->pendingSteps = stepCount;
+    async->dt = dt;
+    async->busy = true;
+    async->cv.notify_all();
+}
+
+void wait_physics(PhysicsWorld* world) {
+    if (!world || !world->async) return;
+    FLASH_TRACE_ZONE("wait_physics");
+    PhysicsAsync* async = world->async;
+    std::unique_lock<std::mutex> lock(async->mutex);
+    async->cv.wait(lock, [async] { return !async->busy; });
+}
+
+int32_t is_physics_busy(PhysicsWorld* world) {
+    if (!world || !world->async) return 0;
+    std::lock_guard<std::mutex> lock(world->async->mutex);
+    return world->async->busy ? 1 : 0;
+}
+
+const BodyTransformBuffer* get_body_transforms(PhysicsWorld* world) {
+    if (!world || !world->async) return NULL;
+    return &world->async->buffers[world->async->front.load(std::memory_order_acquire)];
+}
+
+void destroy_physics_async(PhysicsAsync* async) {
+    if (!async) return;
+    {
+        std::unique_lock<std::mutex> lock(async->mutex);
+        async->cv.wait(lock, [async] { return !async->busy; });
+        async->quit = true;
+    }
+    async->cv.notify_all();
+    async->thread.join();
+    free(async->buffers[0].transforms);
+    free(async->buffers[1].transforms);
+    delete async;
+}
+
+}
@@ -0,0 +1,49 @@
+#ifndef FLASH_PHYSICS_ASYNC_H
+#define FLASH_PHYSICS_ASYNC_H
+
+#include <stdint.h>
+
+struct PhysicsWorld;
+
+extern "C" {
+
+// Body pose published after each asynchronous step batch
+struct BodyTransform {
+    float x, y, rotation;
+    int32_t collisionCount;
+};
+
+// One side of the double buffer. Dart reads it without locks (zero-copy).
+struct BodyTransformBuffer {
+    BodyTransform* transforms;
+    int32_t count;        // Bodies in the world when the batch finished
+    int32_t capacity;
+    uint32_t batchIndex;  // Increments with every published batch
+};
+
+// Runs stepCount fixed steps of dt on the world's physics thread and returns
+// immediately. The thread is created on first use and lives until
+// destroy_physics_world. If a batch is still running, waits for it first.
+//
+// Until wait_physics returns, the world belongs to the physics thread: don't
+// create bodies, set velocities, read world->bodies or take snapshots. Only
+// get_body_transforms is safe meanwhile.
+void step_physics_async(PhysicsWorld* world, float dt, int32_t stepCount);
+
+// Blocks until the running batch (if any) is finished
+void wait_physics(PhysicsWorld* world);
+
+// 1 while a batch is running
+int32_t is_physics_busy(PhysicsWorld* world);
+
+// Transforms of the last completed batch, or NULL if the world was never
+// stepped asynchronously. The pointer stays valid until the next batch after
+// this one completes.
+const BodyTransformBuffer* get_body_transforms(PhysicsWorld* world);
+
+// Internal: stops and joins the physics thread (called by destroy_physics_world)
+void destroy_physics_async(struct PhysicsAsync* async);
+
+}
+
+#endif
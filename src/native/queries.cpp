@@ -0,0 +1,467 @@
+#include "queries.h"
+#include "physics.h"
+#include "flash_math.h"
+#include "broadphase.h"
+#include <cmath>
+#include <algorithm>
+
+extern "C" {
+
+namespace {
+    // Query shape in world space (circle or oriented box)
+    struct QueryShape {
+        int type;
+        float x, y;
+        float hw, hh;   // Box half extents
+        float radius;   // Circle radius
+        float c, s;     // cos/sin of rotation
+    };
+
+    QueryShape make_query_shape(int shapeType, float x, float y, float w, float h, float rotation) {
+        QueryShape q;
+        q.type = shapeType;
+        q.x = x;
+        q.y = y;
+        q.hw = w * 0.5f;
+        q.hh = h * 0.5f;
+        q.radius = (w < h ? w : h) * 0.5f;
+        q.c = flash_cos(rotation);
+        q.s = flash_sin(rotation);
+        return q;
+    }
+
+    QueryShape body_query_shape(const NativeBody& b) {
+        QueryShape q = make_query_shape(b.shapeType, b.x, b.y, b.width, b.height, b.rotation);
+        q.radius = b.radius;
+        return q;
+    }
+
+    AABB query_shape_aabb(const QueryShape& q) {
+        AABB aabb;
+        float ex, ey;
+        if (q.type == SHAPE_CIRCLE) {
+            ex = ey = q.radius;
+        } else {
+            ex = q.hw * std::abs(q.c) + q.hh * std::abs(q.s);
+            ey = q.hw * std::abs(q.s) + q.hh * std::abs(q.c);
+        }
+        aabb.minX = q.x - ex;
+        aabb.minY = q.y - ey;
+        aabb.maxX = q.x + ex;
+        aabb.maxY = q.y + ey;
+        return aabb;
+    }
+
+    inline bool passes_filter(const NativeBody& b, uint32_t categoryBits, uint32_t maskBits) {
+        return (b.categoryBits & maskBits) != 0 && (b.maskBits & categoryBits) != 0;
+    }
+
+    // Closest point on an oriented box to (px, py), returned in world space
+    void closest_point_on_box(const QueryShape& box, float px, float py, float& outX, float& outY) {
+        float dx = px - box.x;
+        float dy = py - box.y;
+        float lx = dx * box.c + dy * box.s;
+        float ly = -dx * box.s + dy * box.c;
+        lx = std::max(-box.hw, std::min(box.hw, lx));
+        ly = std::max(-box.hh, std::min(box.hh, ly));
+        outX = box.x + lx * box.c - ly * box.s;
+        outY = box.y + lx * box.s + ly * box.c;
+    }
+
+    bool point_in_shape(const QueryShape& q, float px, float py) {
+        float dx = px - q.x;
+        float dy = py - q.y;
+        if (q.type == SHAPE_CIRCLE) {
+            return dx * dx + dy * dy <= q.radius * q.radius;
+        }
+        float lx = dx * q.c + dy * q.s;
+        float ly = -dx * q.s + dy * q.c;
+        return std::abs(lx) <= q.hw && std::abs(ly) <= q.hh;
+    }
+
+    bool circle_overlaps_shape(const QueryShape& q, float cx, float cy, float r) {
+        if (q.type == SHAPE_CIRCLE) {
+            float dx = cx - q.x;
+            float dy = cy - q.y;
+            float rs = r + q.radius;
+            return dx * dx + dy * dy <= rs * rs;
+        }
+        float qx, qy;
+        closest_point_on_box(q, cx, cy, qx, qy);
+        float dx = cx - qx;
+        float dy = cy - qy;
+        return dx * dx + dy * dy <= r * r;
+    }
+
+    // Projected half extent of an oriented box on an axis
+    inline float box_extent_on_axis(const QueryShape& q, float ax, float ay) {
+        return q.hw * std::abs(q.c * ax + q.s * ay) + q.hh * std::abs(-q.s * ax + q.c * ay);
+    }
+
+    // SAT on the 4 face normals of the two boxes
+    bool box_overlaps_box(const QueryShape& a, const QueryShape& b) {
+        float axes[4][2] = {
+            { a.c, a.s }, { -a.s, a.c },
+            { b.c, b.s }, { -b.s, b.c }
+        };
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        for (int i = 0; i < 4; ++i) {
+            float ax = axes[i][0], ay = axes[i][1];
+            float dist = std::abs(dx * ax + dy * ay);
+            if (dist > box_extent_on_axis(a, ax, ay) + box_extent_on_axis(b, ax, ay)) return false;
+        }
+        return true;
+    }
+
+    bool shapes_overlap(const QueryShape& a, const QueryShape& b) {
+        if (a.type == SHAPE_CIRCLE) return circle_overlaps_shape(b, a.x, a.y, a.radius);
+        if (b.type == SHAPE_CIRCLE) return circle_overlaps_shape(a, b.x, b.y, b.radius);
+        return box_overlaps_box(a, b);
+    }
+
+    enum QueryMode {
+        QUERY_POINT = 0,
+        QUERY_SHAPE = 1
+    };
+
+    struct QueryContext {
+        PhysicsWorld* world;
+        int mode;
+        float px, py;
+        QueryShape shape;
+        uint32_t categoryBits;
+        uint32_t maskBits;
+        int32_t* outBodyIds;
+        int count;
+        int maxResults;
+    };
+
+    bool query_callback(uint32_t bodyId, void* context) {
+        QueryContext* ctx = (QueryContext*)context;
+        if (bodyId >= (uint32_t)ctx->world->activeCount) return true;
+
+        const NativeBody& b = ctx->world->bodies[bodyId];
+        if (!passes_filter(b, ctx->categoryBits, ctx->maskBits)) return true;
+
+        // Tree AABBs are fattened, so confirm against the actual shape
+        QueryShape bodyShape = body_query_shape(b);
+        bool hit = (ctx->mode == QUERY_POINT) ? point_in_shape(bodyShape, ctx->px, ctx->py)
+                                              : shapes_overlap(bodyShape, ctx->shape);
+        if (!hit) return true;
+
+        ctx->outBodyIds[ctx->count++] = (int32_t)bodyId;
+        return ctx->count < ctx->maxResults;
+    }
+
+    int run_shape_query(PhysicsWorld* world, const QueryShape& shape, uint32_t categoryBits, uint32_t maskBits,
+                        int32_t* outBodyIds, int maxResults) {
+        if (!world || !outBodyIds || maxResults <= 0) return 0;
+
+        QueryContext ctx;
+        ctx.world = world;
+        ctx.mode = QUERY_SHAPE;
+        ctx.px = ctx.py = 0.0f;
+        ctx.shape = shape;
+        ctx.categoryBits = categoryBits;
+        ctx.maskBits = maskBits;
+        ctx.outBodyIds = outBodyIds;
+        ctx.count = 0;
+        ctx.maxResults = maxResults;
+
+        tree_query(world->tree, query_shape_aabb(shape), query_callback, &ctx);
+        return ctx.count;
+    }
+
+    QueryShape make_aabb_shape(float minX, float minY, float maxX, float maxY) {
+        return make_query_shape(SHAPE_BOX, (minX + maxX) * 0.5f, (minY + maxY) * 0.5f, maxX - minX, maxY - minY, 0.0f);
+    }
+
+    // --- Shape Cast (conservative advancement) ---
+
+    struct Separation {
+        float distance;   // Gap along the normal (negative when overlapping)
+        float nx, ny;     // Separating axis, points from B towards A
+        float px, py;     // Witness point on B
+    };
+
+    void box_vertices(const QueryShape& q, float out[4][2]) {
+        const float sx[4] = { -1.0f, 1.0f, 1.0f, -1.0f };
+        const float sy[4] = { -1.0f, -1.0f, 1.0f, 1.0f };
+        for (int i = 0; i < 4; ++i) {
+            float lx = sx[i] * q.hw, ly = sy[i] * q.hh;
+            out[i][0] = q.x + lx * q.c - ly * q.s;
+            out[i][1] = q.y + lx * q.s + ly * q.c;
+        }
+    }
+
+    // Separation of a circle (A) from a shape (B). Exact distance.
+    Separation circle_separation(float cx, float cy, float r, const QueryShape& b) {
+        Separation sep;
+        if (b.type == SHAPE_CIRCLE) {
+            float dx = cx - b.x, dy = cy - b.y;
+            float dist = std::sqrt(dx * dx + dy * dy);
+            if (dist > 1e-6f) { sep.nx = dx / dist; sep.ny = dy / dist; }
+            else { sep.nx = 0.0f; sep.ny = 1.0f; }
+            sep.distance = dist - r - b.radius;
+            sep.px = b.x + sep.nx * b.radius;
+            sep.py = b.y + sep.ny * b.radius;
+            return sep;
+        }
+
+        float dx = cx - b.x, dy = cy - b.y;
+        float lx = dx * b.c + dy * b.s;
+        float ly = -dx * b.s + dy * b.c;
+
+        if (std::abs(lx) <= b.hw && std::abs(ly) <= b.hh) {
+            // Center inside the box: push out through the closest face
+            float penX = b.hw - std::abs(lx);
+            float penY = b.hh - std::abs(ly);
+            float nlx = 0.0f, nly = 0.0f;
+            if (penX < penY) { nlx = lx > 0 ? 1.0f : -1.0f; sep.distance = -penX - r; }
+            else { nly = ly > 0 ? 1.0f : -1.0f; sep.distance = -penY - r; }
+            sep.nx = nlx * b.c - nly * b.s;
+            sep.ny = nlx * b.s + nly * b.c;
+            float fx = nlx != 0.0f ? nlx * b.hw : lx;
+            float fy = nly != 0.0f ? nly * b.hh : ly;
+            sep.px = b.x + fx * b.c - fy * b.s;
+            sep.py = b.y + fx * b.s + fy * b.c;
+            return sep;
+        }
+
+        closest_point_on_box(b, cx, cy, sep.px, sep.py);
+        float ex = cx - sep.px, ey = cy - sep.py;
+        float dist = std::sqrt(ex * ex + ey * ey);
+        if (dist > 1e-6f) { sep.nx = ex / dist; sep.ny = ey / dist; }
+        else { sep.nx = 0.0f; sep.ny = 1.0f; }
+        sep.distance = dist - r;
+        return sep;
+    }
+
+    // Separation of two boxes via SAT on face normals. The gap along the best
+    // axis is a lower bound of the true distance, which is all conservative
+    // advancement needs.
+    Separation box_separation(const QueryShape& a, const QueryShape& b) {
+        float axes[4][2] = {
+            { a.c, a.s }, { -a.s, a.c },
+            { b.c, b.s }, { -b.s, b.c }
+        };
+        Separation sep;
+        sep.distance = -1e10f;
+        sep.nx = 0.0f; sep.ny = 1.0f;
+
+        float dx = a.x - b.x, dy = a.y - b.y;
+        for (int i = 0; i < 4; ++i) {
+            float ax = axes[i][0], ay = axes[i][1];
+            float d = dx * ax + dy * ay;
+            float gap = std::abs(d) - box_extent_on_axis(a, ax, ay) - box_extent_on_axis(b, ax, ay);
+            if (gap > sep.distance) {
+                sep.distance = gap;
+                float sign = d >= 0.0f ? 1.0f : -1.0f;
+                sep.nx = ax * sign;
+                sep.ny = ay * sign;
+            }
+        }
+
+        // Witness: A's vertex closest to B, moved onto B's side of the gap
+        float va[4][2];
+        box_vertices(a, va);
+        int best = 0;
+        float bestProj = va[0][0] * sep.nx + va[0][1] * sep.ny;
+        for (int i = 1; i < 4; ++i) {
+            float proj = va[i][0] * sep.nx + va[i][1] * sep.ny;
+            if (proj < bestProj) { bestProj = proj; best = i; }
+        }
+        float push = std::max(sep.distance, 0.0f);
+        sep.px = va[best][0] - sep.nx * push;
+        sep.py = va[best][1] - sep.ny * push;
+        return sep;
+    }
+
+    Separation shape_separation(const QueryShape& a, const QueryShape& b) {
+        if (a.type == SHAPE_CIRCLE) return circle_separation(a.x, a.y, a.radius, b);
+        if (b.type == SHAPE_CIRCLE) {
+            Separation sep = circle_separation(b.x, b.y, b.radius, a);
+            // Flip so the normal points from B to A and the witness lies on B
+            sep.nx = -sep.nx;
+            sep.ny = -sep.ny;
+            sep.px = b.x + sep.nx * b.radius;
+            sep.py = b.y + sep.ny * b.radius;
+            return sep;
+        }
+        return box_separation(a, b);
+    }
+
+    const float castTolerance = 0.05f;   // Target gap at time of impact (pixels)
+    const int castMaxIterations = 20;
+
+    // Time of impact of A translating by (tx, ty) against static B.
+    // Returns false when A never touches B within the translation.
+    bool time_of_impact(const QueryShape& a, const QueryShape& b, float tx, float ty, float& outT, Separation& outSep) {
+        float t = 0.0f;
+        QueryShape moving = a;
+        for (int iter = 0; iter < castMaxIterations; ++iter) {
+            moving.x = a.x + tx * t;
+            moving.y = a.y + ty * t;
+            Separation sep = shape_separation(moving, b);
+
+            float approach = -(tx * sep.nx + ty * sep.ny);
+            if (sep.distance <= castTolerance) {
+                // Starting inside B but moving out of it is not a hit
+                if (t == 0.0f && sep.distance < 0.0f && approach <= 0.0f) return false;
+                outT = t;
+                outSep = sep;
+                return true;
+            }
+
+            // Separated along the axis and not closing in: can never touch
+            if (approach <= 1e-9f) return false;
+
+            // B cannot be reached before the gap along the separating axis closes
+            t += (sep.distance - castTolerance * 0.5f) / approach;
+            if (t > 1.0f) return false;
+        }
+        return false;
+    }
+
+    struct CastContext {
+        PhysicsWorld* world;
+        QueryShape shape;
+        float tx, ty;
+        uint32_t categoryBits;
+        uint32_t maskBits;
+        int32_t ignoreBodyId;
+        ShapeCastHit* result;
+    };
+
+    bool cast_callback(uint32_t bodyId, void* context) {
+        CastContext* ctx = (CastContext*)context;
+        if (bodyId >= (uint32_t)ctx->world->activeCount) return true;
+        if ((int32_t)bodyId == ctx->ignoreBodyId) return true;
+
+        const NativeBody& b = ctx->world->bodies[bodyId];
+        if (b.isSensor) return true; // Sensors never block a cast
+        if (!passes_filter(b, ctx->categoryBits, ctx->maskBits)) return true;
+
+        float t;
+        Separation sep;
+        if (time_of_impact(ctx->shape, body_query_shape(b), ctx->tx, ctx->ty, t, sep) && t < ctx->result->fraction) {
+            ctx->result->hit = 1;
+            ctx->result->bodyId = (int32_t)bodyId;
+            ctx->result->fraction = t;
+            ctx->result->normalX = sep.nx;
+            ctx->result->normalY = sep.ny;
+            ctx->result->x = sep.px;
+            ctx->result->y = sep.py;
+        }
+        return true;
+    }
+}
+
+int query_aabb(PhysicsWorld* world, float minX, float minY, float maxX, float maxY,
+               uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults) {
+    return run_shape_query(world, make_aabb_shape(minX, minY, maxX, maxY), categoryBits, maskBits, outBodyIds, maxResults);
+}
+
+int query_point(PhysicsWorld* world, float x, float y,
+                uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults) {
+    if (!world || !outBodyIds || maxResults <= 0) return 0;
+
+    QueryContext ctx;
+    ctx.world = world;
+    ctx.mode = QUERY_POINT;
+    ctx.px = x;
+    ctx.py = y;
+    ctx.categoryBits = categoryBits;
+    ctx.maskBits = maskBits;
+    ctx.outBodyIds = outBodyIds;
+    ctx.count = 0;
+    ctx.maxResults = maxResults;
+
+    AABB aabb = { x, y, x, y };
+    tree_query(world->tree, aabb, query_callback, &ctx);
+    return ctx.count;
+}
+
+int overlap_shape(PhysicsWorld* world, int shapeType, float x, float y, float w, float h, float rotation,
+                  uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults) {
+    QueryShape shape = make_query_shape(shapeType, x, y, w, h, rotation);
+    return run_shape_query(world, shape, categoryBits, maskBits, outBodyIds, maxResults);
+}
+
+ShapeCastHit shape_cast(PhysicsWorld* world, int shapeType, float w, float h, float rotation,
+                        float startX, float startY, float translationX, float translationY,
+                        uint32_t categoryBits, uint32_t maskBits, int32_t ignoreBodyId) {
+    ShapeCastHit result;
+    result.hit = 0;
+    result.bodyId = -1;
+    result.fraction = 1.0f;
+    result.x = result.y = 0.0f;
+    result.normalX = result.normalY = 0.0f;
+
+    if (!world) return result;
+
+    CastContext ctx;
+    ctx.world = world;
+    ctx.shape = make_query_shape(shapeType, startX, startY, w, h, rotation);
+    ctx.tx = translationX;
+    ctx.ty = translationY;
+    ctx.categoryBits = categoryBits;
+    ctx.maskBits = maskBits;
+    ctx.ignoreBodyId = ignoreBodyId;
+    ctx.result = &result;
+
+    // Swept AABB: union of the start and end bounds
+    AABB aabb = query_shape_aabb(ctx.shape);
+    aabb.minX += std::min(translationX, 0.0f);
+    aabb.minY += std::min(translationY, 0.0f);
+    aabb.maxX += std::max(translationX, 0.0f);
+    aabb.maxY += std::max(translationY, 0.0f);
+    aabb.fatten(castTolerance);
+
+    tree_query(world->tree, aabb, cast_callback, &ctx);
+    return result;
+}
+
+int query_aabb_batch(PhysicsWorld* world, const float* aabbs, int queryCount,
+                     uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults, int32_t* outCounts) {
+    if (!world || !aabbs || !outCounts) return 0;
+
+    int total = 0;
+    for (int i = 0; i < queryCount; ++i) {
+        const float* q = aabbs + i * 4;
+        outCounts[i] = run_shape_query(world, make_aabb_shape(q[0], q[1], q[2], q[3]), categoryBits, maskBits,
+                                       outBodyIds + total, maxResults - total);
+        total += outCounts[i];
+    }
+    return total;
+}
+
+int query_point_batch(PhysicsWorld* world, const float* points, int queryCount,
+                      uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults, int32_t* outCounts) {
+    if (!world || !points || !outCounts) return 0;
+
+    int total = 0;
+    for (int i = 0; i < queryCount; ++i) {
+        outCounts[i] = query_point(world, points[i * 2], points[i * 2 + 1], categoryBits, maskBits,
+                                   outBodyIds + total, maxResults - total);
+        total += outCounts[i];
+    }
+    return total;
+}
+
+int overlap_shape_batch(PhysicsWorld* world, int shapeType, const float* shapes, int queryCount,
+                        uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults, int32_t* outCounts) {
+    if (!world || !shapes || !outCounts) return 0;
+
+    int total = 0;
+    for (int i = 0; i < queryCount; ++i) {
+        const float* q = shapes + i * 5;
+        outCounts[i] = overlap_shape(world, shapeType, q[0], q[1], q[2], q[3], q[4], categoryBits, maskBits,
+                                     outBodyIds + total, maxResults - total);
+        total += outCounts[i];
+    }
+    return total;
+}
+
+}
@@ -0,0 +1,67 @@
+#ifndef FLASH_QUERIES_H
+#define FLASH_QUERIES_H
+
+#include <stdint.h>
+
+extern "C" {
+
+// Spatial queries against the broadphase tree (Box2D b2World_OverlapAABB-style).
+//
+// Matching body IDs are written to a caller-owned buffer and the number of IDs
+// written is returned (never more than maxResults).
+// Filtering follows the body collision rules:
+//   (body.categoryBits & maskBits) != 0 && (body.maskBits & categoryBits) != 0
+
+// All bodies whose shape overlaps the AABB
+int query_aabb(struct PhysicsWorld* world, float minX, float minY, float maxX, float maxY,
+               uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults);
+
+// All bodies containing the point (mouse picking)
+int query_point(struct PhysicsWorld* world, float x, float y,
+                uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults);
+
+// All bodies overlapping a circle or box. Shape parameters match create_body
+// (circle radius = min(w, h) / 2).
+int overlap_shape(struct PhysicsWorld* world, int shapeType, float x, float y, float w, float h, float rotation,
+                  uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults);
+
+// Batched variants. Results of all queries are packed back to back into outBodyIds,
+// outCounts[i] receives the number of IDs written for query i.
+// Returns the total number of IDs written. Once outBodyIds is full the
+// remaining queries report 0, so a total of maxResults may be cut short.
+
+// aabbs: 4 floats per query (minX, minY, maxX, maxY)
+int query_aabb_batch(struct PhysicsWorld* world, const float* aabbs, int queryCount,
+                     uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults, int32_t* outCounts);
+
+// points: 2 floats per query (x, y)
+int query_point_batch(struct PhysicsWorld* world, const float* points, int queryCount,
+                      uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults, int32_t* outCounts);
+
+// shapes: 5 floats per query (x, y, w, h, rotation)
+int overlap_shape_batch(struct PhysicsWorld* world, int shapeType, const float* shapes, int queryCount,
+                        uint32_t categoryBits, uint32_t maskBits, int32_t* outBodyIds, int maxResults, int32_t* outCounts);
+
+// Shape cast result (same layout as RayCastHit)
+struct ShapeCastHit {
+    int32_t bodyId;
+    float x;        // Contact point on the hit body
+    float y;
+    float normalX;  // Surface normal of the hit body (points towards the cast shape)
+    float normalY;
+    float fraction; // 0.0 to 1.0 along the translation
+    int hit;        // boolean flag
+};
+
+// Sweep a circle or box from (startX, startY) along (translationX, translationY) and
+// return the first body it touches (conservative advancement, Box2D b2ShapeCast-style).
+// The shape does not rotate during the sweep. Bodies the shape starts inside of are
+// reported at fraction 0 unless the translation moves out of them.
+// Sensor bodies are ignored. ignoreBodyId skips one body (e.g. the caster's own body), -1 for none.
+ShapeCastHit shape_cast(struct PhysicsWorld* world, int shapeType, float w, float h, float rotation,
+                        float startX, float startY, float translationX, float translationY,
+                        uint32_t categoryBits, uint32_t maskBits, int32_t ignoreBodyId);
+
+}
+
+#endif
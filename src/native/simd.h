@@ -0,0 +1,150 @@
+#ifndef FLASH_SIMD_H
+#define FLASH_SIMD_H
+
+#include <stdint.h>
+#include <math.h>
+
+// 8-lane float batch for struct-of-arrays kernels.
+//
+// AVX builds use one 256-bit register, SSE2 (x86_64) and NEON (arm64) use two
+// 128-bit registers, anything else falls back to scalar lanes. Loads and stores
+// are aligned: streams must be 32-byte aligned and padded to a multiple of 8.
+// storeu is the exception, for writing into caller-owned vertex buffers.
+
+#if defined(__AVX__)
+  #include <immintrin.h>
+  #define FLASH_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define FLASH_SIMD_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define FLASH_SIMD_NEON 1
+#endif
+
+namespace simd {
+
+const int kLanes = 8;
+const int kAlignment = 32;
+
+#if defined(FLASH_SIMD_AVX)
+
+struct F32x8 { __m256 v; };
+
+inline F32x8 load(const float* p) { F32x8 r = {_mm256_load_ps(p)}; return r; }
+inline void store(float* p, F32x8 a) { _mm256_store_ps(p, a.v); }
+inline void storeu(float* p, F32x8 a) { _mm256_storeu_ps(p, a.v); }
+inline F32x8 set1(float s) { F32x8 r = {_mm256_set1_ps(s)}; return r; }
+inline F32x8 set_pair(float a, float b) { F32x8 r = {_mm256_setr_ps(a, b, a, b, a, b, a, b)}; return r; }
+inline F32x8 add(F32x8 a, F32x8 b) { F32x8 r = {_mm256_add_ps(a.v, b.v)}; return r; }
+inline F32x8 sub(F32x8 a, F32x8 b) { F32x8 r = {_mm256_sub_ps(a.v, b.v)}; return r; }
+inline F32x8 mul(F32x8 a, F32x8 b) { F32x8 r = {_mm256_mul_ps(a.v, b.v)}; return r; }
+inline F32x8 div(F32x8 a, F32x8 b) { F32x8 r = {_mm256_div_ps(a.v, b.v)}; return r; }
+inline F32x8 sqrt(F32x8 a) { F32x8 r = {_mm256_sqrt_ps(a.v)}; return r; }
+inline F32x8 min(F32x8 a, F32x8 b) { F32x8 r = {_mm256_min_ps(a.v, b.v)}; return r; }
+inline F32x8 max(F32x8 a, F32x8 b) { F32x8 r = {_mm256_max_ps(a.v, b.v)}; return r; }
+inline F32x8 floor(F32x8 a) { F32x8 r = {_mm256_floor_ps(a.v)}; return r; }
+// v where a < b, else 0
+inline F32x8 select_lt(F32x8 a, F32x8 b, F32x8 v) { F32x8 r = {_mm256_and_ps(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ), v.v)}; return r; }
+// Bit i set when lane i <= 0
+inline int mask_le_zero(F32x8 a) { return _mm256_movemask_ps(_mm256_cmp_ps(a.v, _mm256_setzero_ps(), _CMP_LE_OQ)); }
+
+#elif defined(FLASH_SIMD_SSE)
+
+struct F32x8 { __m128 lo, hi; };
+
+inline F32x8 load(const float* p) { F32x8 r = {_mm_load_ps(p), _mm_load_ps(p + 4)}; return r; }
+inline void store(float* p, F32x8 a) { _mm_store_ps(p, a.lo); _mm_store_ps(p + 4, a.hi); }
+inline void storeu(float* p, F32x8 a) { _mm_storeu_ps(p, a.lo); _mm_storeu_ps(p + 4, a.hi); }
+inline F32x8 set1(float s) { F32x8 r = {_mm_set1_ps(s), _mm_set1_ps(s)}; return r; }
+inline F32x8 set_pair(float a, float b) { __m128 v = _mm_setr_ps(a, b, a, b); F32x8 r = {v, v}; return r; }
+inline F32x8 add(F32x8 a, F32x8 b) { F32x8 r = {_mm_add_ps(a.lo, b.lo), _mm_add_ps(a.hi, b.hi)}; return r; }
+inline F32x8 sub(F32x8 a, F32x8 b) { F32x8 r = {_mm_sub_ps(a.lo, b.lo), _mm_sub_ps(a.hi, b.hi)}; return r; }
+inline F32x8 mul(F32x8 a, F32x8 b) { F32x8 r = {_mm_mul_ps(a.lo, b.lo), _mm_mul_ps(a.hi, b.hi)}; return r; }
+inline F32x8 div(F32x8 a, F32x8 b) { F32x8 r = {_mm_div_ps(a.lo, b.lo), _mm_div_ps(a.hi, b.hi)}; return r; }
+inline F32x8 sqrt(F32x8 a) { F32x8 r = {_mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi)}; return r; }
+inline F32x8 min(F32x8 a, F32x8 b) { F32x8 r = {_mm_min_ps(a.lo, b.lo), _mm_min_ps(a.hi, b.hi)}; return r; }
+inline F32x8 max(F32x8 a, F32x8 b) { F32x8 r = {_mm_max_ps(a.lo, b.lo), _mm_max_ps(a.hi, b.hi)}; return r; }
+// SSE2 has no round instruction: truncate, then step down where that rounded up
+// (valid while |a| < 2^31)
+inline __m128 floor_ps(__m128 a) {
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+}
+inline F32x8 floor(F32x8 a) { F32x8 r = {floor_ps(a.lo), floor_ps(a.hi)}; return r; }
+inline F32x8 select_lt(F32x8 a, F32x8 b, F32x8 v) {
+    F32x8 r = {_mm_and_ps(_mm_cmplt_ps(a.lo, b.lo), v.lo), _mm_and_ps(_mm_cmplt_ps(a.hi, b.hi), v.hi)};
+    return r;
+}
+inline int mask_le_zero(F32x8 a) {
+    __m128 zero = _mm_setzero_ps();
+    return _mm_movemask_ps(_mm_cmple_ps(a.lo, zero)) | (_mm_movemask_ps(_mm_cmple_ps(a.hi, zero)) << 4);
+}
+
+#elif defined(FLASH_SIMD_NEON)
+
+struct F32x8 { float32x4_t lo, hi; };
+
+inline F32x8 load(const float* p) { F32x8 r = {vld1q_f32(p), vld1q_f32(p + 4)}; return r; }
+inline void store(float* p, F32x8 a) { vst1q_f32(p, a.lo); vst1q_f32(p + 4, a.hi); }
+inline void storeu(float* p, F32x8 a) { store(p, a); } // vst1q has no alignment requirement
+inline F32x8 set1(float s) { F32x8 r = {vdupq_n_f32(s), vdupq_n_f32(s)}; return r; }
+inline F32x8 set_pair(float a, float b) {
+    float32x2_t ab = vset_lane_f32(b, vdup_n_f32(a), 1);
+    float32x4_t v = vcombine_f32(ab, ab);
+    F32x8 r = {v, v};
+    return r;
+}
+inline F32x8 add(F32x8 a, F32x8 b) { F32x8 r = {vaddq_f32(a.lo, b.lo), vaddq_f32(a.hi, b.hi)}; return r; }
+inline F32x8 sub(F32x8 a, F32x8 b) { F32x8 r = {vsubq_f32(a.lo, b.lo), vsubq_f32(a.hi, b.hi)}; return r; }
+inline F32x8 mul(F32x8 a, F32x8 b) { F32x8 r = {vmulq_f32(a.lo, b.lo), vmulq_f32(a.hi, b.hi)}; return r; }
+inline F32x8 div(F32x8 a, F32x8 b) { F32x8 r = {vdivq_f32(a.lo, b.lo), vdivq_f32(a.hi, b.hi)}; return r; }
+inline F32x8 sqrt(F32x8 a) { F32x8 r = {vsqrtq_f32(a.lo), vsqrtq_f32(a.hi)}; return r; }
+inline F32x8 min(F32x8 a, F32x8 b) { F32x8 r = {vminq_f32(a.lo, b.lo), vminq_f32(a.hi, b.hi)}; return r; }
+inline F32x8 max(F32x8 a, F32x8 b) { F32x8 r = {vmaxq_f32(a.lo, b.lo), vmaxq_f32(a.hi, b.hi)}; return r; }
+inline F32x8 floor(F32x8 a) { F32x8 r = {vrndmq_f32(a.lo), vrndmq_f32(a.hi)}; return r; }
+inline F32x8 select_lt(F32x8 a, F32x8 b, F32x8 v) {
+    F32x8 r = {vreinterpretq_f32_u32(vandq_u32(vcltq_f32(a.lo, b.lo), vreinterpretq_u32_f32(v.lo))),
+               vreinterpretq_f32_u32(vandq_u32(vcltq_f32(a.hi, b.hi), vreinterpretq_u32_f32(v.hi)))};
+    return r;
+}
+inline int mask_le_zero(F32x8 a) {
+    // Narrow the two 4 x 32-bit compare masks to bytes, then gather one bit per lane
+    uint32x4_t lo = vcleq_f32(a.lo, vdupq_n_f32(0.0f));
+    uint32x4_t hi = vcleq_f32(a.hi, vdupq_n_f32(0.0f));
+    uint16x8_t both = vcombine_u16(vmovn_u32(lo), vmovn_u32(hi));
+    static const uint16_t bits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    return (int)vaddvq_u16(vandq_u16(both, vld1q_u16(bits)));
+}
+
+#else
+
+struct F32x8 { float v[8]; };
+
+inline F32x8 load(const float* p) { F32x8 r; for (int i = 0; i < 8; ++i) r.v[i] = p[i]; return r; }
+inline void store(float* p, F32x8 a) { for (int i = 0; i < 8; ++i) p[i] = a.v[i]; }
+inline void storeu(float* p, F32x8 a) { store(p, a); }
+inline F32x8 set1(float s) { F32x8 r; for (int i = 0; i < 8; ++i) r.v[i] = s; return r; }
+inline F32x8 set_pair(float a, float b) { F32x8 r; for (int i = 0; i < 8; ++i) r.v[i] = (i & 1) ? b : a; return r; }
+inline F32x8 add(F32x8 a, F32x8 b) { for (int i = 0; i < 8; ++i) a.v[i] += b.v[i]; return a; }
+inline F32x8 sub(F32x8 a, F32x8 b) { for (int i = 0; i < 8; ++i) a.v[i] -= b.v[i]; return a; }
+inline F32x8 mul(F32x8 a, F32x8 b) { for (int i = 0; i < 8; ++i) a.v[i] *= b.v[i]; return a; }
+inline F32x8 div(F32x8 a, F32x8 b) { for (int i = 0; i < 8; ++i) a.v[i] /= b.v[i]; return a; }
+inline F32x8 sqrt(F32x8 a) { for (int i = 0; i < 8; ++i) a.v[i] = sqrtf(a.v[i]); return a; }
+inline F32x8 min(F32x8 a, F32x8 b) { for (int i = 0; i < 8; ++i) a.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i]; return a; }
+inline F32x8 max(F32x8 a, F32x8 b) { for (int i = 0; i < 8; ++i) a.v[i] = b.v[i] > a.v[i] ? b.v[i] : a.v[i]; return a; }
+inline F32x8 floor(F32x8 a) { for (int i = 0; i < 8; ++i) a.v[i] = floorf(a.v[i]); return a; }
+inline F32x8 select_lt(F32x8 a, F32x8 b, F32x8 v) { for (int i = 0; i < 8; ++i) v.v[i] = a.v[i] < b.v[i] ? v.v[i] : 0.0f; return v; }
+inline int mask_le_zero(F32x8 a) { int m = 0; for (int i = 0; i < 8; ++i) m |= (a.v[i] <= 0.0f) << i; return m; }
+
+#endif
+
+// a * b + c (two instructions: results don't depend on FMA availability)
+inline F32x8 mul_add(F32x8 a, F32x8 b, F32x8 c) { return add(mul(a, b), c); }
+
+// Rounds a stream length up to whole batches
+inline int padded_count(int count) { return (count + kLanes - 1) & ~(kLanes - 1); }
+
+}
+
+#endif
@@ -0,0 +1,343 @@
+#include "snapshot.h"
+#include "physics.h"
+#include "broadphase.h"
+#include "joints.h"
+#include "events.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    const uint32_t kSnapshotMagic = 0x504E5346; // "FSNP"
+    const uint32_t kDeltaMagic = 0x544C4446;    // "FDLT"
+    const uint32_t kSnapshotVersion = 1;
+
+    struct SnapshotHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t size;
+        int32_t maxBodies;
+
+        // World settings
+        float gravityX, gravityY;
+        int32_t velocityIterations;
+        int32_t positionIterations;
+        int32_t enableWarmStarting;
+        float contactHertz;
+        float contactDampingRatio;
+        float restitutionThreshold;
+        float maxLinearVelocity;
+        float hitEventThreshold;
+
+        // Element counts
+        int32_t bodyCount;
+        int32_t manifoldCount;
+        int32_t constraintCount;
+        int32_t jointCount;
+        int32_t softBodyCount;
+        int32_t warmStartCount;
+        int32_t contactKeyCount;
+        int32_t sensorKeyCount;
+
+        // Broadphase tree
+        int32_t treeRoot;
+        int32_t treeNodeCount;
+        int32_t treeNodeCapacity;
+        int32_t treeFreeList;
+
+        // Section offsets from the start of the snapshot
+        uint32_t bodiesOffset;
+        uint32_t manifoldsOffset;
+        uint32_t constraintsOffset;
+        uint32_t jointsOffset;
+        uint32_t softBodiesOffset;
+        uint32_t softBodyDataOffset; // Points then constraints of each soft body, in order
+        uint32_t treeNodesOffset;
+        uint32_t warmStartOffset;
+        uint32_t contactKeysOffset;
+        uint32_t sensorKeysOffset;
+    };
+
+    struct DeltaHeader {
+        uint32_t magic;
+        uint32_t size; // Size of the snapshot this delta rebuilds
+    };
+
+    inline uint32_t align8(uint32_t x) { return (x + 7u) & ~7u; }
+
+    // Lay out all sections. Offsets are written into header, the total size is returned.
+    uint32_t layout_snapshot(PhysicsWorld* world, SnapshotHeader& h) {
+        memset(&h, 0, sizeof(h));
+        h.bodyCount = world->activeCount;
+        h.manifoldCount = world->manifolds ? world->activeManifolds : 0;
+        h.constraintCount = world->constraints ? world->activeConstraints : 0;
+        h.jointCount = world->boxJoints ? world->activeBoxJoints : 0;
+        h.softBodyCount = world->softBodies ? world->activeSoftBodies : 0;
+        h.warmStartCount = world->warmStartCache ? world->warmStartCache->count : 0;
+        h.contactKeyCount = world->contactTracker ? (int32_t)world->contactTracker->previousContacts.size() : 0;
+        h.sensorKeyCount = world->contactTracker ? (int32_t)world->contactTracker->previousSensors.size() : 0;
+        h.treeNodeCapacity = world->tree ? world->tree->nodeCapacity : 0;
+
+        uint32_t offset = align8(sizeof(SnapshotHeader));
+        h.bodiesOffset = offset;       offset = align8(offset + h.bodyCount * sizeof(NativeBody));
+        h.manifoldsOffset = offset;    offset = align8(offset + h.manifoldCount * sizeof(ContactManifold));
+        h.constraintsOffset = offset;  offset = align8(offset + h.constraintCount * sizeof(ContactConstraint));
+        h.jointsOffset = offset;       offset = align8(offset + h.jointCount * sizeof(Joint));
+        h.softBodiesOffset = offset;   offset = align8(offset + h.softBodyCount * sizeof(NativeSoftBody));
+        h.softBodyDataOffset = offset;
+        for (int i = 0; i < h.softBodyCount; ++i) {
+            const NativeSoftBody& sb = world->softBodies[i];
+            offset = align8(offset + sb.pointCount * sizeof(SoftBodyPoint) + sb.constraintCount * sizeof(SoftBodyConstraint));
+        }
+        h.treeNodesOffset = offset;    offset = align8(offset + h.treeNodeCapacity * sizeof(TreeNode));
+        h.warmStartOffset = offset;    offset = align8(offset + h.warmStartCount * sizeof(WarmStartEntry));
+        h.contactKeysOffset = offset;  offset = align8(offset + h.contactKeyCount * sizeof(uint64_t));
+        h.sensorKeysOffset = offset;   offset = align8(offset + h.sensorKeyCount * sizeof(uint64_t));
+        return offset;
+    }
+
+    // Replace a soft body's arrays if the snapshot needs a different size
+    void resize_soft_body(NativeSoftBody& sb, int pointCount, int constraintCount) {
+        if (!sb.points || sb.pointCount != pointCount) {
+            free(sb.points);
+            sb.points = (SoftBodyPoint*)calloc(pointCount, sizeof(SoftBodyPoint));
+        }
+        if (!sb.constraints || sb.constraintCount != constraintCount) {
+            free(sb.constraints);
+            sb.constraints = (SoftBodyConstraint*)calloc(constraintCount, sizeof(SoftBodyConstraint));
+        }
+    }
+
+    void restore_keys(std::vector<uint64_t>& keys, const uint8_t* src, int count) {
+        keys.resize(count);
+        if (count > 0) memcpy(&keys[0], src, count * sizeof(uint64_t));
+    }
+
+    inline uint32_t load_word(const uint8_t* data, int size, uint32_t index) {
+        if ((index + 1) * 4 > (uint32_t)size) return 0; // Past the end of the base: treat as zero
+        uint32_t w;
+        memcpy(&w, data + index * 4, 4);
+        return w;
+    }
+}
+
+extern "C" {
+
+int get_snapshot_size(PhysicsWorld* world) {
+    if (!world) return 0;
+    SnapshotHeader h;
+    return (int)layout_snapshot(world, h);
+}
+
+int snapshot_world(PhysicsWorld* world, uint8_t* buffer, int capacity) {
+    if (!world || !buffer) return 0;
+
+    SnapshotHeader h;
+    uint32_t size = layout_snapshot(world, h);
+    if ((uint32_t)capacity < size) return 0;
+
+    h.magic = kSnapshotMagic;
+    h.version = kSnapshotVersion;
+    h.size = size;
+    h.maxBodies = world->maxBodies;
+    h.gravityX = world->gravityX;
+    h.gravityY = world->gravityY;
+    h.velocityIterations = world->velocityIterations;
+    h.positionIterations = world->positionIterations;
+    h.enableWarmStarting = world->enableWarmStarting;
+    h.contactHertz = world->contactHertz;
+    h.contactDampingRatio = world->contactDampingRatio;
+    h.restitutionThreshold = world->restitutionThreshold;
+    h.maxLinearVelocity = world->maxLinearVelocity;
+    h.hitEventThreshold = world->hitEventThreshold;
+    if (world->tree) {
+        h.treeRoot = world->tree->root;
+        h.treeNodeCount = world->tree->nodeCount;
+        h.treeFreeList = world->tree->freeList;
+    }
+
+    // Zero the whole block so alignment padding is stable (keeps deltas small)
+    memset(buffer, 0, size);
+    memcpy(buffer, &h, sizeof(h));
+    memcpy(buffer + h.bodiesOffset, world->bodies, h.bodyCount * sizeof(NativeBody));
+    if (h.manifoldCount) memcpy(buffer + h.manifoldsOffset, world->manifolds, h.manifoldCount * sizeof(ContactManifold));
+    if (h.constraintCount) memcpy(buffer + h.constraintsOffset, world->constraints, h.constraintCount * sizeof(ContactConstraint));
+    if (h.jointCount) memcpy(buffer + h.jointsOffset, world->boxJoints, h.jointCount * sizeof(Joint));
+
+    uint32_t dataOffset = h.softBodyDataOffset;
+    for (int i = 0; i < h.softBodyCount; ++i) {
+        NativeSoftBody sb = world->softBodies[i];
+        uint32_t pointBytes = sb.pointCount * sizeof(SoftBodyPoint);
+        uint32_t constraintBytes = sb.constraintCount * sizeof(SoftBodyConstraint);
+        memcpy(buffer + dataOffset, sb.points, pointBytes);
+        memcpy(buffer + dataOffset + pointBytes, sb.constraints, constraintBytes);
+        dataOffset = align8(dataOffset + pointBytes + constraintBytes);
+
+        // Pointers are meaningless in a snapshot
+        sb.points = NULL;
+        sb.constraints = NULL;
+        memcpy(buffer + h.softBodiesOffset + i * sizeof(NativeSoftBody), &sb, sizeof(NativeSoftBody));
+    }
+
+    if (h.treeNodeCapacity) memcpy(buffer + h.treeNodesOffset, world->tree->nodes, h.treeNodeCapacity * sizeof(TreeNode));
+    if (h.warmStartCount) memcpy(buffer + h.warmStartOffset, world->warmStartCache->entries, h.warmStartCount * sizeof(WarmStartEntry));
+    if (h.contactKeyCount) memcpy(buffer + h.contactKeysOffset, &world->contactTracker->previousContacts[0], h.contactKeyCount * sizeof(uint64_t));
+    if (h.sensorKeyCount) memcpy(buffer + h.sensorKeysOffset, &world->contactTracker->previousSensors[0], h.sensorKeyCount * sizeof(uint64_t));
+
+    return (int)size;
+}
+
+int restore_world(PhysicsWorld* world, const uint8_t* buffer, int size) {
+    if (!world || !buffer || size < (int)sizeof(SnapshotHeader)) return 0;
+
+    SnapshotHeader h;
+    memcpy(&h, buffer, sizeof(h));
+    if (h.magic != kSnapshotMagic || h.version != kSnapshotVersion || h.size > (uint32_t)size) return 0;
+    if (h.maxBodies != world->maxBodies || h.bodyCount > world->maxBodies) return 0;
+    if (h.manifoldCount > world->maxManifolds || h.constraintCount > world->maxConstraints) return 0;
+    if (h.jointCount > world->maxBoxJoints || h.softBodyCount > world->maxSoftBodies) return 0;
+    if (world->warmStartCache && h.warmStartCount > world->warmStartCache->capacity) return 0;
+
+    world->gravityX = h.gravityX;
+    world->gravityY = h.gravityY;
+    world->velocityIterations = h.velocityIterations;
+    world->positionIterations = h.positionIterations;
+    world->enableWarmStarting = h.enableWarmStarting;
+    world->contactHertz = h.contactHertz;
+    world->contactDampingRatio = h.contactDampingRatio;
+    world->restitutionThreshold = h.restitutionThreshold;
+    world->maxLinearVelocity = h.maxLinearVelocity;
+    world->hitEventThreshold = h.hitEventThreshold;
+
+    world->activeCount = h.bodyCount;
+    memcpy(world->bodies, buffer + h.bodiesOffset, h.bodyCount * sizeof(NativeBody));
+    world->activeManifolds = h.manifoldCount;
+    if (h.manifoldCount) memcpy(world->manifolds, buffer + h.manifoldsOffset, h.manifoldCount * sizeof(ContactManifold));
+    world->activeConstraints = h.constraintCount;
+    if (h.constraintCount) memcpy(world->constraints, buffer + h.constraintsOffset, h.constraintCount * sizeof(ContactConstraint));
+    world->activeBoxJoints = h.jointCount;
+    if (h.jointCount) memcpy(world->boxJoints, buffer + h.jointsOffset, h.jointCount * sizeof(Joint));
+
+    // Soft bodies: reuse the existing arrays when the topology matches
+    uint32_t dataOffset = h.softBodyDataOffset;
+    for (int i = 0; i < h.softBodyCount; ++i) {
+        NativeSoftBody saved;
+        memcpy(&saved, buffer + h.softBodiesOffset + i * sizeof(NativeSoftBody), sizeof(NativeSoftBody));
+
+        NativeSoftBody& sb = world->softBodies[i];
+        if (i >= world->activeSoftBodies) {
+            sb.points = NULL;
+            sb.constraints = NULL;
+        }
+        resize_soft_body(sb, saved.pointCount, saved.constraintCount);
+        saved.points = sb.points;
+        saved.constraints = sb.constraints;
+        sb = saved;
+
+        uint32_t pointBytes = sb.pointCount * sizeof(SoftBodyPoint);
+        uint32_t constraintBytes = sb.constraintCount * sizeof(SoftBodyConstraint);
+        memcpy(sb.points, buffer + dataOffset, pointBytes);
+        memcpy(sb.constraints, buffer + dataOffset + pointBytes, constraintBytes);
+        dataOffset = align8(dataOffset + pointBytes + constraintBytes);
+    }
+    // Soft bodies created after the snapshot
+    for (int i = h.softBodyCount; i < world->activeSoftBodies; ++i) {
+        free(world->softBodies[i].points);
+        free(world->softBodies[i].constraints);
+        memset(&world->softBodies[i], 0, sizeof(NativeSoftBody));
+    }
+    world->activeSoftBodies = h.softBodyCount;
+
+    // Broadphase tree (index-linked, so the node array is copied verbatim)
+    DynamicTree* tree = world->tree;
+    if (tree && h.treeNodeCapacity > 0) {
+        if (tree->nodeCapacity != h.treeNodeCapacity) {
+            delete[] tree->nodes;
+            tree->nodes = new TreeNode[h.treeNodeCapacity];
+            tree->nodeCapacity = h.treeNodeCapacity;
+        }
+        memcpy(tree->nodes, buffer + h.treeNodesOffset, h.treeNodeCapacity * sizeof(TreeNode));
+        tree->root = h.treeRoot;
+        tree->nodeCount = h.treeNodeCount;
+        tree->freeList = h.treeFreeList;
+    }
+
+    if (world->warmStartCache) {
+        world->warmStartCache->count = h.warmStartCount;
+        if (h.warmStartCount) memcpy(world->warmStartCache->entries, buffer + h.warmStartOffset, h.warmStartCount * sizeof(WarmStartEntry));
+    }
+
+    if (world->contactTracker) {
+        restore_keys(world->contactTracker->previousContacts, buffer + h.contactKeysOffset, h.contactKeyCount);
+        restore_keys(world->contactTracker->previousSensors, buffer + h.sensorKeysOffset, h.sensorKeyCount);
+    }
+
+    return 1;
+}
+
+// Delta layout: DeltaHeader, then runs of { uint32 skipWords, uint32 copyWords, copyWords * uint32 }
+int snapshot_delta(const uint8_t* base, int baseSize, const uint8_t* current, int currentSize,
+                   uint8_t* outDelta, int outCapacity) {
+    if (!current || !outDelta || currentSize < 0 || (currentSize & 3)) return 0;
+    if (!base) baseSize = 0;
+    if (outCapacity < (int)sizeof(DeltaHeader)) return 0;
+
+    DeltaHeader dh = { kDeltaMagic, (uint32_t)currentSize };
+    memcpy(outDelta, &dh, sizeof(dh));
+    uint32_t out = sizeof(DeltaHeader);
+
+    const uint32_t wordCount = (uint32_t)currentSize / 4;
+    uint32_t i = 0;
+    while (i < wordCount) {
+        uint32_t skipStart = i;
+        while (i < wordCount && load_word(current, currentSize, i) == load_word(base, baseSize, i)) ++i;
+        if (i == wordCount) break;
+
+        // Changed run ends at two consecutive equal words (a single equal word is cheaper to copy)
+        uint32_t copyStart = i;
+        while (i < wordCount) {
+            if (load_word(current, currentSize, i) == load_word(base, baseSize, i) &&
+                (i + 1 == wordCount || load_word(current, currentSize, i + 1) == load_word(base, baseSize, i + 1))) break;
+            ++i;
+        }
+
+        uint32_t run[2] = { copyStart - skipStart, i - copyStart };
+        uint32_t runBytes = sizeof(run) + run[1] * 4;
+        if (out + runBytes > (uint32_t)outCapacity) return 0;
+        memcpy(outDelta + out, run, sizeof(run));
+        memcpy(outDelta + out + sizeof(run), current + copyStart * 4, run[1] * 4);
+        out += runBytes;
+    }
+    return (int)out;
+}
+
+int apply_snapshot_delta(const uint8_t* base, int baseSize, const uint8_t* delta, int deltaSize,
+                         uint8_t* outSnapshot, int outCapacity) {
+    if (!delta || !outSnapshot || deltaSize < (int)sizeof(DeltaHeader)) return 0;
+    if (!base) baseSize = 0;
+
+    DeltaHeader dh;
+    memcpy(&dh, delta, sizeof(dh));
+    if (dh.magic != kDeltaMagic || dh.size > (uint32_t)outCapacity || (dh.size & 3)) return 0;
+
+    // Start from the base (zero extended) and patch the changed runs
+    uint32_t copyBytes = (uint32_t)baseSize < dh.size ? (uint32_t)baseSize & ~3u : dh.size;
+    if (copyBytes && outSnapshot != base) memmove(outSnapshot, base, copyBytes);
+    memset(outSnapshot + copyBytes, 0, dh.size - copyBytes);
+
+    const uint32_t wordCount = dh.size / 4;
+    uint32_t in = sizeof(DeltaHeader);
+    uint32_t word = 0;
+    while (in + 8 <= (uint32_t)deltaSize) {
+        uint32_t run[2];
+        memcpy(run, delta + in, sizeof(run));
+        in += sizeof(run);
+        word += run[0];
+        if (word + run[1] > wordCount || in + run[1] * 4 > (uint32_t)deltaSize) return 0;
+        memcpy(outSnapshot + word * 4, delta + in, run[1] * 4);
+        in += run[1] * 4;
+        word += run[1];
+    }
+    return (int)dh.size;
+}
+
+}
@@ -0,0 +1,45 @@
+#ifndef FLASH_SNAPSHOT_H
+#define FLASH_SNAPSHOT_H
+
+#include <stdint.h>
+
+extern "C" {
+
+// World snapshots for rollback netcode.
+//
+// A snapshot is a single flat block: a header with section offsets followed by the
+// raw body, manifold, constraint, joint, soft body, broadphase tree, warm starting
+// and contact tracking arrays. It contains no pointers, so it can be copied, sent
+// over the network or stored in a ring of frames as-is.
+// Saving and restoring are a handful of memcpy calls. Restoring only allocates if
+// the broadphase tree or a soft body changed capacity since the snapshot was taken.
+//
+// A snapshot can only be restored into the world it was taken from (or a world
+// created with the same maxBodies). The contact event buffer is not part of the
+// snapshot: events already delivered stay delivered.
+
+// Bytes needed to snapshot the world in its current state
+int get_snapshot_size(struct PhysicsWorld* world);
+
+// Write a snapshot into buffer. Returns the number of bytes written, or 0 if
+// capacity is smaller than get_snapshot_size().
+int snapshot_world(struct PhysicsWorld* world, uint8_t* buffer, int capacity);
+
+// Restore the world from a snapshot. Returns 1 on success, 0 if the buffer is not
+// a valid snapshot for this world.
+int restore_world(struct PhysicsWorld* world, const uint8_t* buffer, int size);
+
+// Delta snapshots: encode current against a base snapshot (e.g. the last acknowledged
+// frame). Unchanged 32-bit words are skipped, changed runs are stored verbatim.
+// Returns the delta size in bytes, or 0 if outCapacity is too small.
+int snapshot_delta(const uint8_t* base, int baseSize, const uint8_t* current, int currentSize,
+                   uint8_t* outDelta, int outCapacity);
+
+// Rebuild a full snapshot from base + delta. Returns the snapshot size in bytes,
+// or 0 if the delta is invalid or outCapacity is too small.
+int apply_snapshot_delta(const uint8_t* base, int baseSize, const uint8_t* delta, int deltaSize,
+                         uint8_t* outSnapshot, int outCapacity);
+
+}
+
+#endif
@@ -1,8 +1,27 @@
 #include <iostream>
 #include <cassert>
 #include <vector>
+#include <cmath>
 #include "physics.h"
 #include "joints.h"
+#include "queries.h"
+#include "character.h"
+#include "events.h"
+#include "snapshot.h"
+#include "flash_math.h"
+#include "jobs.h"
+#include "trace.h"
+#include "physics_async.h"
+#include "world_group.h"
+#include "particles.h"
+#include "particles_async.h"
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <string>
 
 // Simple assertion helper
 void assert_true(bool condition, const char* message) {
@@ -20,7 +39,7 @@ void test_gravity() {
     PhysicsWorld* world = create_physics_world(10);
     
     // Create a dynamic body
-    int bodyId = create_body(world, DYNAMIC, SHAPE_CIRCLE, 0, 0, 10, 10, 0);
+    int bodyId = create_body(world, DYNAMIC, SHAPE_CIRCLE, 0, 0, 10, 10, 0, 0x0001, 0xFFFF);
     NativeBody* body = &world->bodies[bodyId];
     
     // Verify initial state
@@ -44,10 +63,10 @@ void test_collision() {
     PhysicsWorld* world = create_physics_world(10);
     
     // Ground (Static) at Y= -100
-    create_body(world, STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0);
+    create_body(world, STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0, 0x0001, 0xFFFF);
     
     // Ball (Dynamic) at Y= 0 (falling down to -100)
-    int ballId = create_body(world, DYNAMIC, SHAPE_CIRCLE, 0, 0, 10, 10, 0);
+    int ballId = create_body(world, DYNAMIC, SHAPE_CIRCLE, 0, 0, 10, 10, 0, 0x0001, 0xFFFF);
     
     // Step for 2 seconds
     for(int i=0; i<120; ++i) {
@@ -65,10 +84,1251 @@ void test_collision() {
     destroy_physics_world(world);
 }
 
+// Test 3: Spatial Queries
+void test_queries() {
+    std::cout << "\n--- Testing Spatial Queries ---" << std::endl;
+    PhysicsWorld* world = create_physics_world(10);
+    
+    int ground = create_body(world, STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0, 0x0001, 0xFFFF);
+    int ball = create_body(world, DYNAMIC, SHAPE_CIRCLE, 0, 0, 10, 10, 0, 0x0002, 0xFFFF);
+    
+    int32_t ids[8];
+    int count = query_point(world, 0, 0, 0xFFFF, 0xFFFF, ids, 8);
+    assert_true(count == 1 && ids[0] == ball, "Point query picks the ball");
+    
+    count = query_aabb(world, -600, -120, 600, -95, 0xFFFF, 0xFFFF, ids, 8);
+    assert_true(count == 1 && ids[0] == ground, "AABB query finds the ground only");
+    
+    count = overlap_shape(world, SHAPE_CIRCLE, 0, -50, 100, 100, 0, 0xFFFF, 0x0002, ids, 8);
+    assert_true(count == 1 && ids[0] == ball, "Circle overlap respects mask bits");
+    
+    float points[4] = { 0, 0, 300, 300 };
+    int32_t counts[2];
+    count = query_point_batch(world, points, 2, 0xFFFF, 0xFFFF, ids, 8, counts);
+    assert_true(count == 1 && counts[0] == 1 && counts[1] == 0, "Batched point query");
+    
+    destroy_physics_world(world);
+}
+
+// Test 4: Shape Cast & Character Controller
+void test_shape_cast() {
+    std::cout << "\n--- Testing Shape Cast ---" << std::endl;
+    PhysicsWorld* world = create_physics_world(10);
+    
+    // Ground top surface at Y = -90
+    create_body(world, STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0, 0x0001, 0xFFFF);
+    
+    // Circle of radius 5 dropped from Y = 0 by 200: touches at Y = -85
+    ShapeCastHit hit = shape_cast(world, SHAPE_CIRCLE, 10, 10, 0, 0, 0, 0, -200, 0xFFFF, 0xFFFF, -1);
+    std::cout << "Circle cast fraction: " << hit.fraction << std::endl;
+    assert_true(hit.hit && std::abs(hit.fraction * 200.0f - 85.0f) < 0.5f, "Circle cast stops on the ground");
+    assert_true(hit.normalY > 0.99f, "Ground normal points up");
+    
+    // Box of half height 10 touches at Y = -80
+    hit = shape_cast(world, SHAPE_BOX, 20, 20, 0, 0, 0, 0, -200, 0xFFFF, 0xFFFF, -1);
+    assert_true(hit.hit && std::abs(hit.fraction * 200.0f - 80.0f) < 0.5f, "Box cast stops on the ground");
+    
+    hit = shape_cast(world, SHAPE_CIRCLE, 10, 10, 0, 0, 0, 200, 0, 0xFFFF, 0xFFFF, -1);
+    assert_true(!hit.hit, "Horizontal cast above the ground misses");
+    
+    // Character falls onto the ground and slides along it
+    CharacterController cc;
+    init_character_controller(&cc, SHAPE_CIRCLE, 10, 10, 0, 0);
+    character_move(world, &cc, 100, -200);
+    std::cout << "Character at: " << cc.x << ", " << cc.y << std::endl;
+    assert_true(cc.onGround == 1, "Character lands on the ground");
+    assert_true(cc.y > -86.0f && cc.y < -84.0f, "Character rests on the surface");
+    assert_true(cc.x > 50.0f, "Character slides along the ground");
+    
+    destroy_physics_world(world);
+}
+
+void test_contact_events() {
+    std::cout << "\n--- Testing Contact Events ---" << std::endl;
+    PhysicsWorld* world = create_physics_world(10);
+    
+    create_body(world, STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0, 0x0001, 0xFFFF);
+    int32_t sensor = create_body(world, STATIC, SHAPE_BOX, 0, 0, 40, 40, 0, 0x0001, 0xFFFF);
+    set_body_sensor(world, sensor, 1);
+    int32_t ball = create_body(world, DYNAMIC, SHAPE_CIRCLE, 0, 100, 10, 10, 0, 0x0001, 0xFFFF);
+    
+    int counts[5] = {0, 0, 0, 0, 0};
+    ContactEventBuffer* events = get_contact_events(world);
+    for (int i = 0; i < 240; ++i) {
+        step_physics(world, 1.0f / 120.0f);
+        for (uint32_t e = events->readIndex; e != events->writeIndex; ++e) {
+            const ContactEvent& ev = events->events[e % events->capacity];
+            counts[ev.type]++;
+            if (ev.type == SENSOR_BEGIN || ev.type == SENSOR_END) {
+                assert_true(ev.bodyA == sensor && ev.bodyB == ball, "Sensor reported as bodyA");
+            }
+        }
+        events->readIndex = events->writeIndex;
+    }
+    std::cout << "Begin: " << counts[CONTACT_BEGIN] << " Hit: " << counts[CONTACT_HIT]
+              << " Sensor begin/end: " << counts[SENSOR_BEGIN] << "/" << counts[SENSOR_END] << std::endl;
+    
+    // The ball bounces back into the sensor, but each entry is paired with an exit
+    assert_true(counts[SENSOR_BEGIN] >= 1 && counts[SENSOR_BEGIN] == counts[SENSOR_END], "Ball passes through the sensor");
+    assert_true(world->bodies[ball].y < -80.0f, "Sensor does not block the ball");
+    assert_true(counts[CONTACT_BEGIN] >= 1, "Ball touches the ground");
+    assert_true(counts[CONTACT_HIT] >= 1, "Landing is a hit event");
+    assert_true(events->droppedCount == 0, "No events dropped");
+
+    destroy_physics_world(world);
+
+    // Constraint buffer full: contacts past the cap stay tracked, no END/BEGIN churn
+    world = create_physics_world(10);
+    world->gravityY = 0.0f;
+    create_body(world, STATIC, SHAPE_BOX, 0, 0, 1000, 20, 0, 0x0001, 0xFFFF);
+    for (int i = 0; i < 3; ++i) { // Immovable overlaps, so only the cap can end a contact
+        int32_t box = create_body(world, DYNAMIC, SHAPE_BOX, -200.0f + i * 200.0f, 15.0f, 20, 20, 0, 0x0001, 0xFFFF);
+        world->bodies[box].inverseMass = world->bodies[box].inverseInertia = 0.0f;
+    }
+    world->maxConstraints = 1;
+    events = get_contact_events(world);
+    int begins = 0, ends = 0;
+    for (int i = 0; i < 30; ++i) {
+        step_physics(world, 1.0f / 120.0f);
+        for (uint32_t e = events->readIndex; e != events->writeIndex; ++e) {
+            const ContactEvent& ev = events->events[e % events->capacity];
+            if (ev.type == CONTACT_BEGIN) begins++;
+            if (ev.type == CONTACT_END) ends++;
+        }
+        events->readIndex = events->writeIndex;
+    }
+    std::cout << "Capped begins/ends: " << begins << "/" << ends << std::endl;
+    assert_true(begins == 3 && ends == 0, "Contacts past the constraint cap keep their events");
+    destroy_physics_world(world);
+
+    // Full ring: the producer keeps the unread events and drops the new one
+    ContactEventBuffer* ring = create_contact_event_buffer(4);
+    ContactEvent ev;
+    memset(&ev, 0, sizeof(ev));
+    for (int i = 0; i < 6; ++i) {
+        ev.bodyA = i;
+        push_contact_event(ring, ev);
+    }
+    assert_true(ring->readIndex == 0 && ring->writeIndex == 4, "Producer never advances readIndex");
+    assert_true(ring->droppedCount == 2, "Overflowing events are counted");
+    assert_true(ring->events[0].bodyA == 0 && ring->events[3].bodyA == 3, "Unread events are kept");
+    destroy_contact_event_buffer(ring);
+}
+
+void test_snapshot() {
+    std::cout << "\n--- Testing Snapshot / Restore ---" << std::endl;
+    PhysicsWorld* world = create_physics_world(32);
+    
+    create_body(world, STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0, 0x0001, 0xFFFF);
+    for (int i = 0; i < 10; ++i) {
+        create_body(world, DYNAMIC, (i % 2) ? SHAPE_BOX : SHAPE_CIRCLE, (i % 3) * 15.0f, i * 25.0f, 20, 20, 0.1f * i, 0x0001, 0xFFFF);
+    }
+    for (int i = 0; i < 60; ++i) step_physics(world, 1.0f / 120.0f);
+    
+    std::vector<uint8_t> base(get_snapshot_size(world));
+    assert_true(snapshot_world(world, &base[0], (int)base.size()) == (int)base.size(), "Snapshot written");
+    
+    for (int i = 0; i < 60; ++i) step_physics(world, 1.0f / 120.0f);
+    std::vector<NativeBody> expected(world->bodies, world->bodies + world->activeCount);
+    std::vector<uint8_t> current(get_snapshot_size(world));
+    snapshot_world(world, &current[0], (int)current.size());
+    
+    // Rollback and re-simulate: must be bit-identical
+    assert_true(restore_world(world, &base[0], (int)base.size()) == 1, "Restore succeeded");
+    for (int i = 0; i < 60; ++i) step_physics(world, 1.0f / 120.0f);
+    bool identical = true;
+    for (int i = 0; i < world->activeCount; ++i) {
+        if (world->bodies[i].x != expected[i].x || world->bodies[i].y != expected[i].y ||
+            world->bodies[i].rotation != expected[i].rotation) identical = false;
+    }
+    assert_true(identical, "Re-simulation after restore is identical");
+    
+    // Delta against the base rebuilds the later snapshot
+    std::vector<uint8_t> delta(current.size() * 2 + 64);
+    int deltaSize = snapshot_delta(&base[0], (int)base.size(), &current[0], (int)current.size(), &delta[0], (int)delta.size());
+    std::vector<uint8_t> rebuilt(current.size());
+    int rebuiltSize = apply_snapshot_delta(&base[0], (int)base.size(), &delta[0], deltaSize, &rebuilt[0], (int)rebuilt.size());
+    std::cout << "Snapshot: " << current.size() << " bytes, delta: " << deltaSize << " bytes" << std::endl;
+    assert_true(rebuiltSize == (int)current.size() && rebuilt == current, "Delta round trip");
+    
+    destroy_physics_world(world);
+}
+
+void test_determinism() {
+    std::cout << "\n--- Testing Determinism (deterministic build: " << is_physics_deterministic() << ") ---" << std::endl;
+    
+    float maxError = 0.0f;
+    for (float x = -20.0f; x <= 20.0f; x += 0.001f) {
+        maxError = std::max(maxError, std::abs(flash_sin(x) - std::sin(x)));
+        maxError = std::max(maxError, std::abs(flash_cos(x) - std::cos(x)));
+    }
+    std::cout << "Max trig error: " << maxError << std::endl;
+    assert_true(maxError < 1e-5f, "Trig approximation is accurate");
+    
+    uint64_t hashes[2];
+    for (int run = 0; run < 2; ++run) {
+        PhysicsWorld* world = create_physics_world(32);
+        create_body(world, STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0, 0x0001, 0xFFFF);
+        for (int i = 0; i < 12; ++i) {
+            create_body(world, DYNAMIC, (i % 2) ? SHAPE_BOX : SHAPE_CIRCLE, (i % 4) * 12.0f, i * 22.0f, 20, 20, 0.3f * i, 0x0001, 0xFFFF);
+        }
+        for (int i = 0; i < 120; ++i) step_physics(world, 1.0f / 120.0f);
+        hashes[run] = hash_world_state(world);
+        
+        step_physics(world, 1.0f / 120.0f);
+        assert_true(hash_world_state(world) != hashes[run], "Hash changes when the state changes");
+        destroy_physics_world(world);
+    }
+    assert_true(hashes[0] == hashes[1], "Identical inputs give identical state hashes");
+}
+
+void test_profile() {
+    std::cout << "\n--- Testing Step Profile ---" << std::endl;
+    PhysicsWorld* world = create_physics_world(64);
+    assert_true(get_physics_profile(world) == NULL, "Profiling is off by default");
+    
+    create_body(world, STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0, 0x0001, 0xFFFF);
+    for (int i = 0; i < 20; ++i) {
+        create_body(world, DYNAMIC, SHAPE_BOX, (i % 5) * 22.0f, -80.0f + (i / 5) * 21.0f, 20, 20, 0, 0x0001, 0xFFFF);
+    }
+    enable_physics_profile(world, 1);
+    for (int i = 0; i < 30; ++i) step_physics(world, 1.0f / 120.0f);
+    
+    const PhysicsProfile* p = get_physics_profile(world);
+    std::cout << "Total: " << p->total << " ms, pairs: " << p->pairCount << ", constraints: " << p->constraintCount
+              << ", awake: " << p->awakeBodyCount << ", tree height: " << p->treeHeight << std::endl;
+    float phases = p->softBodies + p->broadphase + p->pairs + p->narrowphase + p->warmStart +
+                   p->velocitySolve + p->integrate + p->positionSolve;
+    assert_true(p->total > 0.0f && phases <= p->total * 1.01f, "Phase timings add up to the total");
+    assert_true(p->pairCount > 0 && p->constraintCount > 0, "Pair and constraint counters filled");
+    assert_true(p->awakeBodyCount == 20 && p->treeHeight > 0, "Awake bodies and tree height filled");
+    
+    enable_physics_profile(world, 0);
+    assert_true(get_physics_profile(world) == NULL, "Profiling can be disabled");
+    destroy_physics_world(world);
+}
+
+void test_job_system() {
+    std::cout << "\n--- Testing Job System ---" << std::endl;
+    
+    std::vector<int> values(100000, 0);
+    set_job_thread_count(4);
+    assert_true(get_job_thread_count() == 4, "Thread count is configurable");
+    parallel_for((int)values.size(), 1000, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) values[i] += i;
+    });
+    bool allOnce = true;
+    for (int i = 0; i < (int)values.size(); ++i) allOnce = allOnce && values[i] == i;
+    assert_true(allOnce, "parallel_for visits every index exactly once");
+    
+    std::vector<int> nested(64 * 64, 0);
+    parallel_for(64, 1, [&](int begin, int end) {
+        for (int row = begin; row < end; ++row) {
+            parallel_for(64, 8, [&](int b, int e) {
+                for (int col = b; col < e; ++col) nested[row * 64 + col] = 1;
+            });
+        }
+    });
+    int nestedSum = 0;
+    for (size_t i = 0; i < nested.size(); ++i) nestedSum += nested[i];
+    assert_true(nestedSum == 64 * 64, "Nested parallel_for completes");
+    
+    // Parallel phases must not change the simulation
+    uint64_t hashes[2];
+    const int threadCounts[2] = {1, 4};
+    for (int run = 0; run < 2; ++run) {
+        set_job_thread_count(threadCounts[run]);
+        PhysicsWorld* world = create_physics_world(600);
+        create_body(world, STATIC, SHAPE_BOX, 0, -100, 2000, 20, 0, 0x0001, 0xFFFF);
+        for (int i = 0; i < 500; ++i) {
+            create_body(world, DYNAMIC, (i % 2) ? SHAPE_BOX : SHAPE_CIRCLE, (i % 25) * 22.0f - 275.0f, i / 25 * 22.0f, 20, 20, 0, 0x0001, 0xFFFF);
+        }
+        for (int i = 0; i < 60; ++i) step_physics(world, 1.0f / 120.0f);
+        hashes[run] = hash_world_state(world);
+        destroy_physics_world(world);
+    }
+    assert_true(hashes[0] == hashes[1], "1 and 4 job threads give identical physics state");
+    
+    // Resizing waits for batches running on other threads (like the physics thread)
+    std::vector<int> counts(20000, 0);
+    std::atomic<bool> stop(false);
+    int batches = 0;
+    std::thread background([&] {
+        while (!stop.load()) {
+            parallel_for((int)counts.size(), 500, [&](int begin, int end) {
+                for (int i = begin; i < end; ++i) counts[i]++;
+            });
+            ++batches;
+        }
+    });
+    for (int i = 0; i < 20; ++i) set_job_thread_count(i % 2 ? 2 : 4);
+    stop.store(true);
+    background.join();
+    bool allBatches = true;
+    for (size_t i = 0; i < counts.size(); ++i) allBatches = allBatches && counts[i] == batches;
+    assert_true(allBatches, "Thread count changes while another thread runs parallel_for");
+    set_job_thread_count(0);
+}
+
+#if defined(FLASH_ENABLE_TRACE)
+static int count_occurrences(const std::string& text, const std::string& token) {
+    int count = 0;
+    for (size_t at = text.find(token); at != std::string::npos; at = text.find(token, at + token.size())) count++;
+    return count;
+}
+
+void test_trace() {
+    std::cout << "\n--- Testing Trace Recording ---" << std::endl;
+    const char* path = "test_trace.json";
+    const int zonesPerThread = 500;
+    
+    // A stale zone from a previous session must not leak into the next one
+    trace_begin();
+    { FLASH_TRACE_ZONE("stale"); }
+    trace_begin();
+    
+    std::atomic<int> ready(0);
+    auto recorder = [&](const char* name) {
+        trace_set_thread_name(name);
+        ready++;
+        while (ready.load() < 2) std::this_thread::yield();
+        for (int i = 0; i < zonesPerThread; ++i) {
+            FLASH_TRACE_ZONE("zone");
+        }
+    };
+    std::thread a(recorder, "trace a");
+    std::thread b(recorder, "trace b");
+    a.join();
+    b.join();
+    trace_end();
+    
+    int written = trace_dump_json(path);
+    std::ifstream file(path);
+    std::stringstream json;
+    json << file.rdbuf();
+    std::string text = json.str();
+    remove(path);
+    
+    assert_true(written == 2 * zonesPerThread, "Dump writes every zone of both threads");
+    assert_true(count_occurrences(text, "\"ph\":\"X\"") == 2 * zonesPerThread, "One complete event per zone");
+    assert_true(text.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0 && text.rfind("]}\n") == text.size() - 3,
+                "Dump is one traceEvents array");
+    assert_true(count_occurrences(text, "\"trace a\"") == 1 && count_occurrences(text, "\"trace b\"") == 1,
+                "Both threads are named once");
+    assert_true(text.find("stale") == std::string::npos, "trace_begin discards the previous session");
+}
+#endif
+
+void test_async_step() {
+    std::cout << "\n--- Testing Async Stepping ---" << std::endl;
+    
+    PhysicsWorld* worlds[2];
+    for (int w = 0; w < 2; ++w) {
+        worlds[w] = create_physics_world(64);
+        create_body(worlds[w], STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0, 0x0001, 0xFFFF);
+        for (int i = 0; i < 20; ++i) {
+            create_body(worlds[w], DYNAMIC, (i % 2) ? SHAPE_BOX : SHAPE_CIRCLE, (i % 5) * 22.0f, i * 22.0f, 20, 20, 0, 0x0001, 0xFFFF);
+        }
+    }
+    assert_true(get_body_transforms(worlds[1]) == NULL, "No transform buffer before the first async step");
+    
+    for (int frame = 0; frame < 30; ++frame) {
+        step_physics(worlds[0], 1.0f / 120.0f);
+        step_physics(worlds[0], 1.0f / 120.0f);
+        step_physics_async(worlds[1], 1.0f / 120.0f, 2);
+        wait_physics(worlds[1]);
+    }
+    assert_true(is_physics_busy(worlds[1]) == 0, "Idle after wait_physics");
+    assert_true(hash_world_state(worlds[0]) == hash_world_state(worlds[1]), "Async steps match synchronous steps");
+    
+    const BodyTransformBuffer* transforms = get_body_transforms(worlds[1]);
+    assert_true(transforms && transforms->count == worlds[1]->activeCount, "Transform buffer holds every body");
+    assert_true(transforms->batchIndex == 31, "One published batch per call (plus the initial state)");
+    bool matches = true;
+    for (int i = 0; i < transforms->count; ++i) {
+        const NativeBody& b = worlds[1]->bodies[i];
+        matches = matches && transforms->transforms[i].x == b.x && transforms->transforms[i].y == b.y && transforms->transforms[i].rotation == b.rotation;
+    }
+    assert_true(matches, "Front buffer matches the last completed state");
+    
+    // Profile calls wait for a batch in flight instead of racing it
+    enable_physics_profile(worlds[1], 1);
+    step_physics_async(worlds[1], 1.0f / 120.0f, 4);
+    const PhysicsProfile* profile = get_physics_profile(worlds[1]);
+    assert_true(is_physics_busy(worlds[1]) == 0 && profile && profile->total > 0 && profile->awakeBodyCount > 0,
+                "get_physics_profile returns the finished batch's profile");
+    step_physics_async(worlds[1], 1.0f / 120.0f, 4);
+    enable_physics_profile(worlds[1], 0);
+    assert_true(is_physics_busy(worlds[1]) == 0 && get_physics_profile(worlds[1]) == NULL,
+                "Disabling the profile waits for the batch before freeing it");
+    
+    // Destroying a world with a batch in flight waits for it. The teardown
+    // itself has nothing left to observe; this part is checked by running
+    // the tests clean under TSan/ASan.
+    step_physics_async(worlds[1], 1.0f / 120.0f, 8);
+    destroy_physics_world(worlds[1]);
+    destroy_physics_world(worlds[0]);
+}
+
+void test_world_group() {
+    std::cout << "\n--- Testing World Group ---" << std::endl;
+    
+    const int worldCount = 12;
+    PhysicsWorld* grouped[worldCount];
+    PhysicsWorld* single[worldCount];
+    WorldGroup* group = create_world_group(worldCount);
+    set_job_thread_count(4);
+    
+    for (int w = 0; w < worldCount; ++w) {
+        PhysicsWorld* pair[2] = {create_physics_world(32), create_physics_world(32)};
+        for (int k = 0; k < 2; ++k) {
+            create_body(pair[k], STATIC, SHAPE_BOX, 0, -100, 1000, 20, 0, 0x0001, 0xFFFF);
+            for (int i = 0; i < 10; ++i) {
+                create_body(pair[k], DYNAMIC, (i + w) % 2 ? SHAPE_BOX : SHAPE_CIRCLE, (i % 3) * 22.0f + w, i * 22.0f, 20, 20, 0, 0x0001, 0xFFFF);
+            }
+        }
+        grouped[w] = pair[0];
+        single[w] = pair[1];
+        assert_true(world_group_add(group, grouped[w]) == w, "World added to group");
+    }
+    assert_true(world_group_add(group, single[0]) == -1, "Full group rejects worlds");
+    
+    for (int frame = 0; frame < 40; ++frame) {
+        step_world_group(group, 1.0f / 120.0f, 2);
+        for (int w = 0; w < worldCount; ++w) {
+            step_physics(single[w], 1.0f / 120.0f);
+            step_physics(single[w], 1.0f / 120.0f);
+        }
+    }
+    bool identical = true;
+    for (int w = 0; w < worldCount; ++w) identical = identical && hash_world_state(grouped[w]) == hash_world_state(single[w]);
+    assert_true(identical, "Group stepping matches stepping each world alone");
+
+    // A member with an asynchronous batch in flight finishes it before the group steps it
+    step_physics_async(grouped[1], 1.0f / 120.0f, 3);
+    step_world_group(group, 1.0f / 120.0f, 1);
+    for (int s = 0; s < 4; ++s) step_physics(single[1], 1.0f / 120.0f);
+    for (int w = 2; w < worldCount; ++w) step_physics(single[w], 1.0f / 120.0f);
+    identical = true;
+    for (int w = 1; w < worldCount; ++w) identical = identical && hash_world_state(grouped[w]) == hash_world_state(single[w]);
+    assert_true(identical, "Group waits for a member's asynchronous batch");
+    
+    world_group_remove(group, grouped[0]);
+    assert_true(group->count == worldCount - 1 && group->worlds[0] == grouped[worldCount - 1], "Removed world is replaced by the last one");
+    
+    destroy_world_group(group);
+    for (int w = 0; w < worldCount; ++w) {
+        destroy_physics_world(grouped[w]);
+        destroy_physics_world(single[w]);
+    }
+    set_job_thread_count(0);
+}
+
+void test_particle_streams() {
+    std::cout << "\n--- Testing Particle Streams ---" << std::endl;
+    
+    // Same particles in a Dart-style AoS emitter and a native SoA emitter.
+    // dt and lifetimes are powers of two, so both layouts expire on the same frame.
+    const int count = 1003; // Not a multiple of 8: exercises the padded tail
+    ParticleEmitter* aos = (ParticleEmitter*)calloc(1, sizeof(ParticleEmitter));
+    aos->particles = (NativeParticle*)calloc(count, sizeof(NativeParticle));
+    aos->maxParticles = count;
+    ParticleEmitter* soa = create_particle_emitter(count, 0);
+    assert_true(soa && soa->streams && soa->streams->capacity == 1008, "SoA streams padded to whole batches");
+    assert_true(((uintptr_t)soa->streams->vx & 31) == 0 && ((uintptr_t)soa->streams->color & 31) == 0, "Streams are 32-byte aligned");
+    
+    ParticleEmitter* emitters[2] = {aos, soa};
+    for (int e = 0; e < 2; ++e) {
+        emitters[e]->gravityY = -981.0f;
+        for (int i = 0; i < count; ++i) {
+            float maxLife = (i % 3 == 0) ? 0.25f : (i % 3 == 1) ? 0.5f : 4.0f;
+            spawn_particle(emitters[e], (float)i, 0, 1.0f, (float)(i % 7), 100.0f, 0, maxLife, 2.0f, 0xFF00FF00u + i);
+        }
+    }
+    
+    const float dt = 1.0f / 64.0f;
+    for (int frame = 0; frame < 24; ++frame) {
+        update_particles(aos, dt);
+        update_particles(soa, dt);
+    }
+    // Only the 0.25 s particles (every third) have expired after 24 frames
+    assert_true(soa->activeCount == aos->activeCount && soa->activeCount == count - (count + 2) / 3, "SoA and AoS expire the same particles");
+    
+    // Compaction keeps spawn order, so colors stay sorted
+    bool ordered = true;
+    for (int i = 1; i < soa->activeCount; ++i) ordered = ordered && soa->streams->color[i] > soa->streams->color[i - 1];
+    assert_true(ordered, "Compaction keeps surviving particles in order");
+    
+    std::vector<float> aosY, soaY;
+    for (int i = 0; i < aos->activeCount; ++i) aosY.push_back(aos->particles[i].x * 1000.0f + aos->particles[i].y);
+    for (int i = 0; i < soa->activeCount; ++i) soaY.push_back(soa->streams->x[i] * 1000.0f + soa->streams->y[i]);
+    std::sort(aosY.begin(), aosY.end());
+    std::sort(soaY.begin(), soaY.end());
+    bool same = true;
+    for (size_t i = 0; i < aosY.size(); ++i) same = same && fabsf(aosY[i] - soaY[i]) < 1e-3f;
+    assert_true(same, "SoA integration matches AoS");
+    
+    float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    std::vector<float> vertices(count * 12);
+    std::vector<uint32_t> colors(count * 6);
+    int visible = fill_vertex_buffer(soa, identity, vertices.data(), colors.data(), count);
+    assert_true(visible == soa->activeCount, "SoA emitters render through fill_vertex_buffer");
+    
+    free(aos->particles);
+    free(aos);
+    destroy_particle_emitter(soa);
+}
+
+void test_particle_polygons() {
+    std::cout << "\n--- Testing Particle Polygon Tables ---" << std::endl;
+    
+    // Every shape against vertices generated with per-vertex trig
+    const int shapeSides[5] = {4, 6, 8, 12, 3};
+    float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    bool allMatch = true;
+    for (int shape = 0; shape < 5; ++shape) {
+        int sides = shapeSides[shape];
+        int vCount = (sides - 2) * 3;
+        ParticleEmitter* emitter = create_particle_emitter(16, shape);
+        for (int i = 0; i < 5; ++i) spawn_particle(emitter, 100.0f * i, 50.0f, 0, 0, 0, 0, 1.0f, 0.01f * (i + 1), 0xFF123456u);
+        
+        std::vector<float> vertices(5 * vCount * 2);
+        std::vector<uint32_t> colors(5 * vCount);
+        int visible = fill_vertex_buffer(emitter, identity, vertices.data(), colors.data(), 16);
+        allMatch = allMatch && visible == 5;
+        
+        for (int p = 0; p < visible; ++p) {
+            float cx = 100.0f * p, cy = 50.0f;
+            float halfSize = 0.01f * (p + 1) * 500.0f;
+            int k = p * vCount * 2;
+            for (int t = 1; t < sides - 1; ++t) {
+                int fan[3] = {0, t, t + 1};
+                for (int v = 0; v < 3; ++v) {
+                    float angle = fan[v] * (2.0f * M_PI / sides);
+                    allMatch = allMatch && fabsf(vertices[k++] - (cx + cosf(angle) * halfSize)) < 1e-3f;
+                    allMatch = allMatch && fabsf(vertices[k++] - (cy + sinf(angle) * halfSize)) < 1e-3f;
+                }
+            }
+            allMatch = allMatch && colors[p * vCount + vCount - 1] == 0xFF123456u;
+        }
+        destroy_particle_emitter(emitter);
+    }
+    assert_true(allMatch, "Table-driven polygons match per-vertex trig for every shape");
+}
+
+void test_particle_indices() {
+    std::cout << "\n--- Testing Indexed Particle Output ---" << std::endl;
+    
+    float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    ParticleEmitter* emitter = create_particle_emitter(64, 3);
+    for (int i = 0; i < 40; ++i) spawn_particle(emitter, 10.0f * i, 5.0f * i, 0, 0, 0, 0, 1.0f, 0.02f, 0xFF00FFFFu);
+    
+    int sides = particle_shape_sides(3);
+    assert_true(sides == 12, "Round particles have 12 corners");
+    std::vector<float> fan(40 * 30 * 2), corners(40 * sides * 2);
+    std::vector<uint32_t> fanColors(40 * 30), cornerColors(40 * sides);
+    int fanCount = fill_vertex_buffer(emitter, identity, fan.data(), fanColors.data(), 64);
+    int cornerCount = fill_vertex_buffer_indexed(emitter, identity, corners.data(), cornerColors.data(), 64);
+    assert_true(fanCount == 40 && cornerCount == 40, "Indexed fill renders every particle");
+    
+    // Indexing the corners must reproduce the fan vertices exactly
+    std::vector<uint16_t> indices(40 * 30);
+    int indexCount = build_particle_indices(3, 40, indices.data());
+    assert_true(indexCount == 40 * 30, "Index pattern has (sides - 2) * 3 indices per particle");
+    bool same = true;
+    for (int i = 0; i < indexCount; ++i) {
+        same = same && corners[indices[i] * 2] == fan[i * 2] && corners[indices[i] * 2 + 1] == fan[i * 2 + 1];
+        same = same && cornerColors[indices[i]] == fanColors[i];
+    }
+    assert_true(same, "Indexed corners match the expanded triangle fans");
+    assert_true(build_particle_indices(3, 65536 / 12 + 1, indices.data()) == 0, "Batches beyond 16-bit indices are rejected");
+    
+    destroy_particle_emitter(emitter);
+}
+
+void test_particle_culling() {
+    std::cout << "\n--- Testing Particle Culling ---" << std::endl;
+    
+    // 20x20 grid 100 units apart; identity camera, so world units are pixels
+    float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    ParticleEmitter* emitter = create_particle_emitter(400, 0);
+    for (int i = 0; i < 400; ++i) spawn_particle(emitter, (i % 20) * 100.0f, (i / 20) * 100.0f, 0, 0, 0, 0, 1.0f, 0.02f, 0xFFFFFFFFu);
+    std::vector<float> vertices(400 * 12);
+    std::vector<uint32_t> colors(400 * 6);
+    
+    assert_true(fill_vertex_buffer(emitter, identity, vertices.data(), colors.data(), 400) == 400, "No viewport: only behind-camera culling");
+    
+    // 1000x1000 screen: columns/rows 0..9 inside, plus 10 (x = 1000) on the edge.
+    // Discs have a half size of 10, so x = 1005 would still touch; x = 1100 doesn't.
+    emitter->viewMinX = 0; emitter->viewMinY = 0;
+    emitter->viewMaxX = 1000; emitter->viewMaxY = 1000;
+    int visible = fill_vertex_buffer(emitter, identity, vertices.data(), colors.data(), 400);
+    assert_true(visible == 11 * 11, "Particles outside the viewport are culled");
+    int indexed = fill_vertex_buffer_indexed(emitter, identity, vertices.data(), colors.data(), 400);
+    assert_true(indexed == visible, "Indexed fill uses the same culling");
+    
+    // Discs just off the left edge but overlapping it are kept
+    emitter->viewMinX = 1005; emitter->viewMaxX = 2000;
+    assert_true(fill_vertex_buffer(emitter, identity, vertices.data(), colors.data(), 400) == 10 * 11, "Partially visible discs are kept");
+    
+    emitter->viewMaxX = emitter->viewMinX = 0;
+    emitter->minScreenSize = 20.0f;
+    assert_true(fill_vertex_buffer(emitter, identity, vertices.data(), colors.data(), 400) == 0, "Sub-size particles are culled");
+    
+    destroy_particle_emitter(emitter);
+}
+
+void test_particle_depth_sort() {
+    std::cout << "\n--- Testing Particle Depth Sort ---" << std::endl;
+    
+    // Identity camera: NDC depth is z. Colors carry the spawn index.
+    const int count = 150000; // Several sort tasks and fill chunks
+    float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    ParticleEmitter* emitter = create_particle_emitter(count, 0);
+    std::vector<float> depth(count);
+    uint32_t seed = 12345;
+    for (int i = 0; i < count; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        // Coarse depths (many ties) on both sides of zero
+        depth[i] = (float)((int)(seed >> 20) - 2048) / 256.0f;
+        spawn_particle(emitter, 0, 0, depth[i], 0, 0, 0, 1.0f, 0.01f, (uint32_t)i);
+    }
+    emitter->sortMode = 1;
+    
+    std::vector<float> vertices((size_t)count * 12);
+    std::vector<uint32_t> colors((size_t)count * 6);
+    set_job_thread_count(4);
+    int visible = fill_vertex_buffer(emitter, identity, vertices.data(), colors.data(), count);
+    assert_true(visible == count, "Sorted fill renders every particle");
+    
+    bool backToFront = true, stable = true;
+    for (int p = 1; p < visible; ++p) {
+        int prev = colors[(p - 1) * 6] & 0xFFFFFF, cur = colors[p * 6] & 0xFFFFFF;
+        backToFront = backToFront && depth[prev] >= depth[cur];
+        if (depth[prev] == depth[cur]) stable = stable && prev < cur;
+    }
+    assert_true(backToFront, "Particles are emitted farthest first");
+    assert_true(stable, "Equal depths keep storage order");
+    
+    std::vector<float> corners((size_t)count * 8);
+    std::vector<uint32_t> cornerColors((size_t)count * 4);
+    fill_vertex_buffer_indexed(emitter, identity, corners.data(), cornerColors.data(), count);
+    bool sameOrder = true;
+    for (int p = 0; p < visible; ++p) sameOrder = sameOrder && cornerColors[p * 4] == colors[p * 6];
+    assert_true(sameOrder, "Indexed fill uses the same order");
+    
+    set_job_thread_count(0);
+    destroy_particle_emitter(emitter);
+}
+
+void test_spawn_burst() {
+    std::cout << "\n--- Testing Spawn Burst ---" << std::endl;
+    
+    EmitterShapeDef def;
+    memset(&def, 0, sizeof(def));
+    def.x = 100; def.y = 200;
+    def.radius = 50;
+    def.dirY = 1;
+    def.spreadAngle = 0.5f;
+    def.speedMin = 100; def.speedMax = 200;
+    def.lifeMin = 1; def.lifeMax = 2;
+    def.sizeMin = 1; def.sizeMax = 3;
+    def.color = 0xFFFFFFFFu;
+    def.seed = 42;
+    
+    // Same seed and counter give the same particles for any thread count
+    ParticleEmitter* a = create_particle_emitter(20000, 0);
+    ParticleEmitter* b = create_particle_emitter(20000, 0);
+    def.shape = EMIT_CONE;
+    set_job_thread_count(1);
+    int spawnedA = spawn_burst(a, 20000, &def);
+    def.counter = 0;
+    set_job_thread_count(4);
+    int spawnedB = spawn_burst(b, 25000, &def);
+    assert_true(spawnedA == 20000 && spawnedB == 20000 && b->activeCount == 20000, "Burst is limited by capacity");
+    assert_true(def.counter == 20000, "Burst advances the RNG counter");
+    assert_true(memcmp(a->streams->vx, b->streams->vx, 20000 * sizeof(float)) == 0 &&
+                memcmp(a->streams->vy, b->streams->vy, 20000 * sizeof(float)) == 0, "Burst is independent of the thread count");
+    
+    bool inCone = true;
+    for (int i = 0; i < 20000; ++i) {
+        float vx = a->streams->vx[i], vy = a->streams->vy[i], vz = a->streams->vz[i];
+        float speed = sqrtf(vx * vx + vy * vy + vz * vz);
+        inCone = inCone && speed > 99.9f && speed < 200.1f && vy / speed >= cosf(0.5f) - 1e-4f;
+    }
+    assert_true(inCone, "Cone velocities stay within the spread angle and speed range");
+    
+    // Sphere / ring / box positions
+    const int shapes[3] = {EMIT_SPHERE, EMIT_RING, EMIT_BOX};
+    def.halfX = 10; def.halfY = 20; def.halfZ = 0;
+    bool inside = true;
+    for (int k = 0; k < 3; ++k) {
+        a->activeCount = 0;
+        def.shape = shapes[k];
+        spawn_burst(a, 1000, &def);
+        for (int i = 0; i < 1000; ++i) {
+            float dx = a->streams->x[i] - 100, dy = a->streams->y[i] - 200, dz = a->streams->z[i];
+            float r = sqrtf(dx * dx + dy * dy + dz * dz);
+            if (shapes[k] == EMIT_SPHERE) inside = inside && r <= 50.01f;
+            if (shapes[k] == EMIT_RING) inside = inside && fabsf(r - 50) < 0.01f && dz == 0;
+            if (shapes[k] == EMIT_BOX) inside = inside && fabsf(dx) <= 10 && fabsf(dy) <= 20;
+            inside = inside && a->streams->lifeRate[i] >= 0.5f && a->streams->lifeRate[i] <= 1.0f;
+        }
+    }
+    assert_true(inside, "Sphere, ring and box spawn inside their shapes");
+    
+    set_job_thread_count(0);
+    destroy_particle_emitter(a);
+    destroy_particle_emitter(b);
+}
+
+void test_particle_curves() {
+    std::cout << "\n--- Testing Particle Curves ---" << std::endl;
+    
+    float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    ParticleCurves curves;
+    memset(&curves, 0, sizeof(curves));
+    for (int i = 0; i < PARTICLE_CURVE_SAMPLES; ++i) {
+        curves.size[i] = 2.0f;                   // Constant double size
+        curves.color[i] = 0x80FF8000u;           // Orange, half alpha
+        curves.drag[i] = 0.5f;
+    }
+    
+    ParticleEmitter* soa = create_particle_emitter(8, 0);
+    ParticleEmitter* aos = (ParticleEmitter*)calloc(1, sizeof(ParticleEmitter));
+    aos->particles = (NativeParticle*)calloc(8, sizeof(NativeParticle));
+    aos->maxParticles = 8;
+    for (int k = 0; k < 2; ++k) {
+        ParticleEmitter* e = k ? aos : soa;
+        spawn_particle(e, 0, 0, 0, 10.0f, 0, 0, 2.0f, 0.02f, 0xFF808080u);
+    }
+    
+    std::vector<float> plain(12), curved(12);
+    std::vector<uint32_t> plainColors(6), curvedColors(6);
+    fill_vertex_buffer(soa, identity, plain.data(), plainColors.data(), 1);
+    soa->curves = &curves;
+    curves.flags = CURVE_SIZE | CURVE_COLOR;
+    fill_vertex_buffer(soa, identity, curved.data(), curvedColors.data(), 1);
+    // First vertex sits at (halfSize, 0); at life 1 that is 0.02 * 500 = 10 without the curve
+    assert_true(fabsf(plain[0] - 10.0f) < 1e-3f && fabsf(curved[0] - 20.0f) < 1e-3f, "Size curve replaces the life fade");
+    assert_true(plainColors[0] == 0xFF808080u, "No color curve: particle color with life alpha");
+    assert_true(curvedColors[0] == 0x80804000u, "Color curve tints RGB and sets alpha");
+    
+    // Drag: (v + g dt) * (1 - drag * dt) per step, same on both layouts
+    aos->curves = &curves;
+    curves.flags = CURVE_DRAG;
+    for (int step = 0; step < 10; ++step) {
+        update_particles(soa, 0.1f);
+        update_particles(aos, 0.1f);
+    }
+    float expected = 10.0f * powf(0.95f, 10.0f);
+    assert_true(fabsf(soa->streams->vx[0] - expected) < 1e-3f, "Drag curve damps SoA velocity");
+    assert_true(fabsf(aos->particles[0].vx - soa->streams->vx[0]) < 1e-5f, "AoS and SoA drag match");
+    
+    soa->curves = aos->curves = NULL;
+    destroy_particle_emitter(soa);
+    free(aos->particles);
+    free(aos);
+}
+
+void test_force_fields() {
+    std::cout << "\n--- Testing Force Fields ---" << std::endl;
+    
+    // One field at a time on a fresh emitter; no gravity, so velocity changes are the field's
+    const float dt = 0.01f;
+    ForceField field;
+    ParticleEmitter* emitter = create_particle_emitter(64, 0);
+    emitter->forceFields = &field;
+    emitter->forceFieldCount = 1;
+    
+    memset(&field, 0, sizeof(field));
+    field.type = FORCE_POINT;
+    field.strength = 100.0f;
+    field.radius = 20.0f;
+    spawn_particle(emitter, 10, 0, 0, 0, 0, 0, 10.0f, 1.0f, 0);
+    spawn_particle(emitter, 0, -30, 0, 0, 0, 0, 10.0f, 1.0f, 0);
+    update_particles(emitter, dt);
+    // Half way to the radius: half strength
+    assert_true(fabsf(emitter->streams->vx[0] + 0.5f) < 1e-4f, "Point field attracts with linear falloff");
+    assert_true(emitter->streams->vy[1] == 0.0f, "Point field has no effect beyond its radius");
+    field.strength = -100.0f;
+    field.radius = 0;
+    update_particles(emitter, dt);
+    // Full strength without a radius: -0.5 + 1
+    assert_true(fabsf(emitter->streams->vx[0] - 0.5f) < 1e-4f && emitter->streams->vy[1] < 0.0f, "Negative strength repels");
+    
+    emitter->activeCount = 0;
+    memset(&field, 0, sizeof(field));
+    field.type = FORCE_VORTEX; // Zero axis defaults to +Z
+    field.strength = 100.0f;
+    spawn_particle(emitter, 10, 0, 0, 0, 0, 0, 10.0f, 1.0f, 0);
+    update_particles(emitter, dt);
+    assert_true(fabsf(emitter->streams->vy[0] - 1.0f) < 1e-4f && fabsf(emitter->streams->vx[0]) < 1e-4f, "Vortex pushes tangentially");
+    
+    emitter->activeCount = 0;
+    field.type = FORCE_DRAG;
+    field.strength = 10.0f;
+    spawn_particle(emitter, 0, 0, 0, 50, 0, 0, 10.0f, 1.0f, 0);
+    update_particles(emitter, dt);
+    assert_true(fabsf(emitter->streams->vx[0] - 45.0f) < 1e-3f, "Drag field damps velocity");
+    
+    // Ground plane through y = 0 facing up
+    emitter->activeCount = 0;
+    memset(&field, 0, sizeof(field));
+    field.type = FORCE_PLANE;
+    field.axisY = 2.0f;
+    field.bounce = 0.5f;
+    spawn_particle(emitter, 0, 0.5f, 0, 0, -100, 0, 10.0f, 1.0f, 0);
+    spawn_particle(emitter, 0, 0.5f, 0, 0, 10, 0, 10.0f, 1.0f, 0);
+    update_particles(emitter, dt);
+    assert_true(fabsf(emitter->streams->y[0]) < 1e-4f && fabsf(emitter->streams->vy[0] - 50.0f) < 1e-3f, "Plane stops and bounces particles");
+    assert_true(fabsf(emitter->streams->y[1] - 0.6f) < 1e-5f && emitter->streams->vy[1] == 10.0f, "Plane ignores particles above it");
+    
+    // Turbulence: central differences of the velocity kick around a point sum to ~0
+    emitter->activeCount = 0;
+    memset(&field, 0, sizeof(field));
+    field.type = FORCE_TURBULENCE;
+    field.strength = 100.0f;
+    field.frequency = 0.05f;
+    const float h = 0.01f;
+    const float offsets[6][3] = {{h,0,0}, {-h,0,0}, {0,h,0}, {0,-h,0}, {0,0,h}, {0,0,-h}};
+    for (int k = 0; k < 6; ++k) spawn_particle(emitter, 3.3f + offsets[k][0], 7.1f + offsets[k][1], 1.9f + offsets[k][2], 0, 0, 0, 10.0f, 1.0f, 0);
+    update_particles(emitter, dt);
+    const ParticleStreams* st = emitter->streams;
+    float divergence = (st->vx[0] - st->vx[1] + st->vy[2] - st->vy[3] + st->vz[4] - st->vz[5]) / (2 * h);
+    float gradient = fabsf(st->vx[2] - st->vx[3]) / (2 * h);
+    assert_true(st->vx[0] != 0.0f && gradient > 1e-2f, "Turbulence produces a varying field");
+    assert_true(fabsf(divergence) < 1e-2f * gradient + 1e-3f, "Turbulence is divergence-free");
+    
+    destroy_particle_emitter(emitter);
+}
+
+void test_particle_collision() {
+    std::cout << "\n--- Testing Particle Collision ---" << std::endl;
+    
+    // Floor box with its top at y = 0, a static circle, and a dynamic box that particles ignore
+    PhysicsWorld* world = create_physics_world(16);
+    create_body(world, STATIC, SHAPE_BOX, 0, -10, 2000, 20, 0, 0xFFFF, 0xFFFF);
+    create_body(world, STATIC, SHAPE_CIRCLE, 500, 100, 40, 40, 0, 0xFFFF, 0xFFFF);
+    create_body(world, DYNAMIC, SHAPE_BOX, -500, 100, 40, 40, 0, 0xFFFF, 0xFFFF);
+    
+    ParticleCollision collision;
+    memset(&collision, 0, sizeof(collision));
+    collision.world = world;
+    collision.categoryBits = 0xFFFF;
+    collision.maskBits = 0xFFFF;
+    collision.response = COLLIDE_BOUNCE;
+    collision.bounce = 0.5f;
+    collision.radius = 1.0f;
+    
+    // Rain over the floor: many clusters, some hitting the circle, some the dynamic box
+    const int count = 1000;
+    const float dt = 1.0f / 60.0f;
+    ParticleEmitter* emitter = create_particle_emitter(count, 0);
+    emitter->gravityY = -981.0f;
+    emitter->collision = &collision;
+    for (int i = 0; i < count; ++i) spawn_particle(emitter, -900.0f + i * 1.8f, 150.0f, 0, 0, -200, 0, 10.0f, 1.0f, 0);
+    for (int frame = 0; frame < 40; ++frame) update_particles(emitter, dt);
+    bool aboveFloor = true, outsideCircle = true, bouncedOff = false, underDynamic = false;
+    for (int i = 0; i < emitter->activeCount; ++i) {
+        float x = emitter->streams->x[i], y = emitter->streams->y[i];
+        aboveFloor = aboveFloor && y >= 1.0f - 1e-3f;
+        float dx = x - 500, dy = y - 100;
+        outsideCircle = outsideCircle && dx * dx + dy * dy >= 21.0f * 21.0f - 1e-2f;
+        underDynamic = underDynamic || (fabsf(x + 500) < 15 && y < 80);
+        bouncedOff = bouncedOff || emitter->streams->vy[i] > 0;
+    }
+    assert_true(aboveFloor, "Particles don't pass through the static floor");
+    assert_true(outsideCircle, "Particles don't pass through static circles");
+    assert_true(bouncedOff, "Bounce response reflects the normal velocity");
+    assert_true(underDynamic, "Dynamic bodies are ignored");
+    
+    // Stick: particles come to rest on the floor
+    emitter->activeCount = 0;
+    collision.response = COLLIDE_STICK;
+    spawn_particle(emitter, 100, 5, 0, 30, -300, 0, 10.0f, 1.0f, 0);
+    for (int frame = 0; frame < 5; ++frame) update_particles(emitter, dt);
+    assert_true(fabsf(emitter->streams->y[0] - 1.0f) < 1e-3f && emitter->streams->vx[0] == 0.0f, "Stick response rests on the surface");
+    
+    // Kill: expired particles are removed in the same update
+    emitter->activeCount = 0;
+    collision.response = COLLIDE_KILL;
+    spawn_particle(emitter, 100, 5, 0, 0, -600, 0, 10.0f, 1.0f, 0);
+    spawn_particle(emitter, 100, 500, 0, 0, 0, 0, 10.0f, 1.0f, 0);
+    update_particles(emitter, dt);
+    assert_true(emitter->activeCount == 1 && emitter->streams->y[0] > 400, "Kill response removes particles on contact");
+    
+    // Filtering: a mask that matches no body disables collision
+    emitter->activeCount = 0;
+    collision.maskBits = 0x10000;
+    spawn_particle(emitter, 100, 5, 0, 0, -600, 0, 10.0f, 1.0f, 0);
+    update_particles(emitter, dt);
+    assert_true(emitter->activeCount == 1 && emitter->streams->y[0] < 0, "Collision respects category filtering");
+    
+    destroy_particle_emitter(emitter);
+    destroy_physics_world(world);
+}
+
+void test_fill_multi() {
+    std::cout << "\n--- Testing Multi-Emitter Fill ---" << std::endl;
+    
+    // Mixed shapes, a culled emitter, a sorted one, an empty one and a NULL slot
+    float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    const int emitterCount = 5;
+    ParticleEmitter* emitters[emitterCount];
+    const int shapes[emitterCount] = {0, 3, 1, 4, 0};
+    const int counts[emitterCount] = {20000, 500, 3000, 0, 0};
+    uint32_t seed = 99;
+    for (int e = 0; e < 4; ++e) {
+        emitters[e] = create_particle_emitter(20000, shapes[e]);
+        for (int i = 0; i < counts[e]; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            spawn_particle(emitters[e], (float)(seed % 2000), (float)((seed >> 11) % 1000), (float)((seed >> 21) % 100) / 50.0f - 1.0f,
+                           0, 0, 0, 1.0f, 0.01f, 0xFF000000u | (uint32_t)(e << 20) | (uint32_t)i);
+        }
+    }
+    emitters[4] = NULL;
+    emitters[0]->viewMaxX = 1000; emitters[0]->viewMaxY = 1000;  // Culls about half
+    emitters[2]->sortMode = 1;
+    
+    for (int indexed = 0; indexed < 2; ++indexed) {
+        const int maxVerts = 30 * 24000;
+        std::vector<float> merged(maxVerts * 2), single(maxVerts * 2);
+        std::vector<uint32_t> mergedColors(maxVerts), singleColors(maxVerts);
+        int32_t ranges[emitterCount * 2];
+        set_job_thread_count(4);
+        int total = fill_vertex_buffer_multi(emitters, emitterCount, identity, merged.data(), mergedColors.data(), 1000000, indexed, ranges);
+        
+        bool same = true;
+        int expectedFirst = 0;
+        for (int e = 0; e < emitterCount; ++e) {
+            int visible = 0, verts = 0;
+            if (emitters[e]) {
+                visible = indexed ? fill_vertex_buffer_indexed(emitters[e], identity, single.data(), singleColors.data(), 1000000)
+                                  : fill_vertex_buffer(emitters[e], identity, single.data(), singleColors.data(), 1000000);
+                int sides = particle_shape_sides(shapes[e]);
+                verts = visible * (indexed ? sides : (sides - 2) * 3);
+            }
+            same = same && ranges[e * 2] == expectedFirst && ranges[e * 2 + 1] == visible;
+            same = same && memcmp(&merged[expectedFirst * 2], single.data(), verts * 2 * sizeof(float)) == 0;
+            same = same && memcmp(&mergedColors[expectedFirst], singleColors.data(), verts * sizeof(uint32_t)) == 0;
+            expectedFirst += verts;
+        }
+        assert_true(ranges[1] > 0 && ranges[1] < counts[0], "Per-emitter culling applies in the merged fill");
+        assert_true(same && total == expectedFirst, indexed ? "Indexed merged fill matches per-emitter fills" : "Merged fill matches per-emitter fills");
+    }
+    
+    // The particle budget is shared by all emitters
+    std::vector<float> vertices(6 * 25000 * 2);
+    std::vector<uint32_t> colors(6 * 25000);
+    int32_t ranges[4];
+    ParticleEmitter* pair[2] = {emitters[1], emitters[2]};
+    fill_vertex_buffer_multi(pair, 2, identity, vertices.data(), colors.data(), 1000, 0, ranges);
+    assert_true(ranges[1] == 500 && ranges[3] == 500, "maxRenderCount bounds all emitters together");
+    
+    set_job_thread_count(0);
+    for (int e = 0; e < 4; ++e) destroy_particle_emitter(emitters[e]);
+}
+
+void test_particle_pipeline() {
+    std::cout << "\n--- Testing Particle Pipeline ---" << std::endl;
+    
+    // Same emitters twice: one pair runs on the pipeline, the other synchronously
+    float matrix[16] = {2,0,0,0, 0,2,0,0, 0,0,1,0, 10,20,0,1};
+    const int shapes[2] = {0, 3};
+    ParticleEmitter* async[2];
+    ParticleEmitter* sync[2];
+    for (int e = 0; e < 2; ++e) {
+        async[e] = create_particle_emitter(5000, shapes[e]);
+        sync[e] = create_particle_emitter(5000, shapes[e]);
+        uint32_t seed = 7 + e;
+        for (int i = 0; i < 3000; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            float x = (float)(seed % 500), y = (float)((seed >> 9) % 500), life = 0.05f + (float)((seed >> 18) % 100) / 100.0f;
+            spawn_particle(async[e], x, y, 0, 10, -5, 0, life, 2.0f, 0xFF00FF00u | (uint32_t)i);
+            spawn_particle(sync[e], x, y, 0, 10, -5, 0, life, 2.0f, 0xFF00FF00u | (uint32_t)i);
+        }
+    }
+    
+    set_job_thread_count(4);
+    ParticlePipeline* pipeline = create_particle_pipeline(100000);
+    const ParticleFrame* empty = get_particle_frame(pipeline);
+    assert_true(empty && empty->frameIndex == 0 && empty->vertexCount == 0, "Pipeline starts with an empty frame");
+    
+    std::vector<float> vertices(12 * 10000 * 2);
+    std::vector<uint32_t> colors(12 * 10000);
+    int32_t ranges[4];
+    const ParticleFrame* previous = empty;
+    bool same = true, swapped = true, idle = true;
+    for (int frame = 1; frame <= 3; ++frame) {
+        submit_particle_frame(pipeline, async, 2, async, 2, NULL, 0, 0.1f, matrix);
+        wait_particle_pipeline(pipeline);
+        idle = idle && is_particle_pipeline_busy(pipeline) == 0;
+        
+        for (int e = 0; e < 2; ++e) update_particles(sync[e], 0.1f);
+        int total = fill_vertex_buffer_multi(sync, 2, matrix, vertices.data(), colors.data(), 100000, 1, ranges);
+        
+        const ParticleFrame* f = get_particle_frame(pipeline);
+        swapped = swapped && f != previous && f->frameIndex == (uint32_t)frame;
+        same = same && f->vertexCount == total && f->emitterCount == 2 && memcmp(f->ranges, ranges, sizeof(ranges)) == 0;
+        same = same && memcmp(f->vertices, vertices.data(), total * 2 * sizeof(float)) == 0;
+        same = same && memcmp(f->colors, colors.data(), total * sizeof(uint32_t)) == 0;
+        same = same && memcmp(f->matrix, matrix, sizeof(matrix)) == 0;
+        same = same && async[0]->activeCount == sync[0]->activeCount && async[1]->activeCount == sync[1]->activeCount;
+        previous = f;
+    }
+    assert_true(idle, "Pipeline is idle after wait");
+    assert_true(swapped, "Each frame is published to the other buffer with the next frame index");
+    assert_true(same, "Pipeline frames match synchronous update and fill");
+    assert_true(async[0]->activeCount < 3000, "Pipeline frames advance the simulation");
+    
+    // Hidden emitters keep simulating without being filled; paused ones are filled as they are
+    int hiddenBefore = async[1]->activeCount, pausedBefore = async[0]->activeCount;
+    submit_particle_frame(pipeline, &async[1], 1, &async[0], 1, NULL, 0, 0.1f, matrix);
+    wait_particle_pipeline(pipeline);
+    const ParticleFrame* partial = get_particle_frame(pipeline);
+    assert_true(partial->emitterCount == 1 && partial->vertexCount == partial->ranges[1] * particle_shape_sides(shapes[0]),
+                "Only the draw list is filled");
+    assert_true(async[1]->activeCount < hiddenBefore && async[0]->activeCount == pausedBefore, "Only the update list is updated");
+    
+    // An empty submit publishes an empty frame
+    submit_particle_frame(pipeline, NULL, 0, NULL, 0, NULL, 0, 0.1f, matrix);
+    wait_particle_pipeline(pipeline);
+    assert_true(get_particle_frame(pipeline)->vertexCount == 0 && get_particle_frame(pipeline)->frameIndex == 5, "Empty submit publishes an empty frame");
+
+    // Each draw group is filled in its own layout (paused emitters, so the synchronous fill matches)
+    set_particle_trails(async[1], 4, 0.0f);
+    update_particles(async[1], 0.0f);
+    const int32_t groups[4] = {LAYOUT_SPRITES, 1, LAYOUT_TRAILS, 1};
+    submit_particle_frame(pipeline, NULL, 0, async, 2, groups, 2, 0.1f, matrix);
+    wait_particle_pipeline(pipeline);
+    const ParticleFrame* grouped = get_particle_frame(pipeline);
+    int sprites = fill_vertex_buffer_multi(&async[0], 1, matrix, vertices.data(), colors.data(), 100000, LAYOUT_SPRITES, NULL);
+    bool groupedSame = grouped->groupCount == 2 && grouped->groupStarts[0] == 0 && grouped->groupStarts[1] == sprites * 2;
+    groupedSame = groupedSame && memcmp(grouped->vertices, vertices.data(), sprites * 4 * sizeof(float)) == 0;
+    groupedSame = groupedSame && memcmp(grouped->colors, colors.data(), sprites * sizeof(uint32_t)) == 0;
+    int trailVertices = fill_vertex_buffer_multi(&async[1], 1, matrix, vertices.data(), colors.data(), 100000, LAYOUT_TRAILS, NULL);
+    groupedSame = groupedSame && grouped->vertexCount == sprites * 2 + trailVertices && grouped->ranges[3] * particle_trail_vertices(4) == trailVertices;
+    groupedSame = groupedSame && memcmp(grouped->vertices + sprites * 4, vertices.data(), trailVertices * 2 * sizeof(float)) == 0;
+    groupedSame = groupedSame && memcmp(grouped->colors + sprites * 2, colors.data(), trailVertices * sizeof(uint32_t)) == 0;
+    assert_true(sprites > 0 && trailVertices > 0 && groupedSame, "Sprite and trail groups match their synchronous fills");
+
+    // Textured groups fill the UV stream from their start slot
+    ParticleAtlas atlas = {4, 2, 0, 8, 1.0f, 256.0f, 128.0f};
+    async[0]->atlas = &atlas;
+    const int32_t texturedGroups[4] = {LAYOUT_TRAILS, 1, LAYOUT_TEXTURED, 1};
+    ParticleEmitter* texturedDraws[2] = {async[1], async[0]};
+    submit_particle_frame(pipeline, NULL, 0, texturedDraws, 2, texturedGroups, 2, 0.1f, matrix);
+    wait_particle_pipeline(pipeline);
+    const ParticleFrame* textured = get_particle_frame(pipeline);
+    std::vector<float> uvs(vertices.size());
+    int quadVertices = fill_textured_buffer_multi(&async[0], 1, matrix, vertices.data(), colors.data(), uvs.data(), 100000, NULL);
+    int start = textured->groupStarts[1];
+    bool texturedSame = start == trailVertices && textured->vertexCount == trailVertices + quadVertices;
+    texturedSame = texturedSame && textured->uvs && memcmp(textured->uvs + start * 2, uvs.data(), quadVertices * 2 * sizeof(float)) == 0;
+    texturedSame = texturedSame && memcmp(textured->vertices + start * 2, vertices.data(), quadVertices * 2 * sizeof(float)) == 0;
+    texturedSame = texturedSame && memcmp(textured->colors + start, colors.data(), quadVertices * sizeof(uint32_t)) == 0;
+    assert_true(quadVertices > 0 && texturedSame, "Textured group matches fill_textured_buffer_multi");
+    async[0]->atlas = NULL;
+
+    // Destroying with a frame in flight waits for it
+    submit_particle_frame(pipeline, async, 2, async, 2, NULL, 0, 0.1f, matrix);
+    destroy_particle_pipeline(pipeline);
+    
+    set_job_thread_count(0);
+    for (int e = 0; e < 2; ++e) {
+        destroy_particle_emitter(async[e]);
+        destroy_particle_emitter(sync[e]);
+    }
+}
+
+void test_sprite_fill() {
+    std::cout << "\n--- Testing Sprite Fill ---" << std::endl;
+    
+    float matrix[16] = {1.5f,0,0,0, 0,-1.5f,0,0, 0,0,1,0, 400,300,0,1};
+    ParticleEmitter* emitter = create_particle_emitter(4000, 0);
+    uint32_t seed = 3;
+    for (int i = 0; i < 4000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        spawn_particle(emitter, (float)(seed % 600) - 300.0f, (float)((seed >> 10) % 400) - 200.0f, 0, 0, 0, 0,
+                       1.0f, 0.002f + (float)((seed >> 20) % 10) * 0.001f, 0xFF336699u);
+    }
+    update_particles(emitter, 0.25f);
+    emitter->viewMaxX = 800; emitter->viewMaxY = 400;  // Culls some
+    
+    std::vector<float> corners(4000 * 4 * 2), sprites(4000 * 4);
+    std::vector<uint32_t> cornerColors(4000 * 4), spriteColors(4000);
+    int visible = fill_vertex_buffer_indexed(emitter, matrix, corners.data(), cornerColors.data(), 4000);
+    int spriteCount = fill_sprite_buffer(emitter, matrix, sprites.data(), spriteColors.data(), 4000);
+    assert_true(spriteCount == visible && visible > 0 && visible < 4000, "Sprite fill culls like the polygon fill");
+    
+    // Quad corner 0 is center + (halfSize, 0); the sprite spans center +- halfSize
+    bool same = true;
+    for (int i = 0; i < visible; ++i) {
+        const float* t = &sprites[i * 4];
+        float halfSize = t[0] * PARTICLE_SPRITE_SIZE * 0.5f;
+        float cx = t[2] + halfSize, cy = t[3] + halfSize;
+        same = same && t[1] == 0.0f;
+        same = same && std::fabs(corners[i * 8] - (cx + halfSize)) < 1e-3f && std::fabs(corners[i * 8 + 1] - cy) < 1e-3f;
+        same = same && spriteColors[i] == cornerColors[i * 4];
+    }
+    assert_true(same, "Sprite transforms and colors match the quad corners");
+    
+    // Merged sprite fill: one record per particle, ranges count sprites
+    ParticleEmitter* pair[2] = {emitter, emitter};
+    std::vector<float> merged(8000 * 4);
+    std::vector<uint32_t> mergedColors(8000);
+    int32_t ranges[4];
+    int total = fill_vertex_buffer_multi(pair, 2, matrix, merged.data(), mergedColors.data(), 8000, LAYOUT_SPRITES, ranges);
+    assert_true(total == visible * 2 && ranges[2] == visible && ranges[3] == visible &&
+                memcmp(&merged[visible * 4], sprites.data(), visible * 4 * sizeof(float)) == 0,
+                "Merged sprite fill places each emitter's records back to back");
+    
+    destroy_particle_emitter(emitter);
+}
+
+void test_particle_trails() {
+    std::cout << "\n--- Testing Particle Trails ---" << std::endl;
+    
+    float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    ParticleEmitter* emitter = create_particle_emitter(16, 0);
+    ParticleEmitter* aos = (ParticleEmitter*)calloc(1, sizeof(ParticleEmitter));
+    aos->particles = (NativeParticle*)calloc(16, sizeof(NativeParticle));
+    aos->maxParticles = 16;
+    assert_true(set_particle_trails(aos, 4, 0) == 0 && set_particle_trails(emitter, 1, 0) == 0, "Trails need SoA storage and 2+ points");
+    assert_true(set_particle_trails(emitter, 4, 0) == 1, "Trails are created");
+    emitter->trails->tailAlpha = 0.5f;
+    
+    // A short-lived particle in slot 0 and a long-lived one moving +x at 10/s
+    spawn_particle(emitter, 0, 50, 0, 0, 0, 0, 0.25f, 0.01f, 0xFF0000FFu);
+    spawn_particle(emitter, 0, 0, 0, 10, 0, 0, 10.0f, 0.01f, 0xFFFF0000u);
+    for (int i = 0; i < 6; ++i) update_particles(emitter, 0.1f);
+    assert_true(emitter->activeCount == 1 && emitter->trails->counts[0] == 4, "Trail history moves with compaction and is capped at length");
+    
+    const int verts = particle_trail_vertices(4);
+    std::vector<float> vertices(verts * 2 * 2);
+    std::vector<uint32_t> colors(verts * 2);
+    int visible = fill_trail_buffer(emitter, identity, vertices.data(), colors.data(), 2);
+    assert_true(visible == 1 && verts == 10, "One ribbon of 2 * (length + 1) vertices");
+    
+    // Centerline: live position, then the ring newest first (x = 6, 6, 5, 4, 3)
+    const float expected[5] = {6, 6, 5, 4, 3};
+    bool centerline = true;
+    for (int j = 0; j < 5; ++j) {
+        float cx = (vertices[j * 4] + vertices[j * 4 + 2]) * 0.5f;
+        float cy = (vertices[j * 4 + 1] + vertices[j * 4 + 3]) * 0.5f;
+        centerline = centerline && std::fabs(cx - expected[j]) < 1e-4f && std::fabs(cy) < 1e-4f;
+    }
+    assert_true(centerline, "Ribbon follows the recorded positions");
+    float headWidth = std::fabs(vertices[1] - vertices[3]);
+    float tailWidth = std::fabs(vertices[17] - vertices[19]);
+    assert_true(headWidth > 0 && vertices[0] == vertices[2] && tailWidth < 1e-5f, "Ribbon is perpendicular to the motion and tapers to tailWidth");
+    uint32_t headAlpha = colors[0] >> 24, tailAlpha = colors[8] >> 24;
+    assert_true(colors[0] == colors[1] && tailAlpha == (uint32_t)(headAlpha * 0.5f) && (colors[8] & 0xFFFFFF) == 0xFF0000u,
+                "Alpha tapers to tailAlpha");
+    
+    // A new particle starts with an empty trail: every point collapses onto it
+    spawn_particle(emitter, 100, 100, 0, 0, 0, 0, 10.0f, 0.01f, 0xFFFFFFFFu);
+    assert_true(emitter->trails->counts[1] == 0, "Spawning resets the slot's trail");
+    
+    uint16_t indices[48];
+    assert_true(build_trail_indices(4, 2, indices) == 48 && indices[3] == 1 && indices[4] == 3 && indices[24] == 10,
+                "Trail indices form two triangles per segment");
+    
+    // The trail layout skips emitters without trails
+    ParticleEmitter* plain = create_particle_emitter(16, 0);
+    spawn_particle(plain, 0, 0, 0, 0, 0, 0, 1.0f, 0.01f, 0xFFFFFFFFu);
+    ParticleEmitter* pair[2] = {plain, emitter};
+    int32_t ranges[4];
+    std::vector<float> merged(verts * 2 * 2 * 2);
+    std::vector<uint32_t> mergedColors(verts * 2 * 2);
+    int total = fill_vertex_buffer_multi(pair, 2, identity, merged.data(), mergedColors.data(), 16, LAYOUT_TRAILS, ranges);
+    assert_true(ranges[1] == 0 && ranges[3] == 2 && total == 2 * verts, "Trail fill skips emitters without trails");
+    
+    assert_true(set_particle_trails(emitter, 0, 0) == 1 && emitter->trails == NULL, "Length 0 removes trails");
+    destroy_particle_emitter(plain);
+    destroy_particle_emitter(emitter);
+    free(aos->particles);
+    free(aos);
+}
+
+void test_textured_fill() {
+    std::cout << "\n--- Testing Textured Particle Fill ---" << std::endl;
+    
+    float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+    ParticleEmitter* emitter = create_particle_emitter(16, 0);
+    ParticleAtlas atlas = {4, 2, 0, 8, 1.0f, 256.0f, 128.0f};  // 64 x 64 cells
+    emitter->atlas = &atlas;
+    spawn_particle(emitter, 10, 20, 0, 0, 0, 0, 1.0f, 0.01f, 0xFF00FF00u);
+    update_particles(emitter, 0.3f);
+    
+    float vertices[16], uvs[16];
+    uint32_t colors[8];
+    int visible = fill_textured_buffer(emitter, identity, vertices, colors, uvs, 4);
+    assert_true(visible == 1, "Textured fill draws the particle");
+    assert_true(vertices[0] < vertices[2] && vertices[1] == vertices[3] && vertices[5] > vertices[3] && vertices[6] == vertices[0],
+                "Quad corners run top-left, top-right, bottom-right, bottom-left");
+    float cx = (vertices[0] + vertices[4]) * 0.5f, cy = (vertices[1] + vertices[5]) * 0.5f;
+    assert_true(std::fabs(cx - 10.0f) < 1e-4f && std::fabs(cy - 20.0f) < 1e-4f, "Quad is centered on the particle");
+    assert_true(colors[0] == colors[3] && (colors[0] & 0xFFFFFF) == 0x00FF00u, "Every corner gets the particle color");
+    
+    // Age 0.3 of 8 frames over life: frame 2, cell (2, 0)
+    assert_true(uvs[0] == 128.0f && uvs[1] == 0.0f && uvs[4] == 192.0f && uvs[5] == 64.0f, "UVs cover the cell of the flipbook frame");
+    update_particles(emitter, 0.4f);
+    fill_textured_buffer(emitter, identity, vertices, colors, uvs, 4);
+    assert_true(uvs[0] == 64.0f && uvs[1] == 64.0f, "Frame advances with age (frame 5 = cell (1, 1))");
+    
+    // Starting at cell 6 with 4 frames wraps around the grid: frame 2 -> cell 0
+    atlas.firstFrame = 6;
+    atlas.frameCount = 4;
+    fill_textured_buffer(emitter, identity, vertices, colors, uvs, 4);
+    assert_true(uvs[0] == 0.0f && uvs[1] == 0.0f, "Flipbook wraps to the first cell");
+    
+    // Emitters without an atlas are skipped; the plain multi fill has no UV stream
+    ParticleEmitter* plain = create_particle_emitter(16, 0);
+    spawn_particle(plain, 0, 0, 0, 0, 0, 0, 1.0f, 0.01f, 0xFFFFFFFFu);
+    ParticleEmitter* pair[2] = {plain, emitter};
+    int32_t ranges[4];
+    int total = fill_textured_buffer_multi(pair, 2, identity, vertices, colors, uvs, 4, ranges);
+    assert_true(total == 4 && ranges[1] == 0 && ranges[3] == 1, "Textured fill skips emitters without an atlas");
+    assert_true(fill_vertex_buffer_multi(pair, 2, identity, vertices, colors, 4, LAYOUT_TEXTURED, NULL) == 0,
+                "fill_vertex_buffer_multi leaves the textured layout to fill_textured_buffer_multi");
+    
+    emitter->atlas = NULL;
+    destroy_particle_emitter(plain);
+    destroy_particle_emitter(emitter);
+}
+
 int main() {
     std::cout << "🚀 Running Native Physics Tests..." << std::endl;
     test_gravity();
     test_collision();
+    test_queries();
+    test_shape_cast();
+    test_contact_events();
+    test_snapshot();
+    test_determinism();
+    test_profile();
+    test_job_system();
+#if defined(FLASH_ENABLE_TRACE)
+    test_trace();
+#endif
+    test_async_step();
+    test_world_group();
+    test_particle_streams();
+    test_particle_polygons();
+    test_particle_indices();
+    test_particle_culling();
+    test_particle_depth_sort();
+    test_spawn_burst();
+    test_particle_curves();
+    test_force_fields();
+    test_particle_collision();
+    test_fill_multi();
+    test_particle_pipeline();
+    test_sprite_fill();
+    test_particle_trails();
+    test_textured_fill();
     std::cout << "\n🎉 All Tests Passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,216 @@
+#include "trace.h"
+#include <cstdio>
+
+#if defined(FLASH_ENABLE_TRACE)
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+namespace flash_trace {
+
+std::atomic<int> g_recording(0);
+
+namespace {
+    const int kEventsPerThread = 1 << 16;
+
+    struct TraceEvent {
+        const char* name; // Zone names are string literals
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // Events are written only by the owning thread. count is published with
+    // release so the dumping thread sees complete events. trace_begin resets
+    // count and dropped once no write is in progress (see writing); name is
+    // only accessed under g_registryMutex.
+    struct ThreadBuffer {
+        TraceEvent events[kEventsPerThread];
+        std::atomic<uint32_t> count;
+        std::atomic<uint32_t> session; // Last session this thread recorded in
+        std::atomic<uint32_t> dropped;
+        std::atomic<int> writing;      // Set by record() around its writes
+        int tid;
+        char name[32];
+    };
+
+    std::mutex g_registryMutex;
+    std::vector<ThreadBuffer*> g_buffers;     // Never freed, events outlive their threads
+    std::vector<ThreadBuffer*> g_freeBuffers; // Buffers of exited threads, reused by new ones
+    std::atomic<uint32_t> g_session(0);
+
+    // Returns the buffer to the free list when the thread exits, so short-lived
+    // threads don't allocate a new buffer each time they are spawned
+    struct BufferHandle {
+        ThreadBuffer* buffer;
+        BufferHandle() : buffer(NULL) {}
+        ~BufferHandle() {
+            if (!buffer) return;
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            g_freeBuffers.push_back(buffer);
+        }
+    };
+
+    thread_local BufferHandle t_handle;
+
+    ThreadBuffer* thread_buffer() {
+        if (!t_handle.buffer) {
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            if (!g_freeBuffers.empty()) {
+                // Keeps its events: the new thread continues on the same trace lane
+                t_handle.buffer = g_freeBuffers.back();
+                g_freeBuffers.pop_back();
+            } else {
+                ThreadBuffer* buffer = new ThreadBuffer();
+                buffer->count.store(0);
+                buffer->session.store(g_session.load());
+                buffer->dropped.store(0);
+                buffer->writing.store(0);
+                buffer->tid = (int)g_buffers.size() + 1;
+                snprintf(buffer->name, sizeof(buffer->name), "flash %d", buffer->tid);
+                g_buffers.push_back(buffer);
+                t_handle.buffer = buffer;
+            }
+        }
+        return t_handle.buffer;
+    }
+
+    // Minimal JSON string escaping for zone / thread names
+    void write_json_string(FILE* f, const char* s) {
+        fputc('"', f);
+        for (; *s; ++s) {
+            if (*s == '"' || *s == '\\') fputc('\\', f);
+            if ((unsigned char)*s >= 0x20) fputc(*s, f);
+        }
+        fputc('"', f);
+    }
+}
+
+uint64_t now_ns() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void record(const char* name, uint64_t startNs, uint64_t endNs) {
+    ThreadBuffer* buffer = thread_buffer();
+
+    // Announce the write, then re-check: trace_begin clears g_recording before
+    // it waits for writers and resets the buffers (both sides are seq_cst, so
+    // one of them always sees the other)
+    buffer->writing.store(1);
+    if (!g_recording.load()) {
+        buffer->writing.store(0, std::memory_order_release);
+        return;
+    }
+    buffer->session.store(g_session.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    uint32_t index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= (uint32_t)kEventsPerThread) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        TraceEvent& e = buffer->events[index];
+        e.name = name;
+        e.startNs = startNs;
+        e.endNs = endNs;
+        buffer->count.store(index + 1, std::memory_order_release);
+    }
+    buffer->writing.store(0, std::memory_order_release);
+}
+
+}
+
+extern "C" {
+
+void trace_begin() {
+    using namespace flash_trace;
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+
+    // Stop recording and wait out the writes already past the check, so no
+    // thread touches its buffer while it is reset
+    g_recording.store(0);
+    for (size_t b = 0; b < g_buffers.size(); ++b) {
+        ThreadBuffer* buffer = g_buffers[b];
+        while (buffer->writing.load(std::memory_order_acquire)) std::this_thread::yield();
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+    g_session.fetch_add(1);
+    g_recording.store(1);
+}
+
+void trace_end() {
+    flash_trace::g_recording.store(0);
+}
+
+void trace_set_thread_name(const char* name) {
+    if (!name) return;
+    flash_trace::ThreadBuffer* buffer = flash_trace::thread_buffer();
+    std::lock_guard<std::mutex> lock(flash_trace::g_registryMutex); // trace_dump_json reads it
+    strncpy(buffer->name, name, sizeof(buffer->name) - 1);
+    buffer->name[sizeof(buffer->name) - 1] = '\0';
+}
+
+int trace_dump_json(const char* path) {
+    using namespace flash_trace;
+    if (!path) return -1;
+    FILE* f = fopen(path, "w");
+    if (!f) return -1;
+
+    const int pid = (int)getpid();
+    const uint32_t session = g_session.load();
+    int written = 0;
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"flash_core\"}}", pid);
+
+    for (size_t b = 0; b < g_buffers.size(); ++b) {
+        ThreadBuffer* buffer = g_buffers[b];
+        if (buffer->session.load(std::memory_order_relaxed) != session) continue;
+        uint32_t count = buffer->count.load(std::memory_order_acquire);
+
+        fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":", pid, buffer->tid);
+        write_json_string(f, buffer->name);
+        fprintf(f, "}}");
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const TraceEvent& e = buffer->events[i];
+            // Complete event, microseconds with nanosecond precision
+            fprintf(f, ",\n{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                    pid, buffer->tid, e.startNs / 1000.0, (e.endNs - e.startNs) / 1000.0);
+            write_json_string(f, e.name);
+            fputc('}', f);
+            written++;
+        }
+        uint32_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped) {
+            fprintf(stderr, "WARNING: trace buffer of thread %d full, %u events dropped\n", buffer->tid, dropped);
+        }
+    }
+
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    return written;
+}
+
+}
+
+#else
+
+extern "C" {
+
+void trace_begin() {}
+void trace_end() {}
+void trace_set_thread_name(const char*) {}
+
+int trace_dump_json(const char*) {
+    return -1; // Built without FLASH_ENABLE_TRACE
+}
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef FLASH_TRACE_H
+#define FLASH_TRACE_H
+
+#include <stdint.h>
+
+// Timeline tracing for the native core (Chrome trace / Perfetto JSON).
+//
+// Instrument code with scoped zones:
+//
+//   void update_particles(...) {
+//       FLASH_TRACE_ZONE("update_particles");
+//       ...
+//   }
+//
+// or with a phase that is closed and reopened under a new name:
+//
+//   FLASH_TRACE_PHASE(phase, "broadphase");
+//   ...
+//   FLASH_TRACE_NEXT_PHASE(phase, "narrowphase");
+//
+// All macros compile to nothing unless FLASH_ENABLE_TRACE is defined.
+// Each thread records into its own fixed-size buffer without locks; a buffer is
+// registered (under a mutex) the first time a thread records an event.
+// Timestamps use the monotonic clock, the same time base as the Flutter/Dart
+// timeline on Apple platforms, so both traces can be loaded side by side.
+
+extern "C" {
+
+// Start a recording session (previous events are discarded). Waits for
+// zones being recorded on other threads before their buffers are reset.
+void trace_begin();
+
+// Stop recording. Zones that are still open are dropped.
+void trace_end();
+
+// Name the calling thread in the trace (e.g. "physics", "worker 2")
+void trace_set_thread_name(const char* name);
+
+// Write the recorded events as Chrome trace JSON (call after trace_end).
+// Returns the number of events written, or -1 if the file can't be written or
+// tracing is compiled out.
+int trace_dump_json(const char* path);
+
+}
+
+#if defined(FLASH_ENABLE_TRACE)
+
+#include <atomic>
+
+namespace flash_trace {
+
+extern std::atomic<int> g_recording;
+inline bool recording() { return g_recording.load(std::memory_order_relaxed) != 0; }
+
+uint64_t now_ns();
+void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+struct Zone {
+    const char* name;
+    uint64_t start;
+
+    explicit Zone(const char* zoneName) : name(zoneName), start(recording() ? now_ns() : 0) {}
+    ~Zone() { close(); }
+
+    void close() {
+        if (start && recording()) record(name, start, now_ns());
+        start = 0;
+    }
+
+    void next(const char* zoneName) {
+        close();
+        name = zoneName;
+        start = recording() ? now_ns() : 0;
+    }
+};
+
+}
+
+#define FLASH_TRACE_CONCAT_INNER(a, b) a##b
+#define FLASH_TRACE_CONCAT(a, b) FLASH_TRACE_CONCAT_INNER(a, b)
+#define FLASH_TRACE_ZONE(name) flash_trace::Zone FLASH_TRACE_CONCAT(flashTraceZone, __LINE__)(name)
+#define FLASH_TRACE_PHASE(var, name) flash_trace::Zone var(name)
+#define FLASH_TRACE_NEXT_PHASE(var, name) var.next(name)
+
+#else
+
+#define FLASH_TRACE_ZONE(name) ((void)0)
+#define FLASH_TRACE_PHASE(var, name) ((void)0)
+#define FLASH_TRACE_NEXT_PHASE(var, name) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+#include "world_group.h"
+#include "physics.h"
+#include "jobs.h"
+#include "physics_async.h"
+#include "trace.h"
+#include <cstdlib>
+
+extern "C" {
+
+WorldGroup* create_world_group(int32_t capacity) {
+    if (capacity < 1) capacity = 1;
+    WorldGroup* group = (WorldGroup*)calloc(1, sizeof(WorldGroup));
+    if (!group) return NULL;
+    group->worlds = (PhysicsWorld**)calloc(capacity, sizeof(PhysicsWorld*));
+    group->capacity = capacity;
+    return group;
+}
+
+void destroy_world_group(WorldGroup* group) {
+    if (!group) return;
+    free(group->worlds);
+    free(group);
+}
+
+int32_t world_group_add(WorldGroup* group, PhysicsWorld* world) {
+    if (!group || !world || group->count >= group->capacity) return -1;
+    group->worlds[group->count] = world;
+    return group->count++;
+}
+
+void world_group_remove(WorldGroup* group, PhysicsWorld* world) {
+    if (!group) return;
+    for (int i = 0; i < group->count; ++i) {
+        if (group->worlds[i] == world) {
+            group->worlds[i] = group->worlds[--group->count];
+            group->worlds[group->count] = NULL;
+            return;
+        }
+    }
+}
+
+void step_world_group(WorldGroup* group, float dt, int32_t stepCount) {
+    if (!group || group->count == 0 || dt <= 0) return;
+    FLASH_TRACE_ZONE("step_world_group");
+
+    // A member may still run an asynchronous batch; never step it concurrently
+    for (int i = 0; i < group->count; ++i) wait_physics(group->worlds[i]);
+
+    // One world per task: small worlds run their inner parallel_for inline,
+    // so each world's step stays on one core
+    parallel_for(group->count, 1, [group, dt, stepCount](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            for (int s = 0; s < stepCount; ++s) step_physics(group->worlds[i], dt);
+        }
+    });
+}
+
+}
@@ -0,0 +1,37 @@
+#ifndef FLASH_WORLD_GROUP_H
+#define FLASH_WORLD_GROUP_H
+
+#include <stdint.h>
+
+struct PhysicsWorld;
+
+extern "C" {
+
+// A set of independent worlds stepped together (e.g. server-side match validation).
+// step_world_group spreads the worlds across the job pool (see jobs.h), one world
+// per task. Worlds keep their own scratch memory, so stepping them on different
+// threads doesn't contend on the global heap.
+// The group does not own its worlds: destroy them separately.
+struct WorldGroup {
+    PhysicsWorld** worlds;
+    int32_t count;
+    int32_t capacity;
+};
+
+WorldGroup* create_world_group(int32_t capacity);
+void destroy_world_group(WorldGroup* group);
+
+// Returns the world's index in the group, or -1 if the group is full
+int32_t world_group_add(WorldGroup* group, PhysicsWorld* world);
+// Removes a world (the last world takes its index)
+void world_group_remove(WorldGroup* group, PhysicsWorld* world);
+
+// Runs stepCount fixed steps of dt on every world and returns when all are done.
+// Results are identical to stepping each world on its own. Members may use
+// step_physics_async between group steps: their running batch is waited for
+// (wait_physics) before the group steps them.
+void step_world_group(WorldGroup* group, float dt, int32_t stepCount);
+
+}
+
+#endif